@@ -5,20 +5,40 @@ PLATFORM_DIR = $(MAX22X88_ROOT_DIR)/src/platform
 
 # Protocol stack
 EXAMPLE_STACK_INC = $(EXAMPLE_STACK_DIR)/inc
-EXAMPLE_STACK_SRCS = $(EXAMPLE_STACK_DIR)/src/homebus.c
+EXAMPLE_STACK_SRCS = $(EXAMPLE_STACK_DIR)/src/homebus.c \
+	$(EXAMPLE_STACK_DIR)/src/homebus_transaction.c \
+	$(EXAMPLE_STACK_DIR)/src/homebus_poll.c \
+	$(EXAMPLE_STACK_DIR)/src/homebus_pubsub.c \
+	$(EXAMPLE_STACK_DIR)/src/homebus_cache.c
 
 # Core driver
 MAX22X88_INC = $(MAX22X88_ROOT_DIR)/inc
 MAX22X88_SRCS = $(MAX22X88_ROOT_DIR)/src/bitbang_helper.c \
 	$(MAX22X88_ROOT_DIR)/src/fifo.c \
-	$(MAX22X88_ROOT_DIR)/src/max22x88.c
+	$(MAX22X88_ROOT_DIR)/src/max22x88.c \
+	$(MAX22X88_ROOT_DIR)/src/max22x88_common.c \
+	$(MAX22X88_ROOT_DIR)/src/max22x88_edge_decoder.c \
+	$(MAX22X88_ROOT_DIR)/src/max22x88_capture.c
 
 # Bitbang IO layer driver implementation
 MAX22X88_BITBANG_INC = $(MAX22X88_ROOT_DIR)/inc
 MAX22X88_BITBANG_SRCS = $(MAX22X88_ROOT_DIR)/src/max22x88_bitbang.c \
-	$(MAX22X88_ROOT_DIR)/src/max22x88_common.c \
 	$(MAX22X88_ROOT_DIR)/src/max22x88_bitbang_rx_state_machine.c
 
+# UART IO layer driver implementation
+MAX22X88_UART_INC = $(MAX22X88_ROOT_DIR)/inc
+MAX22X88_UART_SRCS = $(MAX22X88_ROOT_DIR)/src/max22x88_uart.c
+
+# SPI IO layer driver implementation
+MAX22X88_SPI_INC = $(MAX22X88_ROOT_DIR)/inc
+MAX22X88_SPI_SRCS = $(MAX22X88_ROOT_DIR)/src/max22x88_spi.c
+
+# Linux IO layer driver implementation, for transceivers attached through a serial port
+MAX22X88_LINUX_INC = $(PLATFORM_DIR)/linux
+MAX22X88_LINUX_SRCS = $(PLATFORM_DIR)/linux/max22x88_linux.c \
+	$(PLATFORM_DIR)/linux/max22x88_codec.c \
+	$(PLATFORM_DIR)/linux/max22x88_la_decoder.c
+
 # Protocol stack <-> driver integration
 INTEGRATION_MAX22X88_SRCS = $(EXAMPLE_STACK_DIR)/integration/max22x88/homebus_max22x88.c
 INTEGRATION_MAX22X88_INC = $(EXAMPLE_STACK_DIR)/integration/max22x88
@@ -27,6 +47,14 @@ INTEGRATION_MAX22X88_INC = $(EXAMPLE_STACK_DIR)/integration/max22x88
 MAX22X88_HAL_MAX32670_INC = $(PLATFORM_DIR)/hal/max32670
 MAX22X88_HAL_MAX32670_SRCS = $(PLATFORM_DIR)/hal/max32670/hal.c
 
+# Driver HAL implementation for a POSIX host, to run the driver in simulation
+MAX22X88_HAL_HOST_INC = $(PLATFORM_DIR)/hal/host
+MAX22X88_HAL_HOST_SRCS = $(PLATFORM_DIR)/hal/host/common_hal.c \
+	$(PLATFORM_DIR)/hal/host/uart_hal.c \
+	$(PLATFORM_DIR)/hal/host/spi_hal.c \
+	$(PLATFORM_DIR)/hal/host/dma_hal.c \
+	$(PLATFORM_DIR)/hal/host/bitbang_hal.c
+
 # Example project
 EXAMPLE_STACK_MAX22X88_INC =
 EXAMPLE_STACK_MAX22X88_SRCS = $(EXAMPLES_DIR)/two_nodes/main.c
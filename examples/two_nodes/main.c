@@ -20,6 +20,8 @@
 #include "max22x88_bitbang.h"
 #include "homebus.h"
 #include "homebus_max22x88.h"
+#include "homebus_transaction.h"
+#include "bitbang_hal.h"
 
 #include "max32670.h"
 #include "gpio.h"
@@ -42,10 +44,17 @@
 
 #define DEBOUNCE_DELAY_MS 200
 
+#define RESPONSE_TIMEOUT_MS 100
+#define REQUEST_RETRIES 2
+
 #define MAX22X88_RX_FIFO_LEN 256
 
 #define HOMEBUS_BAUD 9600
 
+#define HOMEBUS_IDLE_GAP_BITS 4
+
+#define HOMEBUS_RX_POOL_LEN 4
+
 #define GPIO_IRQn_DOUT MXC_GPIO_GET_IRQ(MXC_GPIO_GET_IDX(MXC_GPIO0))
 
 static void print_info(const char* role)
@@ -64,7 +73,11 @@ static const char * pb_status_to_str(int status)
     return status ? "pressed" : "released";
 }
 
-static bool master_received_response = false;
+static bool master_transaction_done = false;
+
+static adi_hbs_Packet_t rx_pool[HOMEBUS_RX_POOL_LEN];
+// Handlers for the operation codes up to RESPONSE_CODE, the highest one used
+static adi_hbs_OpHandler_t op_handlers[RESPONSE_CODE + 1];
 
 static void print_packet_content(adi_hbs_Packet_t* packet) {
     printf("Src\t%d\nDest\t%d\nOp\t%d\nLen\t%d\n", packet->self_addr, packet->dest_addr, packet->operation, packet->len);
@@ -86,17 +99,23 @@ void GPIO0_IRQHandler(void)
 {
     // This is the only GPIO0 interrupt configured in this example, so checks for which pin triggered the interrupt are skipped.
     MXC_GPIO_ClearFlags(MXC_GPIO0, UINT32_MAX);
+#if MAX22X88_BITBANG_CAPTURE_RX
+    adi_max22x88_EdgeIntCallback(adi_max22x88_hal_TimestampGet(), adi_max22x88_hal_GpioReadDout());
+#else
     adi_max22x88_FallingEdgeIntCallback();
+#endif
 }
 
-hbs_err_e slavecb(adi_hbs_t* hbs, adi_hbs_Packet_t* packet)
+hbs_err_e unexpectedcb(adi_hbs_t* hbs, adi_hbs_Packet_t* packet)
+{
+    print_rx_packet(packet);
+    printf("Unexpected operation code: %d\n", packet->operation);
+    return HBS_ERR_OK;
+}
+
+hbs_err_e slavecb(adi_hbs_t* hbs, adi_hbs_Packet_t* packet, void* ctx)
 {
     print_rx_packet(packet);
-    if (packet->operation != REQUEST_CODE) {
-        printf("Unexpected operation code: %d\n", packet->operation);
-        printf("The expected operation code is: %d\n", REQUEST_CODE);
-        return HBS_ERR_OK;
-    }
     uint8_t src_addr = packet->self_addr;
     uint8_t status = PB_Get(0);
     printf("Received request from device %d\n", src_addr);
@@ -116,29 +135,29 @@ void run_slave(adi_hbs_t* hbs, adi_max22x88_t* driver)
     print_info("slave (red LED)");
     printf("This device reports the status of its push button (pressed/released).\n");
     printf("Waiting for request...\n");
-    adi_hbs_RegisterRxCb(hbs, slavecb);
+    adi_hbs_RegisterOpHandler(hbs, REQUEST_CODE, slavecb, NULL);
+    adi_hbs_RegisterRxCb(hbs, unexpectedcb);
     while (1)
     {
-        if (adi_max22x88_IsAvailable(driver)) {
-            uint8_t data;
-            adi_max22x88_Read(driver, &data);
-            adi_hbs_Received(hbs, data);
-        }
+#if MAX22X88_BITBANG_CAPTURE_RX
+        adi_max22x88_ProcessCaptureBitbang(driver);
+#endif
+        adi_hbs_ReceiveMax22x88(hbs, driver);
+        adi_hbs_Process(hbs);
     }
 }
 
-hbs_err_e mastercb(adi_hbs_t* hbs, adi_hbs_Packet_t* packet)
+void mastercb(adi_hbs_Txn_t* txn, hbs_txn_result_e result, adi_hbs_Packet_t* response, void* ctx)
 {
-    print_rx_packet(packet);
-    if (packet->operation != RESPONSE_CODE) {
-        printf("Unexpected operation code: %d\n", packet->operation);
-        printf("The expected operation code is: %d\n", RESPONSE_CODE);
-        return HBS_ERR_OK;
+    bool* transaction_done = ctx;
+    *transaction_done = true;
+    if (result != HBS_TXN_RESPONSE) {
+        printf("No response from device %d\n", ADDRESS_SLAVE);
+        return;
     }
-    master_received_response = true;
-    uint8_t status = packet->data[0];
+    print_rx_packet(response);
+    uint8_t status = response->data[0];
     printf("Received status: %d - %s\n", status, pb_status_to_str(status));
-    return HBS_ERR_OK;
 }
 
 void run_master(adi_hbs_t* hbs, adi_max22x88_t* driver)
@@ -146,7 +165,20 @@ void run_master(adi_hbs_t* hbs, adi_max22x88_t* driver)
     MXC_GPIO_OutClr(MXC_GPIO0, MXC_GPIO_PIN_23);  // Turn on green LED (P0_23)
     print_info("master (green LED)");
     printf("This device requests the push button status of another device in the network.\n");
-    adi_hbs_RegisterRxCb(hbs, mastercb);
+    adi_hbs_RegisterRxCb(hbs, unexpectedcb);
+
+    adi_hbs_TxnSlot_t txn_slots[1];
+    adi_hbs_Txn_t txn;
+    adi_hbs_TxnInit(&txn, hbs, txn_slots, sizeof txn_slots / sizeof *txn_slots);
+    adi_hbs_TxnRequest_t request = {
+        .dest = ADDRESS_SLAVE,
+        .opcode = REQUEST_CODE,
+        .response_opcode = RESPONSE_CODE,
+        .timeout = adi_max22x88_hal_TimestampFrequency() / 1000 * RESPONSE_TIMEOUT_MS,
+        .retries = REQUEST_RETRIES,
+        .cb = mastercb,
+        .ctx = &master_transaction_done
+    };
 
     while (1) {
         printf("Press push button SW3 to send request...\n");
@@ -155,15 +187,19 @@ void run_master(adi_hbs_t* hbs, adi_max22x88_t* driver)
         printf("Sending request to device %d\n", ADDRESS_SLAVE);
         MXC_Delay(MXC_DELAY_MSEC(DEBOUNCE_DELAY_MS));
 
-        master_received_response = false;
-        adi_hbs_Send(hbs, ADDRESS_SLAVE, REQUEST_CODE, NULL, 0);
+        master_transaction_done = false;
+        if (adi_hbs_TxnSubmit(&txn, &request, adi_max22x88_hal_TimestampGet()) != HBS_ERR_OK) {
+            printf("Failed to send request\n");
+            master_transaction_done = true;
+        }
 
-        while (!master_received_response) {
-            if (adi_max22x88_IsAvailable(driver)) {
-                uint8_t data;
-                adi_max22x88_Read(driver, &data);
-                adi_hbs_Received(hbs, data);
-            }
+        while (!master_transaction_done) {
+#if MAX22X88_BITBANG_CAPTURE_RX
+            adi_max22x88_ProcessCaptureBitbang(driver);
+#endif
+            adi_hbs_ReceiveMax22x88(hbs, driver);
+            adi_hbs_Process(hbs);
+            adi_hbs_TxnPoll(&txn, adi_max22x88_hal_TimestampGet());
         }
         while (PB_Get(0) == 1)
             ;
@@ -211,14 +247,19 @@ int main(void)
     int role = get_role();
 
     adi_max22x88_t driver;
-    adi_max22x88_bitbang_InitParams_t driver_param;
+    adi_max22x88_bitbang_InitParams_t driver_param = { 0 };
     driver_param.hbs_baud = HOMEBUS_BAUD;
+    driver_param.rx_mode = MAX22X88_RX_MODE_FRAMES;
+    driver_param.idle_gap_bits = HOMEBUS_IDLE_GAP_BITS;
     adi_max22x88_InitBitbang(&driver, &driver_param, MAX22X88_RX_FIFO_LEN);
 
     adi_hbs_t hbs;
     uint8_t address = (role == ROLE_MASTER ? ADDRESS_MASTER : ADDRESS_SLAVE);
 
     adi_hbs_InitMax22x88(&hbs, address, &driver);
+    adi_hbs_SetBurstDelimited(&hbs, true);
+    adi_hbs_SetRxPool(&hbs, rx_pool, HOMEBUS_RX_POOL_LEN);
+    adi_hbs_SetOpHandlers(&hbs, op_handlers, sizeof op_handlers / sizeof *op_handlers);
     if (role == ROLE_MASTER) {
         run_master(&hbs, &driver);
     } else {
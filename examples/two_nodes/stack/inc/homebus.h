@@ -24,6 +24,7 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include <stdbool.h>
 
 /** Maximum length of the payload data field. */
 #define HBS_MAX_DATA_LEN (255)
@@ -31,6 +32,37 @@
 /** Lenght of the packet header. */
 #define HBS_HEADER_SIZE (4)
 
+/** Size of the bitmap of accepted destination addresses, one bit per address. */
+#define HBS_ADDR_BITMAP_SIZE (256 / 8)
+
+/** Number of operation codes, the length of a handler table covering all of them. */
+#define HBS_OP_COUNT (256)
+
+/** Maximum number of segments passed to the Tx callback: the header and up to 3 payload segments. */
+#define HBS_TX_MAX_SEGMENTS (4)
+
+/**
+ * Ticks from `tick` to `now`, negative if `tick` is later. The signed distance handles the tick counter wrapping
+ * around, for ticks less than 2^31 apart.
+ */
+#define HBS_TICKS_SINCE(now, tick) ((int32_t)((uint32_t)(now) - (uint32_t)(tick)))
+
+/**
+ * Set to 0 to remove the packet buffer embedded in the protocol stack context. Packets are then only received
+ * through a pool (adi_hbs_SetRxPool) or streamed (adi_hbs_RegisterStreamCb).
+ */
+#ifndef HBS_CONFIG_RX_PACKET_BUFFER
+#define HBS_CONFIG_RX_PACKET_BUFFER (1)
+#endif
+
+/**
+ * Set to 1 to build the monitor mode, which stores every packet on the bus in a ring of records whatever its
+ * destination. See adi_hbs_SetMonitor.
+ */
+#ifndef HBS_CONFIG_MONITOR
+#define HBS_CONFIG_MONITOR (0)
+#endif
+
 /**
  * Protocol stack status codes.
  * 
@@ -39,7 +71,8 @@ typedef enum {
     HBS_ERR_OK, /*!< Success */
     HBS_ERR_BAD_PARAM, /*!< Error: bad parameter */
     HBS_ERR_CB_FAILED, /*!< Error: Rx callback execution failed */
-    HBS_ERR_TX_UNREGISTERED /*!< Error: cannot transmit without configuring Tx callback */
+    HBS_ERR_TX_UNREGISTERED, /*!< Error: cannot transmit without configuring Tx callback */
+    HBS_ERR_NO_RESOURCES /*!< Error: no free slot is available */
 } hbs_err_e;
 
 /**
@@ -51,9 +84,23 @@ typedef enum {
     HBS_RX_STATE_WAIT_FOR_DEST_ADDR,
     HBS_RX_STATE_WAIT_FOR_OP_CODE,
     HBS_RX_STATE_WAIT_FOR_LEN,
-    HBS_RX_STATE_WAIT_FOR_DATA
+    HBS_RX_STATE_WAIT_FOR_DATA,
+    HBS_RX_STATE_STREAM_DATA,
+    HBS_RX_STATE_SKIP_DATA,
+    HBS_RX_STATE_DISCARD
 } hbs_rx_state_machine_e;
 
+/**
+ * Representation of a packet header.
+ * 
+ */
+typedef struct {
+    uint8_t self_addr; /*!< self address */
+    uint8_t dest_addr; /*!< destination address */
+    uint8_t operation; /*!< operation code */
+    uint8_t len; /*!< payload data length*/
+} adi_hbs_Header_t;
+
 /**
  * Representation of a packet.
  * 
@@ -66,6 +113,36 @@ typedef struct {
     uint8_t data[HBS_MAX_DATA_LEN]; /*!< payload data */
 } adi_hbs_Packet_t;
 
+/**
+ * How a monitored packet ended.
+ * 
+ */
+typedef enum {
+    HBS_MONITOR_COMPLETE, /*!< The packet was received in full */
+    HBS_MONITOR_ERROR, /*!< Damaged or lost data was reported with adi_hbs_ReceivedError before the end of the packet */
+    HBS_MONITOR_END_OF_BURST, /*!< The burst ended before the end of the packet, see adi_hbs_EndOfBurst */
+} hbs_monitor_status_e;
+
+/**
+ * A packet stored by the monitor mode.
+ * 
+ */
+typedef struct {
+    uint32_t timestamp; /*!< Value of the monitor clock when the first byte of the packet was received, 0 without a clock */
+    uint16_t received; /*!< Bytes of the packet received, header included. Fields of the header not received are 0. */
+    uint8_t status; /*!< hbs_monitor_status_e */
+    adi_hbs_Packet_t packet; /*!< The packet */
+} adi_hbs_MonitorRecord_t;
+
+/**
+ * A block of data to transmit. A packet is passed to the Tx callback as a header segment followed by the payload segments.
+ * 
+ */
+typedef struct {
+    const uint8_t* data; /*!< data to transmit */
+    size_t len; /*!< length of data */
+} adi_hbs_Segment_t;
+
 /**
  * Typedef for protocol stack context.
  * 
@@ -75,8 +152,34 @@ typedef struct adi_hbs_t adi_hbs_t;
 /** Receiving callback */
 typedef hbs_err_e (*hbs_rx_cb_t)(adi_hbs_t*, adi_hbs_Packet_t*);
 
-/** Tx callback API */
-typedef hbs_err_e (*hbs_tx_cb_t)(uint8_t*, size_t, void*);
+/** Operation handler, receives the context passed to adi_hbs_RegisterOpHandler */
+typedef hbs_err_e (*hbs_op_cb_t)(adi_hbs_t*, adi_hbs_Packet_t*, void*);
+
+/**
+ * Streaming callback. Receives the payload of a packet in chunks, as it is parsed: `data` holds `len` bytes that
+ * start at `offset` in the payload. The packet is complete when `offset + len` equals the header `len`, and packets
+ * without payload are delivered as a single empty chunk. `data` is NULL if the packet is discarded before completion.
+ */
+typedef hbs_err_e (*hbs_stream_cb_t)(adi_hbs_t* hbs, const adi_hbs_Header_t* header, const uint8_t* data, size_t offset, size_t len, void* ctx);
+
+/** Monitor callback, receives a batch of `count` consecutive records */
+typedef hbs_err_e (*hbs_monitor_cb_t)(adi_hbs_t* hbs, const adi_hbs_MonitorRecord_t* records, size_t count, void* ctx);
+
+/** Clock read to timestamp monitored packets */
+typedef uint32_t (*hbs_clock_fn)(void);
+
+/** Tx callback API, receives up to HBS_TX_MAX_SEGMENTS segments to transmit back to back */
+typedef hbs_err_e (*hbs_tx_cb_t)(const adi_hbs_Segment_t*, size_t, void*);
+
+/**
+ * Handler registered for an operation code.
+ * 
+ */
+typedef struct {
+    hbs_op_cb_t cb; /*!< handler, NULL if none is registered */
+    void* ctx; /*!< handler context */
+    unsigned int hit_cnt; /*!< packets received with this operation code */
+} adi_hbs_OpHandler_t;
 
 /**
  * Protocol stack context.
@@ -85,12 +188,43 @@ typedef hbs_err_e (*hbs_tx_cb_t)(uint8_t*, size_t, void*);
 struct adi_hbs_t {
     uint8_t self_addr;
     hbs_rx_cb_t user_cb;
+    adi_hbs_OpHandler_t* op_handlers;
+    size_t op_handler_cnt;
     hbs_tx_cb_t tx_cb;
     void* tx_cb_state;
+    hbs_stream_cb_t stream_cb;
+    void* stream_cb_ctx;
+    adi_hbs_Header_t rx_hdr;
+#if HBS_CONFIG_RX_PACKET_BUFFER
     adi_hbs_Packet_t rx_packet;
+#endif
+    adi_hbs_Packet_t* rx_buf;
+    adi_hbs_Packet_t* rx_pool;
+    size_t rx_pool_len;
+    size_t rx_pool_head;
+    size_t rx_pool_tail;
+    volatile unsigned int rx_pool_completed;
+    volatile unsigned int rx_pool_processed;
     hbs_rx_state_machine_e rx_state;
     uint8_t data_rxed;
+    bool rx_damaged;
+    uint8_t accepted_addrs[HBS_ADDR_BITMAP_SIZE];
+    bool burst_delimited;
     unsigned int unhandled_pkt_cnt;
+    unsigned int dropped_pkt_cnt;
+    unsigned int rx_pool_exhausted_cnt;
+    size_t rx_pool_max_used;
+#if HBS_CONFIG_MONITOR
+    adi_hbs_MonitorRecord_t* monitor_ring;
+    size_t monitor_len;
+    size_t monitor_head;
+    size_t monitor_tail;
+    volatile unsigned int monitor_completed;
+    volatile unsigned int monitor_drained;
+    hbs_clock_fn monitor_clock;
+    uint32_t monitor_timestamp;
+    unsigned int monitor_dropped_cnt;
+#endif
 };
 
 /**
@@ -113,8 +247,148 @@ hbs_err_e adi_hbs_Init(adi_hbs_t* hbs, uint8_t self_addr, hbs_tx_cb_t tx_cb, voi
  */
 hbs_err_e adi_hbs_Received(adi_hbs_t* hbs, uint8_t value);
 
+/**
+ * @brief Notify protocol stack of incoming data, with its time of reception.
+ * In the monitor mode, the timestamp of the first byte of a packet is stored in its record instead of the value of
+ * the monitor clock, so packets are stamped when they arrived rather than when they were parsed. It is otherwise the
+ * same as adi_hbs_Received.
+ * 
+ * @param hbs protocol stack
+ * @param value incoming data
+ * @param timestamp time of reception, such as the timestamp of the driver's frame
+ * @return hbs_err_e 
+ */
+hbs_err_e adi_hbs_ReceivedTimestamped(adi_hbs_t* hbs, uint8_t value, uint32_t timestamp);
+
+/**
+ * @brief Notify protocol stack of a block of incoming data.
+ * Equivalent to calling adi_hbs_Received for each byte, but payload data is copied in a single step.
+ * Processing stops after the packet whose callback failed, so the remaining data can be passed again.
+ * 
+ * @param hbs protocol stack
+ * @param buf incoming data
+ * @param len length of incoming data
+ * @param consumed amount of incoming data processed, may be NULL
+ * @return hbs_err_e 
+ */
+hbs_err_e adi_hbs_ReceivedN(adi_hbs_t* hbs, const uint8_t* buf, size_t len, size_t* consumed);
+
+/**
+ * @brief Notify protocol stack that incoming data was lost or damaged.
+ * Each damaged byte must be reported in place of the byte, as frames with errors are in MAX22X88_RX_MODE_FRAMES.
+ * The packet being received is discarded. Unless the damaged byte is the length byte, the rest of the packet is
+ * skipped and the next packet is received normally. If it is the length byte, the length of the packet is unknown:
+ * the stack then waits for the start of a new packet or, if bursts are delimited, discards any incoming data until
+ * the end of the burst.
+ * 
+ * @param hbs protocol stack
+ * @return hbs_err_e 
+ */
+hbs_err_e adi_hbs_ReceivedError(adi_hbs_t* hbs);
+
+/**
+ * @brief Notify protocol stack that the bus went idle after incoming data.
+ * Any incomplete packet is discarded, so the next incoming data is parsed as the start of a packet.
+ * 
+ * @param hbs protocol stack
+ * @return hbs_err_e 
+ */
+hbs_err_e adi_hbs_EndOfBurst(adi_hbs_t* hbs);
+
+/**
+ * @brief Configure whether the user application reports the end of bursts with adi_hbs_EndOfBurst.
+ * When enabled, data following a damaged length byte is discarded until the end of the burst instead of being
+ * parsed as a new packet. Packets must then be sent without idle gaps between their bytes.
+ * 
+ * @param hbs protocol stack
+ * @param enabled `true` if the end of bursts is reported
+ * @return hbs_err_e 
+ */
+hbs_err_e adi_hbs_SetBurstDelimited(adi_hbs_t* hbs, bool enabled);
+
+/**
+ * @brief Configure whether packets sent to a multicast or broadcast address are received.
+ * Packets sent to the node address are always received. The payload of any other packet is skipped
+ * without being stored.
+ * 
+ * @param hbs protocol stack
+ * @param addr destination address
+ * @param accept `true` to receive packets sent to addr
+ * @return hbs_err_e 
+ */
+hbs_err_e adi_hbs_AcceptAddr(adi_hbs_t* hbs, uint8_t addr, bool accept);
+
+/**
+ * @brief Provide a pool of packet buffers, so received packets are queued instead of being handled immediately.
+ * Parsing continues into a free buffer while queued packets wait for adi_hbs_Process. Packets received while all
+ * the buffers are in use are dropped and counted in `rx_pool_exhausted_cnt`. The highest number of buffers in use
+ * at once is kept in `rx_pool_max_used`.
+ * Without a pool, which is the default, callbacks are called from adi_hbs_Received.
+ * 
+ * @param hbs protocol stack
+ * @param pool packet buffers, NULL to disable the pool
+ * @param len number of packet buffers, 0 to disable the pool
+ * @return hbs_err_e 
+ */
+hbs_err_e adi_hbs_SetRxPool(adi_hbs_t* hbs, adi_hbs_Packet_t* pool, size_t len);
+
+/**
+ * @brief Calls the callbacks for the packets queued in the pool, oldest first.
+ * adi_hbs_Received may run from a different context than adi_hbs_Process, as long as each of them only runs from one.
+ * 
+ * @param hbs protocol stack
+ * @return hbs_err_e the first error returned by a callback, if any
+ */
+hbs_err_e adi_hbs_Process(adi_hbs_t* hbs);
+
+#if HBS_CONFIG_MONITOR
+/**
+ * @brief Enable the monitor mode, turning the node into a bus monitor.
+ * Every packet is stored in a ring of records, whatever its destination address, with its arrival time and whether it
+ * was received in full. Packets cut short by adi_hbs_ReceivedError or adi_hbs_EndOfBurst are stored with the bytes
+ * received. The records are read in batches with adi_hbs_DrainMonitor, which may run from a different context than
+ * adi_hbs_Received. Packets that arrive while the ring is full are dropped and counted in `monitor_dropped_cnt`.
+ * While the monitor mode is enabled, packets are neither passed to the callbacks nor queued in the pool.
+ * 
+ * @param hbs protocol stack
+ * @param ring records, NULL to disable the monitor mode
+ * @param len number of records, 0 to disable the monitor mode
+ * @param clock read when the first byte of a packet is received, may be NULL. Not read for bytes passed with
+ * adi_hbs_ReceivedTimestamped.
+ * @return hbs_err_e 
+ */
+hbs_err_e adi_hbs_SetMonitor(adi_hbs_t* hbs, adi_hbs_MonitorRecord_t* ring, size_t len, hbs_clock_fn clock);
+
+/**
+ * @brief Pass the records stored by the monitor mode to a callback, oldest first, and release them.
+ * The callback receives the records in as few batches as possible: one, or two when the records wrap around the end
+ * of the ring.
+ * 
+ * @param hbs protocol stack
+ * @param cb callback
+ * @param ctx context passed to the callback
+ * @return hbs_err_e the first error returned by the callback, if any
+ */
+hbs_err_e adi_hbs_DrainMonitor(adi_hbs_t* hbs, hbs_monitor_cb_t cb, void* ctx);
+#endif
+
+/**
+ * @brief Provide the table in which operation handlers are registered, and clear it.
+ * Entry n holds the handler of operation code n, so dispatch takes the same time however many handlers are
+ * registered. Operation codes from `len` up have no entry and go to the Rx callback, so a node that only uses low
+ * operation codes can pass a shorter table than HBS_OP_COUNT entries. Without a table, which is the default, every
+ * packet goes to the Rx callback and packets are not counted per operation code.
+ * 
+ * @param hbs protocol stack
+ * @param table handler table, NULL to remove it
+ * @param len number of entries, up to HBS_OP_COUNT, 0 to remove the table
+ * @return hbs_err_e 
+ */
+hbs_err_e adi_hbs_SetOpHandlers(adi_hbs_t* hbs, adi_hbs_OpHandler_t* table, size_t len);
+
 /**
  * @brief Register a callback to handle incoming packets.
+ * It is only called for packets whose operation code has no handler registered with adi_hbs_RegisterOpHandler.
  * 
  * @param hbs protoco stack
  * @param cb callback
@@ -122,6 +396,40 @@ hbs_err_e adi_hbs_Received(adi_hbs_t* hbs, uint8_t value);
  */
 hbs_err_e adi_hbs_RegisterRxCb(adi_hbs_t* hbs, hbs_rx_cb_t cb);
 
+/**
+ * @brief Register a callback to handle incoming packets with a specific operation code.
+ * 
+ * @param hbs protocol stack
+ * @param opcode operation code
+ * @param cb callback, NULL to unregister
+ * @param ctx context passed to the callback
+ * @retval HBS_ERR_NO_RESOURCES the table given to adi_hbs_SetOpHandlers has no entry for the operation code
+ * @return hbs_err_e 
+ */
+hbs_err_e adi_hbs_RegisterOpHandler(adi_hbs_t* hbs, uint8_t opcode, hbs_op_cb_t cb, void* ctx);
+
+/**
+ * @brief Register a callback to receive the payload of incoming packets in chunks, as it is parsed.
+ * Packets are then streamed instead of being stored in a packet buffer, and neither the Rx callback nor the operation
+ * handlers are called.
+ * 
+ * @param hbs protocol stack
+ * @param cb callback, NULL to store packets again
+ * @param ctx context passed to the callback
+ * @return hbs_err_e 
+ */
+hbs_err_e adi_hbs_RegisterStreamCb(adi_hbs_t* hbs, hbs_stream_cb_t cb, void* ctx);
+
+/**
+ * @brief Returns how many packets with a specific operation code have been received, 0 if it has no entry in the
+ * handler table.
+ * 
+ * @param hbs protocol stack
+ * @param opcode operation code
+ * @return unsigned int packet count
+ */
+unsigned int adi_hbs_GetOpHitCount(const adi_hbs_t* hbs, uint8_t opcode);
+
 /**
  * @brief Send a packet.
  * 
@@ -134,4 +442,16 @@ hbs_err_e adi_hbs_RegisterRxCb(adi_hbs_t* hbs, hbs_rx_cb_t cb);
  */
 hbs_err_e adi_hbs_Send(adi_hbs_t* hbs, uint8_t dest, uint8_t opcode, uint8_t *data, size_t len);
 
+/**
+ * @brief Send a packet whose payload is gathered from several segments, without copying them together.
+ * 
+ * @param hbs protocol stack
+ * @param dest destination address
+ * @param opcode operation code
+ * @param payload payload segments, their total length can't exceed HBS_MAX_DATA_LEN
+ * @param count number of payload segments, up to HBS_TX_MAX_SEGMENTS - 1
+ * @return hbs_err_e 
+ */
+hbs_err_e adi_hbs_SendV(adi_hbs_t* hbs, uint8_t dest, uint8_t opcode, const adi_hbs_Segment_t* payload, size_t count);
+
 #endif
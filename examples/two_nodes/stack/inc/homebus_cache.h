@@ -0,0 +1,144 @@
+/* 
+ * Copyright 2024 Analog Devices, Inc.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file homebus_cache.h
+ * Read-through response cache on top of the transaction layer.
+ */
+
+#ifndef HOMEBUS_CACHE_H
+#define HOMEBUS_CACHE_H
+
+#include "homebus_transaction.h"
+
+/** Largest response payload stored in a cache entry. Longer responses are delivered but not cached. */
+#ifndef HBS_CACHE_DATA_LEN
+#define HBS_CACHE_DATA_LEN (16)
+#endif
+
+/** Maximum number of requests waiting for the same in-flight response. */
+#ifndef HBS_CACHE_MAX_WAITERS
+#define HBS_CACHE_MAX_WAITERS (4)
+#endif
+
+/**
+ * Typedef for response cache context.
+ * 
+ */
+typedef struct adi_hbs_Cache_t adi_hbs_Cache_t;
+
+/**
+ * Completion callback of adi_hbs_CacheGet. `data` is only valid during the call, and NULL unless `result` is
+ * HBS_TXN_RESPONSE. The sequence byte, if the rule uses one, is not part of `data`.
+ */
+typedef void (*hbs_cache_cb_t)(adi_hbs_Cache_t* cache, hbs_txn_result_e result, const uint8_t* data, size_t len, void* ctx);
+
+/**
+ * How responses to an operation code are requested and cached.
+ * 
+ */
+typedef struct {
+    uint8_t opcode; /*!< request operation code */
+    uint8_t response_opcode; /*!< operation code of the response */
+    bool use_seq; /*!< match responses with a sequence byte, see adi_hbs_TxnRequest_t */
+    uint32_t ttl; /*!< ticks a response is served from the cache, counted from when it was requested */
+    uint32_t timeout; /*!< ticks to wait for the response to each attempt */
+    uint8_t retries; /*!< attempts after the first one */
+} adi_hbs_CacheRule_t;
+
+/**
+ * Internal use. A request waiting for a response.
+ * 
+ */
+typedef struct {
+    hbs_cache_cb_t cb;
+    void* ctx;
+} adi_hbs_CacheWaiter_t;
+
+/**
+ * Internal use. A cached response, or a request in flight.
+ * 
+ */
+typedef struct {
+    adi_hbs_Cache_t* cache;
+    const adi_hbs_CacheRule_t* rule;
+    uint8_t addr;
+    uint32_t requested;
+    uint8_t data[HBS_CACHE_DATA_LEN];
+    size_t len;
+    adi_hbs_CacheWaiter_t waiters[HBS_CACHE_MAX_WAITERS];
+    size_t waiter_cnt;
+    bool valid;
+    bool in_flight;
+    bool invalidated; /*!< the response in flight was requested before adi_hbs_CacheInvalidate and isn't cached */
+} adi_hbs_CacheEntry_t;
+
+/**
+ * Response cache context.
+ * 
+ */
+struct adi_hbs_Cache_t {
+    adi_hbs_Txn_t* txn;
+    const adi_hbs_CacheRule_t* rules;
+    size_t rule_cnt;
+    adi_hbs_CacheEntry_t* entries;
+    size_t entry_cnt;
+    unsigned int hit_cnt; /*!< requests served from the cache */
+    unsigned int miss_cnt; /*!< requests sent on the bus */
+    unsigned int coalesced_cnt; /*!< requests that joined a request already in flight */
+};
+
+/**
+ * @brief Initialize the response cache.
+ * 
+ * @param cache response cache
+ * @param txn transaction layer used to send the requests, its slots limit the misses in flight
+ * @param rules one rule per cached operation code
+ * @param rule_cnt number of rules
+ * @param entries storage for the cached responses
+ * @param entry_cnt number of entries, the maximum number of (address, operation code) pairs cached
+ * @return hbs_err_e 
+ */
+hbs_err_e adi_hbs_CacheInit(adi_hbs_Cache_t* cache, adi_hbs_Txn_t* txn, const adi_hbs_CacheRule_t* rules, size_t rule_cnt, adi_hbs_CacheEntry_t* entries, size_t entry_cnt);
+
+/**
+ * @brief Get the response of a node to a request without payload.
+ * A response younger than the rule's TTL is passed to the callback before returning. Otherwise the request is sent,
+ * unless the same request is already in flight, in which case the callback waits for its response.
+ * The user application must keep calling adi_hbs_TxnPoll for misses to time out.
+ * 
+ * @param cache response cache
+ * @param addr node address
+ * @param opcode request operation code, must have a rule
+ * @param cb completion callback
+ * @param ctx completion callback context
+ * @param now current tick
+ * @retval HBS_ERR_NO_RESOURCES no entry, waiter or transaction slot is free
+ * @return hbs_err_e 
+ */
+hbs_err_e adi_hbs_CacheGet(adi_hbs_Cache_t* cache, uint8_t addr, uint8_t opcode, hbs_cache_cb_t cb, void* ctx, uint32_t now);
+
+/**
+ * @brief Drop the cached responses of a node, for example after writing to it. The response to a request in flight
+ * is still passed to its callbacks, but isn't cached.
+ * 
+ * @param cache response cache
+ * @param addr node address
+ * @return hbs_err_e 
+ */
+hbs_err_e adi_hbs_CacheInvalidate(adi_hbs_Cache_t* cache, uint8_t addr);
+
+#endif
@@ -0,0 +1,133 @@
+/* 
+ * Copyright 2024 Analog Devices, Inc.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file homebus_poll.h
+ * Periodic polling of nodes on top of the transaction layer.
+ */
+
+#ifndef HOMEBUS_POLL_H
+#define HOMEBUS_POLL_H
+
+#include "homebus_transaction.h"
+
+/** Highest factor the period of a node that keeps timing out is stretched by. */
+#define HBS_POLL_MAX_BACKOFF (8)
+
+/**
+ * Typedef for polling scheduler context.
+ * 
+ */
+typedef struct adi_hbs_Poll_t adi_hbs_Poll_t;
+
+/**
+ * Typedef for poll table entry.
+ * 
+ */
+typedef struct adi_hbs_PollEntry_t adi_hbs_PollEntry_t;
+
+/** Poll completion callback. `response` is NULL if the poll timed out or couldn't be sent. */
+typedef void (*hbs_poll_cb_t)(adi_hbs_Poll_t* poll, adi_hbs_PollEntry_t* entry, adi_hbs_Packet_t* response);
+
+/** Returns true if no frame is being sent or received on the bus, see adi_hbs_PollSetBusIdle. */
+typedef bool (*hbs_poll_idle_fn)(void* ctx);
+
+/**
+ * Poll statistics of a node.
+ * 
+ */
+typedef struct {
+    unsigned int poll_cnt; /*!< polls sent */
+    unsigned int response_cnt; /*!< polls answered */
+    unsigned int timeout_cnt; /*!< polls that timed out or couldn't be sent */
+    uint32_t interval_avg; /*!< average ticks between two polls, the achieved poll rate is its inverse */
+    uint32_t jitter_max; /*!< largest difference, in ticks, between the current period and the time between two polls */
+} adi_hbs_PollStats_t;
+
+/**
+ * Poll table entry. The first fields are set by the user application, the rest are managed by the scheduler.
+ * 
+ */
+struct adi_hbs_PollEntry_t {
+    uint8_t addr; /*!< node address */
+    uint8_t opcode; /*!< request operation code */
+    uint8_t response_opcode; /*!< operation code of the response */
+    uint8_t priority; /*!< among nodes due at the same time, higher priority nodes are polled first */
+    bool use_seq; /*!< match responses with a sequence byte, see adi_hbs_TxnRequest_t */
+    uint32_t period; /*!< ticks between two polls */
+    uint32_t timeout; /*!< ticks to wait for the response */
+    hbs_poll_cb_t cb; /*!< completion callback, can be NULL */
+    void* ctx; /*!< user context */
+
+    adi_hbs_Poll_t* poll;
+    uint32_t cur_period;
+    uint32_t next_due;
+    uint32_t last_poll;
+    bool pending;
+    adi_hbs_PollStats_t stats; /*!< statistics */
+};
+
+/**
+ * Polling scheduler context.
+ * 
+ */
+struct adi_hbs_Poll_t {
+    adi_hbs_Txn_t* txn;
+    adi_hbs_PollEntry_t* entries;
+    size_t entry_cnt;
+    hbs_poll_idle_fn bus_idle;
+    void* bus_idle_ctx;
+};
+
+/**
+ * @brief Initialize the polling scheduler. Every node is due at `now`.
+ * Polls are serialized: a poll is only sent once every transaction is answered or timed out, see
+ * adi_hbs_PollSetBusIdle to pipeline them.
+ * 
+ * @param poll polling scheduler
+ * @param txn transaction layer used to send the polls
+ * @param entries poll table
+ * @param entry_cnt number of entries in the poll table
+ * @param now current tick
+ * @return hbs_err_e 
+ */
+hbs_err_e adi_hbs_PollInit(adi_hbs_Poll_t* poll, adi_hbs_Txn_t* txn, adi_hbs_PollEntry_t* entries, size_t entry_cnt, uint32_t now);
+
+/**
+ * @brief Pipeline the polls. A poll is sent while earlier responses are outstanding if `bus_idle` reports the bus
+ * idle when it's about to be sent, and the number of polls in flight is then limited by the slots of the transaction
+ * layer. Nodes have to wait for an idle bus before they answer, or a response that starts while a request is being
+ * sent collides with it. `bus_idle` is called from adi_hbs_PollRun, between two requests; it can for instance test
+ * that the IO layer isn't sending and has reported the end of the last burst received (MAX22X88_FRAME_END_OF_BURST).
+ * 
+ * @param poll polling scheduler
+ * @param bus_idle bus state, NULL to serialize the polls again
+ * @param ctx `bus_idle` context
+ * @return hbs_err_e 
+ */
+hbs_err_e adi_hbs_PollSetBusIdle(adi_hbs_Poll_t* poll, hbs_poll_idle_fn bus_idle, void* ctx);
+
+/**
+ * @brief Send the polls that are due, as long as the bus is free for them and the transaction layer has free slots.
+ * Calls adi_hbs_TxnPoll first, so the user application only needs to call this function regularly.
+ * 
+ * @param poll polling scheduler
+ * @param now current tick
+ * @return hbs_err_e the first error returned when sending a poll, if any
+ */
+hbs_err_e adi_hbs_PollRun(adi_hbs_Poll_t* poll, uint32_t now);
+
+#endif
@@ -0,0 +1,165 @@
+/* 
+ * Copyright 2024 Analog Devices, Inc.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file homebus_pubsub.h
+ * Change-driven publish/subscribe on top of the protocol stack.
+ */
+
+#ifndef HOMEBUS_PUBSUB_H
+#define HOMEBUS_PUBSUB_H
+
+#include "homebus.h"
+
+/** Size of one published value in an update packet: point id and 32-bit little-endian value. */
+#define HBS_PUBSUB_ENTRY_SIZE (5)
+
+/** Maximum number of values carried by one update packet. */
+#define HBS_PUBSUB_MAX_ENTRIES (HBS_MAX_DATA_LEN / HBS_PUBSUB_ENTRY_SIZE)
+
+/**
+ * A value published by this node. The first fields are set by the user application, the rest are managed by the publisher.
+ * 
+ */
+typedef struct {
+    uint8_t id; /*!< point id, unique for this node */
+    uint32_t deadband; /*!< changes up to this amount don't trigger an update */
+    uint32_t min_interval; /*!< minimum ticks between two updates */
+    uint32_t max_interval; /*!< ticks after which the value is sent even if unchanged, 0 to disable the heartbeat */
+
+    int32_t value;
+    int32_t sent_value;
+    uint32_t sent_time;
+    bool sent;
+} adi_hbs_PubPoint_t;
+
+/**
+ * Publisher context.
+ * 
+ */
+typedef struct {
+    adi_hbs_t* hbs;
+    uint8_t dest;
+    uint8_t opcode;
+    adi_hbs_PubPoint_t* points;
+    size_t point_cnt;
+    unsigned int update_pkt_cnt;
+} adi_hbs_Pub_t;
+
+/**
+ * A value this node subscribes to. The first fields are set by the user application, the rest are managed by the subscriber.
+ * 
+ */
+typedef struct {
+    uint8_t src; /*!< address of the publisher */
+    uint8_t id; /*!< point id */
+    uint32_t max_age; /*!< ticks after which the value is stale, 0 if it never is */
+
+    int32_t value; /*!< last value received */
+    uint32_t updated; /*!< tick of the last update, with the resolution of adi_hbs_SubRun calls */
+    bool valid; /*!< a value has been received */
+} adi_hbs_SubPoint_t;
+
+/**
+ * Typedef for subscriber context.
+ * 
+ */
+typedef struct adi_hbs_Sub_t adi_hbs_Sub_t;
+
+/** Update callback, called when a subscribed value is received. */
+typedef void (*hbs_sub_cb_t)(adi_hbs_Sub_t* sub, adi_hbs_SubPoint_t* point, void* ctx);
+
+/**
+ * Subscriber context.
+ * 
+ */
+struct adi_hbs_Sub_t {
+    adi_hbs_SubPoint_t* points;
+    size_t point_cnt;
+    hbs_sub_cb_t cb;
+    void* ctx;
+    uint32_t now;
+    unsigned int unknown_cnt;
+};
+
+/**
+ * @brief Initialize a publisher. Updates are sent to a single address, which can be a multicast address.
+ * 
+ * @param pub publisher
+ * @param hbs protocol stack
+ * @param dest destination address of the updates
+ * @param opcode operation code of the update packets
+ * @param points published values
+ * @param point_cnt number of published values
+ * @return hbs_err_e 
+ */
+hbs_err_e adi_hbs_PubInit(adi_hbs_Pub_t* pub, adi_hbs_t* hbs, uint8_t dest, uint8_t opcode, adi_hbs_PubPoint_t* points, size_t point_cnt);
+
+/**
+ * @brief Set the current value of a published point. It's sent by the next adi_hbs_PubRun call if the rules allow.
+ * 
+ * @param pub publisher
+ * @param id point id
+ * @param value current value
+ * @return hbs_err_e 
+ */
+hbs_err_e adi_hbs_PubSet(adi_hbs_Pub_t* pub, uint8_t id, int32_t value);
+
+/**
+ * @brief Send the values that changed by more than their deadband, once their minimum interval has passed, and the
+ * values whose heartbeat is due. All of them are packed in as few packets as possible.
+ * 
+ * @param pub publisher
+ * @param now current tick
+ * @return hbs_err_e 
+ */
+hbs_err_e adi_hbs_PubRun(adi_hbs_Pub_t* pub, uint32_t now);
+
+/**
+ * @brief Initialize a subscriber. Update packets with the operation code are handled by the subscriber.
+ * The protocol stack needs a handler table with an entry for the operation code, see adi_hbs_SetOpHandlers.
+ * 
+ * @param sub subscriber
+ * @param hbs protocol stack
+ * @param opcode operation code of the update packets
+ * @param points subscribed values
+ * @param point_cnt number of subscribed values
+ * @param cb update callback, can be NULL
+ * @param ctx update callback context
+ * @return hbs_err_e 
+ */
+hbs_err_e adi_hbs_SubInit(adi_hbs_Sub_t* sub, adi_hbs_t* hbs, uint8_t opcode, adi_hbs_SubPoint_t* points, size_t point_cnt, hbs_sub_cb_t cb, void* ctx);
+
+/**
+ * @brief Update the subscriber's time, used to timestamp the updates received afterwards.
+ * 
+ * @param sub subscriber
+ * @param now current tick
+ * @return hbs_err_e 
+ */
+hbs_err_e adi_hbs_SubRun(adi_hbs_Sub_t* sub, uint32_t now);
+
+/**
+ * @brief Returns whether a subscribed value is missing or older than its `max_age`.
+ * 
+ * @param sub subscriber
+ * @param point subscribed value
+ * @param now current tick
+ * @retval true the value is stale
+ */
+bool adi_hbs_SubIsStale(const adi_hbs_Sub_t* sub, const adi_hbs_SubPoint_t* point, uint32_t now);
+
+#endif
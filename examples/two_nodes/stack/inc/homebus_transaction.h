@@ -0,0 +1,146 @@
+/* 
+ * Copyright 2024 Analog Devices, Inc.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file homebus_transaction.h
+ * Request/response transactions on top of the protocol stack.
+ */
+
+#ifndef HOMEBUS_TRANSACTION_H
+#define HOMEBUS_TRANSACTION_H
+
+#include "homebus.h"
+
+/**
+ * Outcome of a transaction.
+ * 
+ */
+typedef enum {
+    HBS_TXN_RESPONSE, /*!< A matching response was received */
+    HBS_TXN_TIMEOUT, /*!< No response was received after all the retries */
+    HBS_TXN_SEND_FAILED, /*!< The request couldn't be sent */
+    HBS_TXN_CANCELLED /*!< The transaction was cancelled with adi_hbs_TxnCancel */
+} hbs_txn_result_e;
+
+/**
+ * Typedef for transaction layer context.
+ * 
+ */
+typedef struct adi_hbs_Txn_t adi_hbs_Txn_t;
+
+/**
+ * Completion callback. `response` is only valid during the call, and NULL unless `result` is HBS_TXN_RESPONSE.
+ * If the request uses a sequence byte, it's the first byte of the response payload.
+ */
+typedef void (*hbs_txn_cb_t)(adi_hbs_Txn_t* txn, hbs_txn_result_e result, adi_hbs_Packet_t* response, void* ctx);
+
+/**
+ * A request.
+ * 
+ */
+typedef struct {
+    uint8_t dest; /*!< destination address, responses are expected from it */
+    uint8_t opcode; /*!< request operation code */
+    uint8_t response_opcode; /*!< operation code of the response */
+    bool use_seq; /*!< prepend a sequence byte to the payload, which the response must echo as its first byte */
+    const uint8_t* data; /*!< request payload, must stay valid until the transaction completes */
+    size_t len; /*!< request payload length */
+    uint32_t timeout; /*!< ticks to wait for the response to each attempt */
+    uint8_t retries; /*!< attempts after the first one before reporting HBS_TXN_TIMEOUT */
+    hbs_txn_cb_t cb; /*!< completion callback, can be NULL */
+    void* ctx; /*!< completion callback context */
+} adi_hbs_TxnRequest_t;
+
+/**
+ * Internal use. An outstanding transaction.
+ * 
+ */
+typedef struct {
+    adi_hbs_TxnRequest_t req;
+    uint32_t deadline;
+    uint8_t seq;
+    uint8_t retries_left;
+    bool active;
+} adi_hbs_TxnSlot_t;
+
+/**
+ * Transaction layer context.
+ * 
+ */
+struct adi_hbs_Txn_t {
+    adi_hbs_t* hbs;
+    adi_hbs_TxnSlot_t* slots;
+    size_t slot_cnt;
+    uint8_t next_seq;
+    unsigned int retry_cnt;
+    unsigned int timeout_cnt;
+    unsigned int unmatched_cnt;
+};
+
+/**
+ * @brief Initialize the transaction layer.
+ * Ticks are in a unit chosen by the user application and are expected to wrap around at 2^32.
+ * 
+ * @param txn transaction layer
+ * @param hbs protocol stack, packets must be buffered (see adi_hbs_RegisterStreamCb)
+ * @param slots storage for outstanding transactions
+ * @param slot_cnt number of slots, the maximum number of outstanding transactions
+ * @return hbs_err_e 
+ */
+hbs_err_e adi_hbs_TxnInit(adi_hbs_Txn_t* txn, adi_hbs_t* hbs, adi_hbs_TxnSlot_t* slots, size_t slot_cnt);
+
+/**
+ * @brief Send a request and track its response.
+ * The operation handler for the response operation code is registered to the transaction layer, so the protocol
+ * stack needs a handler table with an entry for it, see adi_hbs_SetOpHandlers. Responses that don't match an
+ * outstanding transaction are dropped and counted in `unmatched_cnt`.
+ * 
+ * @param txn transaction layer
+ * @param req request, copied
+ * @param now current tick
+ * @retval HBS_ERR_NO_RESOURCES all the slots are in use, or the handler table has no entry for the response
+ * @return hbs_err_e 
+ */
+hbs_err_e adi_hbs_TxnSubmit(adi_hbs_Txn_t* txn, const adi_hbs_TxnRequest_t* req, uint32_t now);
+
+/**
+ * @brief Retries or completes the transactions whose deadline has passed.
+ * Retries are counted in `retry_cnt` and transactions that ran out of retries in `timeout_cnt`.
+ * 
+ * @param txn transaction layer
+ * @param now current tick
+ * @return hbs_err_e the first error returned when resending a request, if any
+ */
+hbs_err_e adi_hbs_TxnPoll(adi_hbs_Txn_t* txn, uint32_t now);
+
+/**
+ * @brief Cancel the outstanding transactions for a destination. Their callbacks are called with HBS_TXN_CANCELLED.
+ * 
+ * @param txn transaction layer
+ * @param dest destination address
+ * @return hbs_err_e 
+ */
+hbs_err_e adi_hbs_TxnCancel(adi_hbs_Txn_t* txn, uint8_t dest);
+
+/**
+ * @brief Returns the number of outstanding transactions.
+ * 
+ * @param txn transaction layer
+ * @return size_t outstanding transactions
+ */
+size_t adi_hbs_TxnPending(const adi_hbs_Txn_t* txn);
+
+#endif
@@ -16,10 +16,22 @@
 
 #include "homebus_max22x88.h"
 
-hbs_err_e adi_hbs_TxCbMax22x88(uint8_t* data, size_t sz, void* param)
+/** Amount of data read from the driver at once. */
+#define HBS_MAX22X88_RX_CHUNK (32)
+
+hbs_err_e adi_hbs_TxCbMax22x88(const adi_hbs_Segment_t* segments, size_t count, void* param)
 {
+    if (count > HBS_TX_MAX_SEGMENTS) {
+        return HBS_ERR_CB_FAILED;
+    }
+
     adi_max22x88_t* p_driver = param;
-    adi_max22x88_Result_e err = adi_max22x88_Transmit(p_driver, data, sz);
+    adi_max22x88_Segment_t driver_segments[HBS_TX_MAX_SEGMENTS];
+    for (size_t i = 0; i < count; i++) {
+        driver_segments[i].data = segments[i].data;
+        driver_segments[i].len = segments[i].len;
+    }
+    adi_max22x88_Result_e err = adi_max22x88_TransmitV(p_driver, driver_segments, count);
     if (err == MAX22X88_ERR_OK) {
         return HBS_ERR_OK;
     } else {
@@ -31,3 +43,74 @@ hbs_err_e adi_hbs_InitMax22x88(adi_hbs_t* hbs, uint8_t address, adi_max22x88_t*
 {
     return adi_hbs_Init(hbs, address, adi_hbs_TxCbMax22x88, driver);
 }
+
+#if HBS_CONFIG_MONITOR
+// Reads frame by frame, so each packet is stamped with the time its first frame was received
+static hbs_err_e receive_frames_timestamped(adi_hbs_t* hbs, adi_max22x88_t* driver)
+{
+    hbs_err_e ret = HBS_ERR_OK;
+    adi_max22x88_Frame_t frame;
+    while (adi_max22x88_ReadFrame(driver, &frame) == MAX22X88_ERR_OK) {
+        hbs_err_e err;
+        if (frame.status == MAX22X88_FRAME_OK) {
+            err = adi_hbs_ReceivedTimestamped(hbs, frame.data, frame.timestamp);
+        } else if (frame.status == MAX22X88_FRAME_END_OF_BURST) {
+            err = adi_hbs_EndOfBurst(hbs);
+        } else {
+            err = adi_hbs_ReceivedError(hbs);
+        }
+        if (ret == HBS_ERR_OK) {
+            ret = err;
+        }
+    }
+    return ret;
+}
+#endif
+
+hbs_err_e adi_hbs_ReceiveMax22x88(adi_hbs_t* hbs, adi_max22x88_t* driver)
+{
+#if HBS_CONFIG_MONITOR
+    if (hbs->monitor_ring != NULL && driver->rx_mode != MAX22X88_RX_MODE_BYTES) {
+        return receive_frames_timestamped(hbs, driver);
+    }
+#endif
+    hbs_err_e ret = HBS_ERR_OK;
+    uint8_t chunk[HBS_MAX22X88_RX_CHUNK];
+    size_t len;
+    adi_max22x88_Result_e result;
+    while ((result = adi_max22x88_ReadN(driver, chunk, sizeof chunk, &len)) != MAX22X88_ERR_RX_BUFFER_EMPTY) {
+        hbs_err_e err = HBS_ERR_OK;
+        if (result == MAX22X88_ERR_OK) {
+            size_t offset = 0;
+            while (offset < len) {
+                size_t consumed;
+                hbs_err_e chunk_err = adi_hbs_ReceivedN(hbs, &chunk[offset], len - offset, &consumed);
+                if (chunk_err == HBS_ERR_BAD_PARAM) {
+                    return chunk_err;
+                }
+                if (err == HBS_ERR_OK) {
+                    err = chunk_err;
+                }
+                offset += consumed;
+            }
+        } else if (result == MAX22X88_ERR_RX_FRAME) {
+            adi_max22x88_Frame_t frame;
+            if (adi_max22x88_ReadFrame(driver, &frame) != MAX22X88_ERR_OK) {
+                break;
+            }
+            if (frame.status == MAX22X88_FRAME_OK) {
+                err = adi_hbs_Received(hbs, frame.data);
+            } else if (frame.status == MAX22X88_FRAME_END_OF_BURST) {
+                err = adi_hbs_EndOfBurst(hbs);
+            } else {
+                err = adi_hbs_ReceivedError(hbs);
+            }
+        } else {
+            break;
+        }
+        if (ret == HBS_ERR_OK) {
+            ret = err;
+        }
+    }
+    return ret;
+}
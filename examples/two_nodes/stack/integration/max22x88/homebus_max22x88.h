@@ -28,12 +28,12 @@
 /**
  * @brief Max22x88 driver Tx callback for protocol stack.
  * 
- * @param data data to transmit
- * @param sz length of data to transmit
+ * @param segments segments to transmit, passed to the driver without being copied together
+ * @param count number of segments
  * @param param pointer to driver object
  * @return hbs_err_e 
  */
-hbs_err_e adi_hbs_TxCbMax22x88(uint8_t* data, size_t sz, void* param);
+hbs_err_e adi_hbs_TxCbMax22x88(const adi_hbs_Segment_t* segments, size_t count, void* param);
 
 /**
  * @brief Initialize the protocol stack with Max22x88 driver integration.
@@ -45,4 +45,17 @@ hbs_err_e adi_hbs_TxCbMax22x88(uint8_t* data, size_t sz, void* param);
  */
 hbs_err_e adi_hbs_InitMax22x88(adi_hbs_t* hbs, uint8_t address, adi_max22x88_t* driver);
 
+/**
+ * @brief Passes all the data available in the driver's Rx buffer to the protocol stack.
+ * With MAX22X88_RX_MODE_FRAMES, frames with errors discard the packet being received and end of burst
+ * markers are reported with adi_hbs_EndOfBurst.
+ * In the monitor mode, and unless the driver is in MAX22X88_RX_MODE_BYTES, the frames are read one by one and passed
+ * with adi_hbs_ReceivedTimestamped, so each record holds the driver's timestamp of the packet's first frame.
+ * 
+ * @param hbs protocol stack
+ * @param driver driver
+ * @return hbs_err_e the first error returned by the protocol stack, if any
+ */
+hbs_err_e adi_hbs_ReceiveMax22x88(adi_hbs_t* hbs, adi_max22x88_t* driver);
+
 #endif
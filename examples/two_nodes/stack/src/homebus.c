@@ -15,9 +15,24 @@
  */
 
 #include "homebus.h"
+#include <string.h>
+
+// Order the packet copies with the counter updates between adi_hbs_Received and adi_hbs_Process or
+// adi_hbs_DrainMonitor, which may run in different contexts or on different cores. Only the counters are volatile, so
+// the compiler could otherwise move the copies across them.
+#define PUBLISH_FENCE() __atomic_thread_fence(__ATOMIC_RELEASE)
+#define CONSUME_FENCE() __atomic_thread_fence(__ATOMIC_ACQUIRE)
 
 static hbs_err_e hbs_invoke_callback(adi_hbs_t* hbs, adi_hbs_Packet_t* packet)
 {
+    if (packet->operation < hbs->op_handler_cnt) {
+        adi_hbs_OpHandler_t* handler = &hbs->op_handlers[packet->operation];
+        handler->hit_cnt++;
+        if (handler->cb != NULL) {
+            hbs_err_e err = handler->cb(hbs, packet, handler->ctx);
+            return err == HBS_ERR_OK ? HBS_ERR_OK : HBS_ERR_CB_FAILED;
+        }
+    }
     if (hbs->user_cb == NULL) {
         hbs->unhandled_pkt_cnt++;
         return HBS_ERR_OK;
@@ -26,9 +41,119 @@ static hbs_err_e hbs_invoke_callback(adi_hbs_t* hbs, adi_hbs_Packet_t* packet)
     return err == HBS_ERR_OK ? HBS_ERR_OK : HBS_ERR_CB_FAILED;
 }
 
+static bool is_accepted_addr(const adi_hbs_t* hbs, uint8_t addr)
+{
+    return addr == hbs->self_addr || (hbs->accepted_addrs[addr / 8] & (1u << (addr % 8))) != 0;
+}
+
+static bool acquire_rx_buf(adi_hbs_t* hbs)
+{
+    if (hbs->rx_pool == NULL) {
+#if HBS_CONFIG_RX_PACKET_BUFFER
+        hbs->rx_buf = &hbs->rx_packet;
+        hbs->rx_buf->self_addr = hbs->rx_hdr.self_addr;
+        hbs->rx_buf->dest_addr = hbs->rx_hdr.dest_addr;
+        hbs->rx_buf->operation = hbs->rx_hdr.operation;
+        hbs->rx_buf->len = hbs->rx_hdr.len;
+        return true;
+#else
+        hbs->unhandled_pkt_cnt++;
+        return false;
+#endif
+    }
+    if (hbs->rx_pool_completed - hbs->rx_pool_processed >= hbs->rx_pool_len) {
+        hbs->rx_pool_exhausted_cnt++;
+        return false;
+    }
+    // The buffer is only written once adi_hbs_Process is done with it
+    CONSUME_FENCE();
+    hbs->rx_buf = &hbs->rx_pool[hbs->rx_pool_head];
+    hbs->rx_buf->self_addr = hbs->rx_hdr.self_addr;
+    hbs->rx_buf->dest_addr = hbs->rx_hdr.dest_addr;
+    hbs->rx_buf->operation = hbs->rx_hdr.operation;
+    hbs->rx_buf->len = hbs->rx_hdr.len;
+    return true;
+}
+
+#if HBS_CONFIG_MONITOR
+static bool acquire_monitor_record(adi_hbs_t* hbs)
+{
+    if (hbs->monitor_completed - hbs->monitor_drained >= hbs->monitor_len) {
+        hbs->monitor_dropped_cnt++;
+        return false;
+    }
+    // The record is only written once adi_hbs_DrainMonitor is done with it
+    CONSUME_FENCE();
+    // The payload is parsed straight into the record
+    hbs->rx_buf = &hbs->monitor_ring[hbs->monitor_head].packet;
+    hbs->rx_buf->self_addr = hbs->rx_hdr.self_addr;
+    hbs->rx_buf->dest_addr = hbs->rx_hdr.dest_addr;
+    hbs->rx_buf->operation = hbs->rx_hdr.operation;
+    hbs->rx_buf->len = hbs->rx_hdr.len;
+    return true;
+}
+
+static void complete_monitor_record(adi_hbs_t* hbs, hbs_monitor_status_e status, size_t received)
+{
+    adi_hbs_MonitorRecord_t* record = &hbs->monitor_ring[hbs->monitor_head];
+    record->timestamp = hbs->monitor_timestamp;
+    record->received = (uint16_t)received;
+    record->status = (uint8_t)status;
+    hbs->monitor_head = (hbs->monitor_head + 1) % hbs->monitor_len;
+    PUBLISH_FENCE();
+    hbs->monitor_completed++;
+}
+
+// Stores the packet being received as cut short, with the bytes received so far
+static void end_monitor_record(adi_hbs_t* hbs, hbs_monitor_status_e status)
+{
+    size_t received;
+    if (hbs->rx_damaged) {
+        // Stored, if at all, when the damaged byte was received
+        return;
+    }
+    switch (hbs->rx_state) {
+        case HBS_RX_STATE_WAIT_FOR_DEST_ADDR:
+            hbs->rx_hdr.dest_addr = 0;
+            // fallthrough
+        case HBS_RX_STATE_WAIT_FOR_OP_CODE:
+            hbs->rx_hdr.operation = 0;
+            // fallthrough
+        case HBS_RX_STATE_WAIT_FOR_LEN:
+            hbs->rx_hdr.len = 0;
+            received = (size_t)hbs->rx_state - HBS_RX_STATE_WAIT_FOR_SELF_ADDR;
+            if (!acquire_monitor_record(hbs)) {
+                return;
+            }
+            break;
+        case HBS_RX_STATE_WAIT_FOR_DATA:
+            received = HBS_HEADER_SIZE + hbs->data_rxed;
+            break;
+        default:
+            // Nothing received, or the packet is skipped because the ring was full
+            return;
+    }
+    complete_monitor_record(hbs, status, received);
+}
+#endif
+
+static hbs_err_e stream_chunk(adi_hbs_t* hbs, const uint8_t* data, size_t len)
+{
+    hbs_err_e err = hbs->stream_cb(hbs, &hbs->rx_hdr, data, hbs->data_rxed, len, hbs->stream_cb_ctx);
+    return err == HBS_ERR_OK ? HBS_ERR_OK : HBS_ERR_CB_FAILED;
+}
+
+static void abort_stream(adi_hbs_t* hbs)
+{
+    if (hbs->rx_state == HBS_RX_STATE_STREAM_DATA) {
+        hbs->stream_cb(hbs, &hbs->rx_hdr, NULL, hbs->data_rxed, 0, hbs->stream_cb_ctx);
+    }
+}
+
 static void reset_rxing_state(adi_hbs_t* hbs) {
     hbs->rx_state = HBS_RX_STATE_WAIT_FOR_SELF_ADDR;
     hbs->data_rxed = 0;
+    hbs->rx_damaged = false;
 }
 
 hbs_err_e adi_hbs_Init(adi_hbs_t* hbs, uint8_t self_addr, hbs_tx_cb_t tx_cb, void* tx_cb_state)
@@ -37,7 +162,35 @@ hbs_err_e adi_hbs_Init(adi_hbs_t* hbs, uint8_t self_addr, hbs_tx_cb_t tx_cb, voi
         return HBS_ERR_BAD_PARAM;
     }
 
+    hbs->user_cb = NULL;
+    hbs->op_handlers = NULL;
+    hbs->op_handler_cnt = 0;
     hbs->unhandled_pkt_cnt = 0;
+    hbs->dropped_pkt_cnt = 0;
+    hbs->burst_delimited = false;
+    memset(hbs->accepted_addrs, 0, sizeof hbs->accepted_addrs);
+    hbs->stream_cb = NULL;
+    hbs->stream_cb_ctx = NULL;
+    hbs->rx_buf = NULL;
+    hbs->rx_pool = NULL;
+    hbs->rx_pool_len = 0;
+    hbs->rx_pool_head = 0;
+    hbs->rx_pool_tail = 0;
+    hbs->rx_pool_completed = 0;
+    hbs->rx_pool_processed = 0;
+    hbs->rx_pool_exhausted_cnt = 0;
+    hbs->rx_pool_max_used = 0;
+#if HBS_CONFIG_MONITOR
+    hbs->monitor_ring = NULL;
+    hbs->monitor_len = 0;
+    hbs->monitor_head = 0;
+    hbs->monitor_tail = 0;
+    hbs->monitor_completed = 0;
+    hbs->monitor_drained = 0;
+    hbs->monitor_clock = NULL;
+    hbs->monitor_timestamp = 0;
+    hbs->monitor_dropped_cnt = 0;
+#endif
     hbs->tx_cb_state = tx_cb_state;
     hbs->self_addr = self_addr;
     hbs->tx_cb = tx_cb;
@@ -45,54 +198,407 @@ hbs_err_e adi_hbs_Init(adi_hbs_t* hbs, uint8_t self_addr, hbs_tx_cb_t tx_cb, voi
     return HBS_ERR_OK;
 }
 
-static hbs_err_e process_packet(adi_hbs_t* hbs, adi_hbs_Packet_t* packet)
+static hbs_err_e process_packet(adi_hbs_t* hbs)
 {
-    if (packet->dest_addr == hbs->self_addr) {
-        return hbs_invoke_callback(hbs, &hbs->rx_packet);
+#if HBS_CONFIG_MONITOR
+    if (hbs->monitor_ring != NULL) {
+        complete_monitor_record(hbs, HBS_MONITOR_COMPLETE, HBS_HEADER_SIZE + hbs->rx_hdr.len);
+        return HBS_ERR_OK;
+    }
+#endif
+    if (hbs->rx_pool == NULL) {
+        return hbs_invoke_callback(hbs, hbs->rx_buf);
+    }
+
+    // Queue the packet, it's processed by adi_hbs_Process
+    hbs->rx_pool_head = (hbs->rx_pool_head + 1) % hbs->rx_pool_len;
+    PUBLISH_FENCE();
+    hbs->rx_pool_completed++;
+    size_t used = hbs->rx_pool_completed - hbs->rx_pool_processed;
+    if (used > hbs->rx_pool_max_used) {
+        hbs->rx_pool_max_used = used;
     }
     return HBS_ERR_OK;
 }
 
-hbs_err_e adi_hbs_Received(adi_hbs_t* hbs, uint8_t value)
+static hbs_err_e receive_byte(adi_hbs_t* hbs, uint8_t value)
 {
-    if (hbs == NULL) {
-        return HBS_ERR_BAD_PARAM;
-    }
-
     hbs_err_e err = HBS_ERR_OK;
     switch (hbs->rx_state) {
         case HBS_RX_STATE_WAIT_FOR_SELF_ADDR:
-            hbs->rx_packet.self_addr = value;
+#if HBS_CONFIG_MONITOR
+            if (hbs->monitor_ring != NULL) {
+                hbs->monitor_timestamp = hbs->monitor_clock != NULL ? hbs->monitor_clock() : 0;
+            }
+#endif
+            hbs->rx_hdr.self_addr = value;
             hbs->rx_state = HBS_RX_STATE_WAIT_FOR_DEST_ADDR;
             break;
         case HBS_RX_STATE_WAIT_FOR_DEST_ADDR:
-            hbs->rx_packet.dest_addr = value;
+            hbs->rx_hdr.dest_addr = value;
             hbs->rx_state = HBS_RX_STATE_WAIT_FOR_OP_CODE;
             break;
         case HBS_RX_STATE_WAIT_FOR_OP_CODE:
-            hbs->rx_packet.operation = value;
+            hbs->rx_hdr.operation = value;
             hbs->rx_state = HBS_RX_STATE_WAIT_FOR_LEN;
             break;
         case HBS_RX_STATE_WAIT_FOR_LEN:
-            hbs->rx_packet.len = value;
-            if (hbs->rx_packet.len == 0) {
-                err = process_packet(hbs, &hbs->rx_packet);
+            hbs->rx_hdr.len = value;
+            if (hbs->rx_damaged) {
+                // A header byte was damaged, the payload is skipped
+                if (hbs->rx_hdr.len == 0) {
+                    reset_rxing_state(hbs);
+                } else {
+                    hbs->rx_state = HBS_RX_STATE_SKIP_DATA;
+                }
+                break;
+            }
+#if HBS_CONFIG_MONITOR
+            if (hbs->monitor_ring != NULL) {
+                // Every packet is stored, whatever its destination
+                if (!acquire_monitor_record(hbs)) {
+                    hbs->rx_state = HBS_RX_STATE_SKIP_DATA;
+                    if (hbs->rx_hdr.len == 0) {
+                        reset_rxing_state(hbs);
+                    }
+                } else if (hbs->rx_hdr.len == 0) {
+                    err = process_packet(hbs);
+                    reset_rxing_state(hbs);
+                } else {
+                    hbs->rx_state = HBS_RX_STATE_WAIT_FOR_DATA;
+                }
+                break;
+            }
+#endif
+            if (hbs->stream_cb != NULL && is_accepted_addr(hbs, hbs->rx_hdr.dest_addr)) {
+                if (hbs->rx_hdr.operation < hbs->op_handler_cnt) {
+                    hbs->op_handlers[hbs->rx_hdr.operation].hit_cnt++;
+                }
+                if (hbs->rx_hdr.len == 0) {
+                    err = stream_chunk(hbs, &value, 0);
+                    reset_rxing_state(hbs);
+                } else {
+                    hbs->rx_state = HBS_RX_STATE_STREAM_DATA;
+                }
+            } else if (!is_accepted_addr(hbs, hbs->rx_hdr.dest_addr) || !acquire_rx_buf(hbs)) {
+                hbs->rx_state = HBS_RX_STATE_SKIP_DATA;
+                if (hbs->rx_hdr.len == 0) {
+                    reset_rxing_state(hbs);
+                }
+            } else if (hbs->rx_hdr.len == 0) {
+                err = process_packet(hbs);
                 reset_rxing_state(hbs);
             } else {
                 hbs->rx_state = HBS_RX_STATE_WAIT_FOR_DATA;
             }
             break;
         case HBS_RX_STATE_WAIT_FOR_DATA:
-            hbs->rx_packet.data[hbs->data_rxed++] = value;
-            if (hbs->data_rxed == hbs->rx_packet.len) {
-                err = process_packet(hbs, &hbs->rx_packet);
+            hbs->rx_buf->data[hbs->data_rxed++] = value;
+            if (hbs->data_rxed == hbs->rx_hdr.len) {
+                err = process_packet(hbs);
+                reset_rxing_state(hbs);
+            }
+            break;
+        case HBS_RX_STATE_STREAM_DATA:
+            err = stream_chunk(hbs, &value, 1);
+            if (++hbs->data_rxed == hbs->rx_hdr.len) {
+                reset_rxing_state(hbs);
+            } else if (err != HBS_ERR_OK) {
+                hbs->rx_state = HBS_RX_STATE_SKIP_DATA;
+            }
+            break;
+        case HBS_RX_STATE_SKIP_DATA:
+            if (++hbs->data_rxed == hbs->rx_hdr.len) {
                 reset_rxing_state(hbs);
             }
             break;
+        case HBS_RX_STATE_DISCARD:
+            break;
     }
     return err;
 }
 
+hbs_err_e adi_hbs_Received(adi_hbs_t* hbs, uint8_t value)
+{
+    if (hbs == NULL) {
+        return HBS_ERR_BAD_PARAM;
+    }
+
+    return receive_byte(hbs, value);
+}
+
+hbs_err_e adi_hbs_ReceivedTimestamped(adi_hbs_t* hbs, uint8_t value, uint32_t timestamp)
+{
+    if (hbs == NULL) {
+        return HBS_ERR_BAD_PARAM;
+    }
+
+#if HBS_CONFIG_MONITOR
+    if (hbs->monitor_ring != NULL && hbs->rx_state == HBS_RX_STATE_WAIT_FOR_SELF_ADDR) {
+        // The first byte of a packet, stamped with its time of reception instead of the monitor clock
+        hbs->monitor_timestamp = timestamp;
+        hbs->rx_hdr.self_addr = value;
+        hbs->rx_state = HBS_RX_STATE_WAIT_FOR_DEST_ADDR;
+        return HBS_ERR_OK;
+    }
+#else
+    (void)timestamp;
+#endif
+    return receive_byte(hbs, value);
+}
+
+hbs_err_e adi_hbs_ReceivedN(adi_hbs_t* hbs, const uint8_t* buf, size_t len, size_t* consumed)
+{
+    if (hbs == NULL || (buf == NULL && len != 0)) {
+        return HBS_ERR_BAD_PARAM;
+    }
+
+    hbs_err_e err = HBS_ERR_OK;
+    size_t i = 0;
+    while (i < len && err == HBS_ERR_OK) {
+        if (hbs->rx_state == HBS_RX_STATE_WAIT_FOR_DATA) {
+            // Copy the payload run available in buf at once
+            size_t run = hbs->rx_hdr.len - hbs->data_rxed;
+            if (run > len - i) {
+                run = len - i;
+            }
+            memcpy(&hbs->rx_buf->data[hbs->data_rxed], &buf[i], run);
+            hbs->data_rxed += run;
+            i += run;
+            if (hbs->data_rxed == hbs->rx_hdr.len) {
+                err = process_packet(hbs);
+                reset_rxing_state(hbs);
+            }
+        } else if (hbs->rx_state == HBS_RX_STATE_STREAM_DATA) {
+            // Deliver the payload run available in buf at once
+            size_t run = hbs->rx_hdr.len - hbs->data_rxed;
+            if (run > len - i) {
+                run = len - i;
+            }
+            err = stream_chunk(hbs, &buf[i], run);
+            hbs->data_rxed += run;
+            i += run;
+            if (hbs->data_rxed == hbs->rx_hdr.len) {
+                reset_rxing_state(hbs);
+            } else if (err != HBS_ERR_OK) {
+                hbs->rx_state = HBS_RX_STATE_SKIP_DATA;
+            }
+        } else if (hbs->rx_state == HBS_RX_STATE_SKIP_DATA) {
+            size_t run = hbs->rx_hdr.len - hbs->data_rxed;
+            if (run > len - i) {
+                run = len - i;
+            }
+            hbs->data_rxed += run;
+            i += run;
+            if (hbs->data_rxed == hbs->rx_hdr.len) {
+                reset_rxing_state(hbs);
+            }
+        } else if (hbs->rx_state == HBS_RX_STATE_DISCARD) {
+            i = len;
+        } else {
+            err = receive_byte(hbs, buf[i++]);
+        }
+    }
+
+    if (consumed != NULL) {
+        *consumed = i;
+    }
+    return err;
+}
+
+hbs_err_e adi_hbs_ReceivedError(adi_hbs_t* hbs)
+{
+    if (hbs == NULL) {
+        return HBS_ERR_BAD_PARAM;
+    }
+
+    if (hbs->rx_state != HBS_RX_STATE_DISCARD && hbs->rx_state != HBS_RX_STATE_SKIP_DATA && !hbs->rx_damaged) {
+        hbs->dropped_pkt_cnt++;
+    }
+#if HBS_CONFIG_MONITOR
+    if (hbs->monitor_ring != NULL) {
+        end_monitor_record(hbs, HBS_MONITOR_ERROR);
+    }
+#endif
+    abort_stream(hbs);
+    // The damaged byte takes its slot, so unless it is the length byte, the packet is skipped to its end and the next
+    // packet is received normally
+    switch (hbs->rx_state) {
+        case HBS_RX_STATE_WAIT_FOR_SELF_ADDR:
+            hbs->rx_state = HBS_RX_STATE_WAIT_FOR_DEST_ADDR;
+            hbs->rx_damaged = true;
+            break;
+        case HBS_RX_STATE_WAIT_FOR_DEST_ADDR:
+            hbs->rx_state = HBS_RX_STATE_WAIT_FOR_OP_CODE;
+            hbs->rx_damaged = true;
+            break;
+        case HBS_RX_STATE_WAIT_FOR_OP_CODE:
+            hbs->rx_state = HBS_RX_STATE_WAIT_FOR_LEN;
+            hbs->rx_damaged = true;
+            break;
+        case HBS_RX_STATE_WAIT_FOR_DATA:
+        case HBS_RX_STATE_STREAM_DATA:
+        case HBS_RX_STATE_SKIP_DATA:
+            if (++hbs->data_rxed == hbs->rx_hdr.len) {
+                reset_rxing_state(hbs);
+            } else {
+                hbs->rx_state = HBS_RX_STATE_SKIP_DATA;
+                hbs->rx_damaged = true;
+            }
+            break;
+        default:
+            // The length is lost, wait for the start of a new packet
+            reset_rxing_state(hbs);
+            if (hbs->burst_delimited) {
+                hbs->rx_state = HBS_RX_STATE_DISCARD;
+            }
+            break;
+    }
+    return HBS_ERR_OK;
+}
+
+hbs_err_e adi_hbs_EndOfBurst(adi_hbs_t* hbs)
+{
+    if (hbs == NULL) {
+        return HBS_ERR_BAD_PARAM;
+    }
+
+    if (hbs->rx_state != HBS_RX_STATE_WAIT_FOR_SELF_ADDR && hbs->rx_state != HBS_RX_STATE_DISCARD &&
+        !hbs->rx_damaged) {
+        hbs->dropped_pkt_cnt++;
+    }
+#if HBS_CONFIG_MONITOR
+    if (hbs->monitor_ring != NULL) {
+        end_monitor_record(hbs, HBS_MONITOR_END_OF_BURST);
+    }
+#endif
+    abort_stream(hbs);
+    reset_rxing_state(hbs);
+    return HBS_ERR_OK;
+}
+
+hbs_err_e adi_hbs_SetBurstDelimited(adi_hbs_t* hbs, bool enabled)
+{
+    if (hbs == NULL) {
+        return HBS_ERR_BAD_PARAM;
+    }
+
+    hbs->burst_delimited = enabled;
+    return HBS_ERR_OK;
+}
+
+hbs_err_e adi_hbs_AcceptAddr(adi_hbs_t* hbs, uint8_t addr, bool accept)
+{
+    if (hbs == NULL) {
+        return HBS_ERR_BAD_PARAM;
+    }
+
+    if (accept) {
+        hbs->accepted_addrs[addr / 8] |= (uint8_t)(1u << (addr % 8));
+    } else {
+        hbs->accepted_addrs[addr / 8] &= (uint8_t)~(1u << (addr % 8));
+    }
+    return HBS_ERR_OK;
+}
+
+hbs_err_e adi_hbs_SetRxPool(adi_hbs_t* hbs, adi_hbs_Packet_t* pool, size_t len)
+{
+    if (hbs == NULL || (pool == NULL) != (len == 0)) {
+        return HBS_ERR_BAD_PARAM;
+    }
+
+    hbs->rx_pool = pool;
+    hbs->rx_pool_len = len;
+    hbs->rx_pool_head = 0;
+    hbs->rx_pool_tail = 0;
+    hbs->rx_pool_completed = 0;
+    hbs->rx_pool_processed = 0;
+    hbs->rx_buf = NULL;
+    reset_rxing_state(hbs);
+    return HBS_ERR_OK;
+}
+
+hbs_err_e adi_hbs_Process(adi_hbs_t* hbs)
+{
+    if (hbs == NULL) {
+        return HBS_ERR_BAD_PARAM;
+    }
+
+    hbs_err_e ret = HBS_ERR_OK;
+    while (hbs->rx_pool_processed != hbs->rx_pool_completed) {
+        CONSUME_FENCE();
+        hbs_err_e err = hbs_invoke_callback(hbs, &hbs->rx_pool[hbs->rx_pool_tail]);
+        // The buffer is released only once the callback returns
+        hbs->rx_pool_tail = (hbs->rx_pool_tail + 1) % hbs->rx_pool_len;
+        PUBLISH_FENCE();
+        hbs->rx_pool_processed++;
+        if (ret == HBS_ERR_OK) {
+            ret = err;
+        }
+    }
+    return ret;
+}
+
+#if HBS_CONFIG_MONITOR
+hbs_err_e adi_hbs_SetMonitor(adi_hbs_t* hbs, adi_hbs_MonitorRecord_t* ring, size_t len, hbs_clock_fn clock)
+{
+    if (hbs == NULL || (ring == NULL) != (len == 0)) {
+        return HBS_ERR_BAD_PARAM;
+    }
+
+    abort_stream(hbs);
+    hbs->monitor_ring = ring;
+    hbs->monitor_len = len;
+    hbs->monitor_head = 0;
+    hbs->monitor_tail = 0;
+    hbs->monitor_completed = 0;
+    hbs->monitor_drained = 0;
+    hbs->monitor_clock = clock;
+    reset_rxing_state(hbs);
+    return HBS_ERR_OK;
+}
+
+hbs_err_e adi_hbs_DrainMonitor(adi_hbs_t* hbs, hbs_monitor_cb_t cb, void* ctx)
+{
+    if (hbs == NULL || cb == NULL) {
+        return HBS_ERR_BAD_PARAM;
+    }
+
+    hbs_err_e ret = HBS_ERR_OK;
+    unsigned int completed = hbs->monitor_completed;
+    CONSUME_FENCE();
+    while (hbs->monitor_drained != completed) {
+        size_t count = completed - hbs->monitor_drained;
+        if (count > hbs->monitor_len - hbs->monitor_tail) {
+            count = hbs->monitor_len - hbs->monitor_tail;
+        }
+        hbs_err_e err = cb(hbs, &hbs->monitor_ring[hbs->monitor_tail], count, ctx);
+        // The records are released only once the callback returns
+        hbs->monitor_tail = (hbs->monitor_tail + count) % hbs->monitor_len;
+        PUBLISH_FENCE();
+        hbs->monitor_drained += (unsigned int)count;
+        if (ret == HBS_ERR_OK && err != HBS_ERR_OK) {
+            ret = HBS_ERR_CB_FAILED;
+        }
+    }
+    return ret;
+}
+#endif
+
+hbs_err_e adi_hbs_SetOpHandlers(adi_hbs_t* hbs, adi_hbs_OpHandler_t* table, size_t len)
+{
+    if (hbs == NULL || (table == NULL) != (len == 0) || len > HBS_OP_COUNT) {
+        return HBS_ERR_BAD_PARAM;
+    }
+
+    if (table != NULL) {
+        memset(table, 0, len * sizeof *table);
+    }
+    hbs->op_handlers = table;
+    hbs->op_handler_cnt = len;
+    return HBS_ERR_OK;
+}
+
 hbs_err_e adi_hbs_RegisterRxCb(adi_hbs_t* hbs, hbs_rx_cb_t cb)
 {
     if (hbs == NULL || cb == NULL) {
@@ -103,6 +609,42 @@ hbs_err_e adi_hbs_RegisterRxCb(adi_hbs_t* hbs, hbs_rx_cb_t cb)
     return HBS_ERR_OK;
 }
 
+hbs_err_e adi_hbs_RegisterOpHandler(adi_hbs_t* hbs, uint8_t opcode, hbs_op_cb_t cb, void* ctx)
+{
+    if (hbs == NULL) {
+        return HBS_ERR_BAD_PARAM;
+    }
+    if (opcode >= hbs->op_handler_cnt) {
+        return HBS_ERR_NO_RESOURCES;
+    }
+
+    hbs->op_handlers[opcode].cb = cb;
+    hbs->op_handlers[opcode].ctx = ctx;
+    return HBS_ERR_OK;
+}
+
+hbs_err_e adi_hbs_RegisterStreamCb(adi_hbs_t* hbs, hbs_stream_cb_t cb, void* ctx)
+{
+    if (hbs == NULL) {
+        return HBS_ERR_BAD_PARAM;
+    }
+
+    abort_stream(hbs);
+    hbs->stream_cb = cb;
+    hbs->stream_cb_ctx = ctx;
+    reset_rxing_state(hbs);
+    return HBS_ERR_OK;
+}
+
+unsigned int adi_hbs_GetOpHitCount(const adi_hbs_t* hbs, uint8_t opcode)
+{
+    if (hbs == NULL || opcode >= hbs->op_handler_cnt) {
+        return 0;
+    }
+
+    return hbs->op_handlers[opcode].hit_cnt;
+}
+
 hbs_err_e adi_hbs_Send(adi_hbs_t* hbs, uint8_t dest, uint8_t opcode, uint8_t *data, size_t len)
 {
     if (hbs == NULL) {
@@ -115,14 +657,39 @@ hbs_err_e adi_hbs_Send(adi_hbs_t* hbs, uint8_t dest, uint8_t opcode, uint8_t *da
         return HBS_ERR_TX_UNREGISTERED;
     }
 
-    const uint8_t header_size = 4;
-    uint8_t raw_data[len + header_size];
-    raw_data[0] = hbs->self_addr;
-    raw_data[1] = dest;
-    raw_data[2] = opcode;
-    raw_data[3] = len;
-    for (size_t i = 0; i < len; i++) {
-        raw_data[header_size + i] = data[i];
+    adi_hbs_Segment_t payload = {
+        .data = data,
+        .len = len
+    };
+    return adi_hbs_SendV(hbs, dest, opcode, &payload, len == 0 ? 0 : 1);
+}
+
+hbs_err_e adi_hbs_SendV(adi_hbs_t* hbs, uint8_t dest, uint8_t opcode, const adi_hbs_Segment_t* payload, size_t count)
+{
+    if (hbs == NULL || count > HBS_TX_MAX_SEGMENTS - 1 || (count != 0 && payload == NULL)) {
+        return HBS_ERR_BAD_PARAM;
+    }
+    if (hbs->tx_cb == NULL) {
+        return HBS_ERR_TX_UNREGISTERED;
+    }
+
+    size_t len = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (payload[i].len != 0 && payload[i].data == NULL) {
+            return HBS_ERR_BAD_PARAM;
+        }
+        len += payload[i].len;
+    }
+    if (len > HBS_MAX_DATA_LEN) {
+        return HBS_ERR_BAD_PARAM;
+    }
+
+    uint8_t header[HBS_HEADER_SIZE] = { hbs->self_addr, dest, opcode, (uint8_t)len };
+    adi_hbs_Segment_t segments[HBS_TX_MAX_SEGMENTS];
+    segments[0].data = header;
+    segments[0].len = sizeof header;
+    for (size_t i = 0; i < count; i++) {
+        segments[i + 1] = payload[i];
     }
-    return hbs->tx_cb(raw_data, sizeof raw_data / sizeof *raw_data, hbs->tx_cb_state);
+    return hbs->tx_cb(segments, count + 1, hbs->tx_cb_state);
 }
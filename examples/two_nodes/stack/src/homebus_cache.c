@@ -0,0 +1,188 @@
+/* 
+ * Copyright 2024 Analog Devices, Inc.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+
+#include "homebus_cache.h"
+
+static const adi_hbs_CacheRule_t* find_rule(const adi_hbs_Cache_t* cache, uint8_t opcode)
+{
+    for (size_t i = 0; i < cache->rule_cnt; i++) {
+        if (cache->rules[i].opcode == opcode) {
+            return &cache->rules[i];
+        }
+    }
+    return NULL;
+}
+
+static adi_hbs_CacheEntry_t* find_entry(adi_hbs_Cache_t* cache, uint8_t addr, const adi_hbs_CacheRule_t* rule)
+{
+    for (size_t i = 0; i < cache->entry_cnt; i++) {
+        adi_hbs_CacheEntry_t* entry = &cache->entries[i];
+        if ((entry->valid || entry->in_flight) && entry->addr == addr && entry->rule == rule) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+static adi_hbs_CacheEntry_t* alloc_entry(adi_hbs_Cache_t* cache, uint32_t now)
+{
+    // Prefer a free entry, then evict the oldest response
+    adi_hbs_CacheEntry_t* oldest = NULL;
+    for (size_t i = 0; i < cache->entry_cnt; i++) {
+        adi_hbs_CacheEntry_t* entry = &cache->entries[i];
+        if (entry->in_flight) {
+            continue;
+        }
+        if (!entry->valid) {
+            return entry;
+        }
+        if (oldest == NULL || HBS_TICKS_SINCE(now, entry->requested) > HBS_TICKS_SINCE(now, oldest->requested)) {
+            oldest = entry;
+        }
+    }
+    return oldest;
+}
+
+static void fill_done(adi_hbs_Txn_t* txn, hbs_txn_result_e result, adi_hbs_Packet_t* response, void* ctx)
+{
+    adi_hbs_CacheEntry_t* entry = ctx;
+    const uint8_t* data = NULL;
+    size_t len = 0;
+    if (result == HBS_TXN_RESPONSE) {
+        size_t skip = entry->rule->use_seq ? 1 : 0;
+        data = &response->data[skip];
+        len = response->len - skip;
+    }
+    if (data != NULL && len <= HBS_CACHE_DATA_LEN && !entry->invalidated) {
+        memcpy(entry->data, data, len);
+        entry->len = len;
+        entry->valid = true;
+    }
+
+    // The waiters are copied first, so the callbacks can request the same entry again
+    adi_hbs_CacheWaiter_t waiters[HBS_CACHE_MAX_WAITERS];
+    size_t waiter_cnt = entry->waiter_cnt;
+    memcpy(waiters, entry->waiters, waiter_cnt * sizeof(waiters[0]));
+    entry->waiter_cnt = 0;
+    entry->in_flight = false;
+    entry->invalidated = false;
+    for (size_t i = 0; i < waiter_cnt; i++) {
+        waiters[i].cb(entry->cache, result, data, len, waiters[i].ctx);
+    }
+}
+
+hbs_err_e adi_hbs_CacheInit(adi_hbs_Cache_t* cache, adi_hbs_Txn_t* txn, const adi_hbs_CacheRule_t* rules, size_t rule_cnt, adi_hbs_CacheEntry_t* entries, size_t entry_cnt)
+{
+    if (cache == NULL || txn == NULL || (rules == NULL && rule_cnt != 0) || (entries == NULL && entry_cnt != 0)) {
+        return HBS_ERR_BAD_PARAM;
+    }
+
+    cache->txn = txn;
+    cache->rules = rules;
+    cache->rule_cnt = rule_cnt;
+    cache->entries = entries;
+    cache->entry_cnt = entry_cnt;
+    cache->hit_cnt = 0;
+    cache->miss_cnt = 0;
+    cache->coalesced_cnt = 0;
+    for (size_t i = 0; i < entry_cnt; i++) {
+        entries[i].cache = cache;
+        entries[i].waiter_cnt = 0;
+        entries[i].valid = false;
+        entries[i].in_flight = false;
+        entries[i].invalidated = false;
+    }
+    return HBS_ERR_OK;
+}
+
+hbs_err_e adi_hbs_CacheGet(adi_hbs_Cache_t* cache, uint8_t addr, uint8_t opcode, hbs_cache_cb_t cb, void* ctx, uint32_t now)
+{
+    if (cache == NULL || cb == NULL) {
+        return HBS_ERR_BAD_PARAM;
+    }
+    const adi_hbs_CacheRule_t* rule = find_rule(cache, opcode);
+    if (rule == NULL) {
+        return HBS_ERR_BAD_PARAM;
+    }
+
+    adi_hbs_CacheEntry_t* entry = find_entry(cache, addr, rule);
+    if (entry != NULL && entry->in_flight) {
+        if (entry->waiter_cnt == HBS_CACHE_MAX_WAITERS) {
+            return HBS_ERR_NO_RESOURCES;
+        }
+        entry->waiters[entry->waiter_cnt++] = (adi_hbs_CacheWaiter_t){ .cb = cb, .ctx = ctx };
+        cache->coalesced_cnt++;
+        return HBS_ERR_OK;
+    }
+    if (entry != NULL && HBS_TICKS_SINCE(now, entry->requested) < (int32_t)rule->ttl) {
+        cache->hit_cnt++;
+        cb(cache, HBS_TXN_RESPONSE, entry->data, entry->len, ctx);
+        return HBS_ERR_OK;
+    }
+
+    if (entry == NULL) {
+        entry = alloc_entry(cache, now);
+        if (entry == NULL) {
+            return HBS_ERR_NO_RESOURCES;
+        }
+    }
+    adi_hbs_TxnRequest_t req = {
+        .dest = addr,
+        .opcode = rule->opcode,
+        .response_opcode = rule->response_opcode,
+        .use_seq = rule->use_seq,
+        .data = NULL,
+        .len = 0,
+        .timeout = rule->timeout,
+        .retries = rule->retries,
+        .cb = fill_done,
+        .ctx = entry
+    };
+    entry->rule = rule;
+    entry->addr = addr;
+    entry->requested = now;
+    entry->valid = false;
+    entry->in_flight = true;
+    entry->invalidated = false;
+    entry->waiters[0] = (adi_hbs_CacheWaiter_t){ .cb = cb, .ctx = ctx };
+    entry->waiter_cnt = 1;
+    hbs_err_e err = adi_hbs_TxnSubmit(cache->txn, &req, now);
+    if (err != HBS_ERR_OK) {
+        entry->waiter_cnt = 0;
+        entry->in_flight = false;
+        return err;
+    }
+    cache->miss_cnt++;
+    return HBS_ERR_OK;
+}
+
+hbs_err_e adi_hbs_CacheInvalidate(adi_hbs_Cache_t* cache, uint8_t addr)
+{
+    if (cache == NULL) {
+        return HBS_ERR_BAD_PARAM;
+    }
+
+    for (size_t i = 0; i < cache->entry_cnt; i++) {
+        if (cache->entries[i].addr == addr) {
+            cache->entries[i].valid = false;
+            // The response may have been sent before the node's state changed
+            cache->entries[i].invalidated = cache->entries[i].in_flight;
+        }
+    }
+    return HBS_ERR_OK;
+}
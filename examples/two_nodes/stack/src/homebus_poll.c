@@ -0,0 +1,170 @@
+/* 
+ * Copyright 2024 Analog Devices, Inc.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "homebus_poll.h"
+
+// Longest period HBS_TICKS_SINCE can compare
+#define MAX_PERIOD ((uint32_t)INT32_MAX)
+
+static void update_stats(adi_hbs_PollEntry_t* entry, uint32_t now)
+{
+    adi_hbs_PollStats_t* stats = &entry->stats;
+    if (stats->poll_cnt != 0) {
+        uint32_t interval = now - entry->last_poll;
+        uint32_t jitter = interval > entry->cur_period ? interval - entry->cur_period : entry->cur_period - interval;
+        if (jitter > stats->jitter_max) {
+            stats->jitter_max = jitter;
+        }
+        if (stats->poll_cnt == 1) {
+            stats->interval_avg = interval;
+        } else {
+            // Exponential moving average, weight 1/8
+            stats->interval_avg = stats->interval_avg - stats->interval_avg / 8 + interval / 8;
+        }
+    }
+    entry->last_poll = now;
+    stats->poll_cnt++;
+}
+
+static uint32_t backoff_limit(uint32_t period)
+{
+    // Compared before multiplying, so the limit doesn't wrap around
+    if (period >= MAX_PERIOD / HBS_POLL_MAX_BACKOFF) {
+        return period > MAX_PERIOD ? period : MAX_PERIOD;
+    }
+    return period * HBS_POLL_MAX_BACKOFF;
+}
+
+static void poll_done(adi_hbs_Txn_t* txn, hbs_txn_result_e result, adi_hbs_Packet_t* response, void* ctx)
+{
+    adi_hbs_PollEntry_t* entry = ctx;
+    entry->pending = false;
+    if (result == HBS_TXN_RESPONSE) {
+        entry->stats.response_cnt++;
+        entry->cur_period = entry->period;
+    } else {
+        entry->stats.timeout_cnt++;
+        response = NULL;
+        // Back off nodes that don't answer, so they don't take bus time from the others
+        uint32_t limit = backoff_limit(entry->period);
+        entry->cur_period = entry->cur_period >= limit / 2 ? limit : entry->cur_period * 2;
+    }
+    // The next poll is a period after this one, with the period now in use
+    entry->next_due = entry->last_poll + entry->cur_period;
+    if (entry->cb != NULL) {
+        entry->cb(entry->poll, entry, response);
+    }
+}
+
+static adi_hbs_PollEntry_t* next_due(adi_hbs_Poll_t* poll, uint32_t now)
+{
+    adi_hbs_PollEntry_t* best = NULL;
+    for (size_t i = 0; i < poll->entry_cnt; i++) {
+        adi_hbs_PollEntry_t* entry = &poll->entries[i];
+        if (entry->pending || HBS_TICKS_SINCE(now, entry->next_due) < 0) {
+            continue;
+        }
+        if (best == NULL || entry->priority > best->priority ||
+            (entry->priority == best->priority && HBS_TICKS_SINCE(best->next_due, entry->next_due) > 0)) {
+            best = entry;
+        }
+    }
+    return best;
+}
+
+hbs_err_e adi_hbs_PollInit(adi_hbs_Poll_t* poll, adi_hbs_Txn_t* txn, adi_hbs_PollEntry_t* entries, size_t entry_cnt, uint32_t now)
+{
+    if (poll == NULL || txn == NULL || (entries == NULL && entry_cnt != 0)) {
+        return HBS_ERR_BAD_PARAM;
+    }
+
+    poll->txn = txn;
+    poll->entries = entries;
+    poll->entry_cnt = entry_cnt;
+    poll->bus_idle = NULL;
+    poll->bus_idle_ctx = NULL;
+    for (size_t i = 0; i < entry_cnt; i++) {
+        adi_hbs_PollEntry_t* entry = &entries[i];
+        entry->poll = poll;
+        entry->cur_period = entry->period;
+        entry->next_due = now;
+        entry->last_poll = now;
+        entry->pending = false;
+        entry->stats = (adi_hbs_PollStats_t){ 0 };
+    }
+    return HBS_ERR_OK;
+}
+
+hbs_err_e adi_hbs_PollSetBusIdle(adi_hbs_Poll_t* poll, hbs_poll_idle_fn bus_idle, void* ctx)
+{
+    if (poll == NULL) {
+        return HBS_ERR_BAD_PARAM;
+    }
+
+    poll->bus_idle = bus_idle;
+    poll->bus_idle_ctx = ctx;
+    return HBS_ERR_OK;
+}
+
+static bool bus_free(const adi_hbs_Poll_t* poll)
+{
+    if (poll->bus_idle != NULL) {
+        return poll->bus_idle(poll->bus_idle_ctx);
+    }
+    // A response may be on its way as long as a transaction is outstanding
+    return adi_hbs_TxnPending(poll->txn) == 0;
+}
+
+hbs_err_e adi_hbs_PollRun(adi_hbs_Poll_t* poll, uint32_t now)
+{
+    if (poll == NULL) {
+        return HBS_ERR_BAD_PARAM;
+    }
+
+    hbs_err_e ret = adi_hbs_TxnPoll(poll->txn, now);
+
+    // Each send blocks until the request is on the bus, so the bus is tested again before the next one
+    adi_hbs_PollEntry_t* entry;
+    while (adi_hbs_TxnPending(poll->txn) < poll->txn->slot_cnt && bus_free(poll) && (entry = next_due(poll, now)) != NULL) {
+        adi_hbs_TxnRequest_t req = {
+            .dest = entry->addr,
+            .opcode = entry->opcode,
+            .response_opcode = entry->response_opcode,
+            .use_seq = entry->use_seq,
+            .data = NULL,
+            .len = 0,
+            .timeout = entry->timeout,
+            .retries = 0,
+            .cb = poll_done,
+            .ctx = entry
+        };
+        update_stats(entry, now);
+        entry->next_due += entry->cur_period;
+        if (HBS_TICKS_SINCE(now, entry->next_due) > 0) {
+            // More than a period behind, don't try to catch up with a burst of polls
+            entry->next_due = now + entry->cur_period;
+        }
+        entry->pending = true;
+        hbs_err_e err = adi_hbs_TxnSubmit(poll->txn, &req, now);
+        if (err != HBS_ERR_OK) {
+            poll_done(poll->txn, HBS_TXN_SEND_FAILED, NULL, entry);
+            if (ret == HBS_ERR_OK) {
+                ret = err;
+            }
+        }
+    }
+    return ret;
+}
@@ -0,0 +1,179 @@
+/* 
+ * Copyright 2024 Analog Devices, Inc.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "homebus_pubsub.h"
+
+static bool is_due(const adi_hbs_PubPoint_t* point, uint32_t now)
+{
+    if (!point->sent) {
+        return true;
+    }
+    uint32_t elapsed = now - point->sent_time;
+    if (point->max_interval != 0 && elapsed >= point->max_interval) {
+        return true;
+    }
+    // Widen before subtracting, the difference of two int32_t can overflow
+    int64_t change = (int64_t)point->value - point->sent_value;
+    uint64_t abs_change = change < 0 ? (uint64_t)-change : (uint64_t)change;
+    return abs_change > point->deadband && elapsed >= point->min_interval;
+}
+
+static void put_entry(uint8_t* buf, const adi_hbs_PubPoint_t* point)
+{
+    uint32_t value = (uint32_t)point->value;
+    buf[0] = point->id;
+    buf[1] = value & 0xFF;
+    buf[2] = (value >> 8) & 0xFF;
+    buf[3] = (value >> 16) & 0xFF;
+    buf[4] = (value >> 24) & 0xFF;
+}
+
+static hbs_err_e update_handler(adi_hbs_t* hbs, adi_hbs_Packet_t* packet, void* ctx)
+{
+    adi_hbs_Sub_t* sub = ctx;
+    for (size_t offset = 0; offset + HBS_PUBSUB_ENTRY_SIZE <= packet->len; offset += HBS_PUBSUB_ENTRY_SIZE) {
+        const uint8_t* entry = &packet->data[offset];
+        adi_hbs_SubPoint_t* point = NULL;
+        for (size_t i = 0; i < sub->point_cnt; i++) {
+            if (sub->points[i].src == packet->self_addr && sub->points[i].id == entry[0]) {
+                point = &sub->points[i];
+                break;
+            }
+        }
+        if (point == NULL) {
+            sub->unknown_cnt++;
+            continue;
+        }
+
+        uint32_t value = entry[1] | ((uint32_t)entry[2] << 8) | ((uint32_t)entry[3] << 16) | ((uint32_t)entry[4] << 24);
+        point->value = (int32_t)value;
+        point->updated = sub->now;
+        point->valid = true;
+        if (sub->cb != NULL) {
+            sub->cb(sub, point, sub->ctx);
+        }
+    }
+    return HBS_ERR_OK;
+}
+
+hbs_err_e adi_hbs_PubInit(adi_hbs_Pub_t* pub, adi_hbs_t* hbs, uint8_t dest, uint8_t opcode, adi_hbs_PubPoint_t* points, size_t point_cnt)
+{
+    if (pub == NULL || hbs == NULL || (points == NULL && point_cnt != 0)) {
+        return HBS_ERR_BAD_PARAM;
+    }
+
+    pub->hbs = hbs;
+    pub->dest = dest;
+    pub->opcode = opcode;
+    pub->points = points;
+    pub->point_cnt = point_cnt;
+    pub->update_pkt_cnt = 0;
+    for (size_t i = 0; i < point_cnt; i++) {
+        points[i].value = 0;
+        points[i].sent_value = 0;
+        points[i].sent_time = 0;
+        points[i].sent = false;
+    }
+    return HBS_ERR_OK;
+}
+
+hbs_err_e adi_hbs_PubSet(adi_hbs_Pub_t* pub, uint8_t id, int32_t value)
+{
+    if (pub == NULL) {
+        return HBS_ERR_BAD_PARAM;
+    }
+
+    for (size_t i = 0; i < pub->point_cnt; i++) {
+        if (pub->points[i].id == id) {
+            pub->points[i].value = value;
+            return HBS_ERR_OK;
+        }
+    }
+    return HBS_ERR_BAD_PARAM;
+}
+
+hbs_err_e adi_hbs_PubRun(adi_hbs_Pub_t* pub, uint32_t now)
+{
+    if (pub == NULL) {
+        return HBS_ERR_BAD_PARAM;
+    }
+
+    uint8_t payload[HBS_PUBSUB_MAX_ENTRIES * HBS_PUBSUB_ENTRY_SIZE];
+    adi_hbs_PubPoint_t* batch[HBS_PUBSUB_MAX_ENTRIES];
+    size_t count = 0;
+    for (size_t i = 0; i <= pub->point_cnt; i++) {
+        bool last = i == pub->point_cnt;
+        if (!last && is_due(&pub->points[i], now)) {
+            put_entry(&payload[count * HBS_PUBSUB_ENTRY_SIZE], &pub->points[i]);
+            batch[count++] = &pub->points[i];
+        }
+        if (count == 0 || (!last && count < HBS_PUBSUB_MAX_ENTRIES)) {
+            continue;
+        }
+
+        hbs_err_e err = adi_hbs_Send(pub->hbs, pub->dest, pub->opcode, payload, count * HBS_PUBSUB_ENTRY_SIZE);
+        if (err != HBS_ERR_OK) {
+            return err;
+        }
+        pub->update_pkt_cnt++;
+        // Only values that reached the bus count as sent, the others are retried by the next call
+        for (size_t j = 0; j < count; j++) {
+            batch[j]->sent_value = batch[j]->value;
+            batch[j]->sent_time = now;
+            batch[j]->sent = true;
+        }
+        count = 0;
+    }
+    return HBS_ERR_OK;
+}
+
+hbs_err_e adi_hbs_SubInit(adi_hbs_Sub_t* sub, adi_hbs_t* hbs, uint8_t opcode, adi_hbs_SubPoint_t* points, size_t point_cnt, hbs_sub_cb_t cb, void* ctx)
+{
+    if (sub == NULL || hbs == NULL || (points == NULL && point_cnt != 0)) {
+        return HBS_ERR_BAD_PARAM;
+    }
+
+    sub->points = points;
+    sub->point_cnt = point_cnt;
+    sub->cb = cb;
+    sub->ctx = ctx;
+    sub->now = 0;
+    sub->unknown_cnt = 0;
+    for (size_t i = 0; i < point_cnt; i++) {
+        points[i].value = 0;
+        points[i].updated = 0;
+        points[i].valid = false;
+    }
+    return adi_hbs_RegisterOpHandler(hbs, opcode, update_handler, sub);
+}
+
+hbs_err_e adi_hbs_SubRun(adi_hbs_Sub_t* sub, uint32_t now)
+{
+    if (sub == NULL) {
+        return HBS_ERR_BAD_PARAM;
+    }
+
+    sub->now = now;
+    return HBS_ERR_OK;
+}
+
+bool adi_hbs_SubIsStale(const adi_hbs_Sub_t* sub, const adi_hbs_SubPoint_t* point, uint32_t now)
+{
+    if (sub == NULL || point == NULL || !point->valid) {
+        return true;
+    }
+    return point->max_age != 0 && HBS_TICKS_SINCE(now, point->updated) > (int32_t)point->max_age;
+}
@@ -0,0 +1,185 @@
+/* 
+ * Copyright 2024 Analog Devices, Inc.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "homebus_transaction.h"
+
+static hbs_err_e send_request(adi_hbs_Txn_t* txn, adi_hbs_TxnSlot_t* slot)
+{
+    adi_hbs_Segment_t payload[2];
+    size_t count = 0;
+    if (slot->req.use_seq) {
+        payload[count].data = &slot->seq;
+        payload[count].len = 1;
+        count++;
+    }
+    if (slot->req.len != 0) {
+        payload[count].data = slot->req.data;
+        payload[count].len = slot->req.len;
+        count++;
+    }
+    return adi_hbs_SendV(txn->hbs, slot->req.dest, slot->req.opcode, payload, count);
+}
+
+static void complete(adi_hbs_Txn_t* txn, adi_hbs_TxnSlot_t* slot, hbs_txn_result_e result, adi_hbs_Packet_t* response)
+{
+    // Release the slot first, so the callback can submit a new request
+    hbs_txn_cb_t cb = slot->req.cb;
+    void* ctx = slot->req.ctx;
+    slot->active = false;
+    if (cb != NULL) {
+        cb(txn, result, response, ctx);
+    }
+}
+
+static bool matches(const adi_hbs_TxnSlot_t* slot, const adi_hbs_Packet_t* packet)
+{
+    if (!slot->active || slot->req.dest != packet->self_addr || slot->req.response_opcode != packet->operation) {
+        return false;
+    }
+    return !slot->req.use_seq || (packet->len >= 1 && packet->data[0] == slot->seq);
+}
+
+static hbs_err_e response_handler(adi_hbs_t* hbs, adi_hbs_Packet_t* packet, void* ctx)
+{
+    adi_hbs_Txn_t* txn = ctx;
+    for (size_t i = 0; i < txn->slot_cnt; i++) {
+        adi_hbs_TxnSlot_t* slot = &txn->slots[i];
+        if (matches(slot, packet)) {
+            complete(txn, slot, HBS_TXN_RESPONSE, packet);
+            return HBS_ERR_OK;
+        }
+    }
+    txn->unmatched_cnt++;
+    return HBS_ERR_OK;
+}
+
+hbs_err_e adi_hbs_TxnInit(adi_hbs_Txn_t* txn, adi_hbs_t* hbs, adi_hbs_TxnSlot_t* slots, size_t slot_cnt)
+{
+    if (txn == NULL || hbs == NULL || slots == NULL || slot_cnt == 0) {
+        return HBS_ERR_BAD_PARAM;
+    }
+
+    txn->hbs = hbs;
+    txn->slots = slots;
+    txn->slot_cnt = slot_cnt;
+    txn->next_seq = 0;
+    txn->retry_cnt = 0;
+    txn->timeout_cnt = 0;
+    txn->unmatched_cnt = 0;
+    for (size_t i = 0; i < slot_cnt; i++) {
+        slots[i].active = false;
+    }
+    return HBS_ERR_OK;
+}
+
+hbs_err_e adi_hbs_TxnSubmit(adi_hbs_Txn_t* txn, const adi_hbs_TxnRequest_t* req, uint32_t now)
+{
+    if (txn == NULL || req == NULL || (req->len != 0 && req->data == NULL)) {
+        return HBS_ERR_BAD_PARAM;
+    }
+    if (req->len + (req->use_seq ? 1 : 0) > HBS_MAX_DATA_LEN) {
+        return HBS_ERR_BAD_PARAM;
+    }
+
+    adi_hbs_TxnSlot_t* slot = NULL;
+    for (size_t i = 0; i < txn->slot_cnt; i++) {
+        if (!txn->slots[i].active) {
+            slot = &txn->slots[i];
+            break;
+        }
+    }
+    if (slot == NULL) {
+        return HBS_ERR_NO_RESOURCES;
+    }
+
+    hbs_err_e err = adi_hbs_RegisterOpHandler(txn->hbs, req->response_opcode, response_handler, txn);
+    if (err != HBS_ERR_OK) {
+        return err;
+    }
+
+    slot->req = *req;
+    slot->seq = txn->next_seq++;
+    slot->retries_left = req->retries;
+    slot->deadline = now + req->timeout;
+    slot->active = true;
+    err = send_request(txn, slot);
+    if (err != HBS_ERR_OK) {
+        slot->active = false;
+    }
+    return err;
+}
+
+hbs_err_e adi_hbs_TxnPoll(adi_hbs_Txn_t* txn, uint32_t now)
+{
+    if (txn == NULL) {
+        return HBS_ERR_BAD_PARAM;
+    }
+
+    hbs_err_e ret = HBS_ERR_OK;
+    for (size_t i = 0; i < txn->slot_cnt; i++) {
+        adi_hbs_TxnSlot_t* slot = &txn->slots[i];
+        if (!slot->active || HBS_TICKS_SINCE(now, slot->deadline) < 0) {
+            continue;
+        }
+        if (slot->retries_left == 0) {
+            txn->timeout_cnt++;
+            complete(txn, slot, HBS_TXN_TIMEOUT, NULL);
+            continue;
+        }
+
+        slot->retries_left--;
+        slot->deadline = now + slot->req.timeout;
+        txn->retry_cnt++;
+        hbs_err_e err = send_request(txn, slot);
+        if (err != HBS_ERR_OK) {
+            complete(txn, slot, HBS_TXN_SEND_FAILED, NULL);
+            if (ret == HBS_ERR_OK) {
+                ret = err;
+            }
+        }
+    }
+    return ret;
+}
+
+hbs_err_e adi_hbs_TxnCancel(adi_hbs_Txn_t* txn, uint8_t dest)
+{
+    if (txn == NULL) {
+        return HBS_ERR_BAD_PARAM;
+    }
+
+    for (size_t i = 0; i < txn->slot_cnt; i++) {
+        adi_hbs_TxnSlot_t* slot = &txn->slots[i];
+        if (slot->active && slot->req.dest == dest) {
+            complete(txn, slot, HBS_TXN_CANCELLED, NULL);
+        }
+    }
+    return HBS_ERR_OK;
+}
+
+size_t adi_hbs_TxnPending(const adi_hbs_Txn_t* txn)
+{
+    if (txn == NULL) {
+        return 0;
+    }
+
+    size_t pending = 0;
+    for (size_t i = 0; i < txn->slot_cnt; i++) {
+        if (txn->slots[i].active) {
+            pending++;
+        }
+    }
+    return pending;
+}
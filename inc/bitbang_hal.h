@@ -24,6 +24,7 @@
 
 #include "common_hal.h"
 #include <stdint.h>
+#include <stddef.h>
 
 /**
  * @brief Configures the GPIO connected to DIN as an output.
@@ -63,6 +64,13 @@ int adi_max22x88_hal_GpioReadDout(void);
  */
 void adi_max22x88_hal_GpioIntConfigureDoutFallingEdge(void);
 
+/**
+ * @brief Configures the interrupt of the GPIO connected to DOUT to be triggered at both edges.
+ * Only used if MAX22X88_BITBANG_CAPTURE_RX is set.
+ * 
+ */
+void adi_max22x88_hal_GpioIntConfigureDoutBothEdges(void);
+
 /**
  * @brief Enables the interrupts of the GPIO connected to DOUT.
  * 
@@ -107,6 +115,14 @@ void adi_max22x88_hal_TimerShutdowSignal(void);
  */
 void adi_max22x88_hal_TimerSetCountSignal(uint32_t cnt);
 
+/**
+ * @brief Returns the number of timer ticks elapsed since the signal timer last reached its compare value.
+ * Used to measure the latency of the signal timer interrupt.
+ * 
+ * @return uint32_t elapsed ticks
+ */
+uint32_t adi_max22x88_hal_TimerGetLatencySignal(void);
+
 /**
  * @brief Enables interrupts of the signal timer.
  * 
@@ -140,4 +156,61 @@ void adi_max22x88_hal_NvicSetVectorSignal(void (*fn)(void));
  */
 void adi_max22x88_hal_NvicEnableSignal(void);
 
+/**
+ * @brief Starts the free-running counter used to timestamp driver events.
+ * 
+ */
+void adi_max22x88_hal_TimestampInit(void);
+
+/**
+ * @brief Reads the free-running counter used to timestamp driver events. The counter wraps around at 2^32.
+ * 
+ * @return uint32_t the counter value
+ */
+uint32_t adi_max22x88_hal_TimestampGet(void);
+
+/**
+ * @brief Returns the frequency of the counter read by adi_max22x88_hal_TimestampGet.
+ * 
+ * @return uint32_t frequency in Hz
+ */
+uint32_t adi_max22x88_hal_TimestampFrequency(void);
+
+/**
+ * @brief Returns the word that the DMA channel writes to drive DIN to a level, such as the value of the GPIO output
+ * register. Only required with MAX22X88_BITBANG_DMA_TX.
+ * 
+ * @param level 0 for low, otherwise high
+ * @return uint32_t the word
+ */
+uint32_t adi_max22x88_hal_DmaWordDin(int level);
+
+/**
+ * @brief Returns the level of DOUT in a word captured by the DMA channel. Only required with MAX22X88_BITBANG_DMA_TX.
+ * 
+ * @param word the captured word, such as the value of the GPIO input register
+ * @retval 0 DOUT is low
+ * @retval otherwise DOUT is high
+ */
+int adi_max22x88_hal_DmaReadDout(uint32_t word);
+
+/**
+ * @brief Starts writing words to DIN, one every `period` signal timer ticks, without CPU intervention.
+ * The first word is written right away and DIN keeps the level of the last word once the transfer ends.
+ * Only required with MAX22X88_BITBANG_DMA_TX.
+ * 
+ * @param words the words to write, from adi_max22x88_hal_DmaWordDin
+ * @param capture where DOUT is captured in the middle of each period, or NULL to not capture it
+ * @param count the number of words
+ * @param period signal timer ticks between two words
+ * @param fn called from the DMA completion interrupt once the period of the last word has elapsed
+ */
+void adi_max22x88_hal_DmaStartDin(const uint32_t* words, uint32_t* capture, size_t count, uint32_t period, void (*fn)(void));
+
+/**
+ * @brief Aborts the transfer started by adi_max22x88_hal_DmaStartDin. Only required with MAX22X88_BITBANG_DMA_TX.
+ * 
+ */
+void adi_max22x88_hal_DmaStopDin(void);
+
 #endif
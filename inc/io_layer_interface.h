@@ -34,4 +34,26 @@
  */
 adi_max22x88_Result_e adi_max22x88_DataReceived(adi_max22x88_t* driver, uint8_t data);
 
+/**
+ * @brief Stores a received frame in driver's rx buffer.
+ * In MAX22X88_RX_MODE_BYTES frames with errors are dropped and only the data of valid frames is stored.
+ * @note This function is called by the IO layer when incoming data is detected.
+ * 
+ * @param[in] driver the driver that received data
+ * @param[in] frame frame received
+ * @return adi_max22x88_Result_e 
+ */
+adi_max22x88_Result_e adi_max22x88_FrameReceived(adi_max22x88_t* driver, const adi_max22x88_Frame_t* frame);
+
+/**
+ * @brief Stores an end of burst marker in driver's rx buffer.
+ * The marker is a frame with status MAX22X88_FRAME_END_OF_BURST. It is only stored in MAX22X88_RX_MODE_FRAMES.
+ * @note This function is called by the IO layer when the bus has been idle for some time after a frame.
+ * 
+ * @param[in] driver the driver that received data
+ * @param[in] timestamp time at which the idle period was detected, if the IO layer provides it. Otherwise 0.
+ * @return adi_max22x88_Result_e 
+ */
+adi_max22x88_Result_e adi_max22x88_BurstEnded(adi_max22x88_t* driver, uint32_t timestamp);
+
 #endif
@@ -28,6 +28,17 @@
 
 #include "private/fifo.h"
 
+/**
+ * Set to 1 to pass every frame received and every byte transmitted to a recorder.
+ * See adi_max22x88_SetRecorder.
+ */
+#ifndef MAX22X88_RECORD
+#define MAX22X88_RECORD (0)
+#endif
+
+/** Longest idle gap, in bit-times, accepted in the `idle_gap_bits` initialization parameter of the IO layers. */
+#define MAX22X88_IDLE_GAP_BITS_MAX (255)
+
 /**
  * Driver status codes.
  * 
@@ -39,23 +50,84 @@ typedef enum {
     MAX22X88_ERR_BAD_PARAM, /*!< Parameter invalid. */
     MAX22X88_ERR_USER_FN, /*!< Error in user integration or IO layer implementation. */
     MAX22X88_ERR_INTERNAL, /*!< Internal error. */
+    MAX22X88_ERR_RX_FRAME, /*!< The frame read contains errors. */
 } adi_max22x88_Result_e;
 
+/**
+ * Status flags of a received frame.
+ * 
+ */
+typedef enum {
+    MAX22X88_FRAME_OK = 0, /*!< The frame is valid. */
+    MAX22X88_FRAME_ERR_START = (1 << 0), /*!< The start bit was sampled "high". */
+    MAX22X88_FRAME_ERR_STOP = (1 << 1), /*!< The stop bit was sampled "low". */
+    MAX22X88_FRAME_ERR_OFFDUTY = (1 << 2), /*!< Some off-duty bit-time was sampled "low". */
+    MAX22X88_FRAME_ERR_PARITY = (1 << 3), /*!< The parity bit is incorrect. */
+    MAX22X88_FRAME_END_OF_BURST = (1 << 4), /*!< Not a frame. The bus has been idle since the previous frame, see adi_max22x88_BurstEnded. */
+} adi_max22x88_FrameStatus_e;
+
+/**
+ * What the software buffer stores for incoming data.
+ * 
+ */
+typedef enum {
+    MAX22X88_RX_MODE_BYTES, /*!< Only the data of valid frames is stored. Frames with errors are dropped. */
+    MAX22X88_RX_MODE_FRAMES, /*!< Every frame is stored as an adi_max22x88_Frame_t, including frames with errors. */
+    MAX22X88_RX_MODE_TIMESTAMPED, /*!< Only valid frames are stored, as adi_max22x88_Frame_t, to keep their timestamps. */
+} adi_max22x88_RxMode_e;
+
+/**
+ * A received frame.
+ * 
+ */
+typedef struct {
+    uint32_t timestamp; /*!< Time of reception, if the IO layer provides it. Otherwise 0. */
+    uint8_t data; /*!< The data received. */
+    uint8_t status; /*!< adi_max22x88_FrameStatus_e flags. */
+} adi_max22x88_Frame_t;
+
 /**
  * Typedef for Max22x88 driver context.
  * 
  */
 typedef struct adi_max22x88_t adi_max22x88_t;
 
+/**
+ * Direction of a recorded frame.
+ * 
+ */
+typedef enum {
+    MAX22X88_RECORD_RX, /*!< The frame was received, or is an end of burst marker */
+    MAX22X88_RECORD_TX, /*!< The byte was written to the IO layer for transmission */
+} adi_max22x88_RecordDir_e;
+
+/**
+ * Recorder function, see adi_max22x88_SetRecorder. Transmitted bytes are passed with a timestamp of 0 and
+ * MAX22X88_FRAME_OK.
+ */
+typedef void (*adi_max22x88_Record_fn)(void* ctx, adi_max22x88_RecordDir_e dir, const adi_max22x88_Frame_t* frame);
+
 /** IO layer initialization function. */
 typedef adi_max22x88_Result_e (*adi_max22x88_LowLevelInit_fn)(adi_max22x88_t* driver, void* state, void* init_params);
 
 /** IO layer RST enable/disable function. */
 typedef adi_max22x88_Result_e (*adi_max22x88_LowLevelSetRst_fn)(adi_max22x88_t* driver, bool state);
 
+/**
+ * A block of data to transmit, part of a gather write.
+ * 
+ */
+typedef struct {
+    const uint8_t* data; /*!< data to transmit */
+    size_t len; /*!< length of data */
+} adi_max22x88_Segment_t;
+
 /** IO layer write function. */
 typedef adi_max22x88_Result_e (*adi_max22x88_LowLevelWrite_fn)(adi_max22x88_t* driver, uint8_t* data, size_t count);
 
+/** IO layer gather write function. The segments are transmitted back to back, in order. */
+typedef adi_max22x88_Result_e (*adi_max22x88_LowLevelWriteV_fn)(adi_max22x88_t* driver, const adi_max22x88_Segment_t* segments, size_t count);
+
 /**
  * IO layer function arguments.
  * 
@@ -64,7 +136,8 @@ typedef struct {
     adi_max22x88_LowLevelInit_fn init_fn; /*!< IO layer initialization function */
     size_t ctx_size; /*!< Context data size required by the IO layer implementation */
     adi_max22x88_LowLevelSetRst_fn set_rst_state_fn; /*!< IO layer RST enable/disable function */
-    adi_max22x88_LowLevelWrite_fn write_fn; /*!< IO layer write function */
+    adi_max22x88_LowLevelWrite_fn write_fn; /*!< IO layer write function. With MAX22X88_RECORD, passes the data to adi_max22x88_RecordTx. */
+    adi_max22x88_LowLevelWriteV_fn writev_fn; /*!< Optional IO layer gather write function. If NULL, each segment is written with write_fn. */
 } adi_max22x88_Functions_t;
 
 /**
@@ -75,7 +148,12 @@ struct adi_max22x88_t {
     volatile _adi_fifo_t rx_queue;
     void* low_level_ctx;
     adi_max22x88_Functions_t fns;
+    adi_max22x88_RxMode_e rx_mode;
     bool tx_state;
+#if MAX22X88_RECORD
+    adi_max22x88_Record_fn record_fn;
+    void* record_ctx;
+#endif
 };
 
 /**
@@ -89,6 +167,18 @@ struct adi_max22x88_t {
  */
 adi_max22x88_Result_e adi_max22x88_Init(adi_max22x88_t* driver, size_t rx_buffer_len, adi_max22x88_Functions_t fns, void* init_params);
 
+/**
+ * @brief Initializes the max22x88 driver with a specific Rx buffer mode.
+ * 
+ * @param[in] driver The driver to initialize.
+ * @param[in] rx_buffer_len Length, in elements, of the software buffer for incoming data.
+ * @param[in] rx_mode What the software buffer stores for each incoming frame.
+ * @param[in] fns The functions used by the IO layer.
+ * @param[in] init_params Initialization parameters for the IO layer. Can be NULL.
+ * @return adi_max22x88_Result_e MAX22X88_ERR_BAD_PARAM if rx_mode isn't one of adi_max22x88_RxMode_e.
+ */
+adi_max22x88_Result_e adi_max22x88_InitRxMode(adi_max22x88_t* driver, size_t rx_buffer_len, adi_max22x88_RxMode_e rx_mode, adi_max22x88_Functions_t fns, void* init_params);
+
 /**
  * @brief Transmits data. The procedure performed is: enables the transmitter, writes the data, then disables the transmitter.
  * 
@@ -99,15 +189,66 @@ adi_max22x88_Result_e adi_max22x88_Init(adi_max22x88_t* driver, size_t rx_buffer
  */
 adi_max22x88_Result_e adi_max22x88_Transmit(adi_max22x88_t* driver, uint8_t* data, size_t len);
 
+/**
+ * @brief Transmits data gathered from several segments, like adi_max22x88_Transmit.
+ * The segments are transmitted without being copied into a single buffer first.
+ * 
+ * @param[in] driver 
+ * @param[in] segments segments to be transmitted, in order
+ * @param[in] count number of segments
+ * @return adi_max22x88_Result_e 
+ */
+adi_max22x88_Result_e adi_max22x88_TransmitV(adi_max22x88_t* driver, const adi_max22x88_Segment_t* segments, size_t count);
+
 /**
  * @brief Reads one uint8_t of data from the software buffer.
+ * End of burst markers are skipped.
  * 
  * @param[in] driver 
  * @param[out] data data read
+ * @retval MAX22X88_ERR_RX_FRAME Only in MAX22X88_RX_MODE_FRAMES. The data was read from a frame with errors.
  * @return adi_max22x88_Result_e 
  */
 adi_max22x88_Result_e adi_max22x88_Read(adi_max22x88_t* driver, uint8_t* data);
 
+/**
+ * @brief Reads one frame from the software buffer.
+ * In MAX22X88_RX_MODE_BYTES the status is always MAX22X88_FRAME_OK and the timestamp is 0.
+ * 
+ * @param[in] driver 
+ * @param[out] frame frame read
+ * @return adi_max22x88_Result_e 
+ */
+adi_max22x88_Result_e adi_max22x88_ReadFrame(adi_max22x88_t* driver, adi_max22x88_Frame_t* frame);
+
+/**
+ * @brief Reads one uint8_t of data from the software buffer together with its time of reception.
+ * End of burst markers are skipped.
+ * The timestamp is only provided in MAX22X88_RX_MODE_FRAMES and MAX22X88_RX_MODE_TIMESTAMPED, otherwise it is 0.
+ * The unit depends on the IO layer, the bitbang implementation uses adi_max22x88_hal_TimestampGet ticks.
+ * 
+ * @param[in] driver 
+ * @param[out] data data read
+ * @param[out] timestamp time of reception
+ * @retval MAX22X88_ERR_RX_FRAME Only in MAX22X88_RX_MODE_FRAMES. The data was read from a frame with errors.
+ * @return adi_max22x88_Result_e 
+ */
+adi_max22x88_Result_e adi_max22x88_ReadTimestamped(adi_max22x88_t* driver, uint8_t* data, uint32_t* timestamp);
+
+/**
+ * @brief Reads up to `len` uint8_t of data from the software buffer.
+ * Reading stops before a frame with errors or an end of burst marker, which must be read with adi_max22x88_ReadFrame.
+ * 
+ * @param[in] driver 
+ * @param[out] data data read
+ * @param[in] len size of data
+ * @param[out] read amount of data read
+ * @retval MAX22X88_ERR_RX_FRAME Only in MAX22X88_RX_MODE_FRAMES. Nothing was read, the next frame has errors or is an end of burst marker.
+ * @retval MAX22X88_ERR_RX_BUFFER_EMPTY Nothing was read, the software buffer is empty.
+ * @return adi_max22x88_Result_e 
+ */
+adi_max22x88_Result_e adi_max22x88_ReadN(adi_max22x88_t* driver, uint8_t* data, size_t len, size_t* read);
+
 /**
  * @brief Checks if data is available in the software buffer.
  * 
@@ -125,6 +266,23 @@ bool adi_max22x88_IsAvailable(adi_max22x88_t* driver);
  */
 adi_max22x88_Result_e adi_max22x88_FlushRx(adi_max22x88_t* driver);
 
+#if MAX22X88_RECORD
+/**
+ * @brief Sets the function called with every frame stored by the IO layer, including frames with errors and end of
+ * burst markers, and every byte transmitted. adi_max22x88_CaptureRecord records them in the capture format.
+ * @note The function is called from the context of the IO layer's Rx path, often an interrupt, and from the context
+ * of adi_max22x88_Transmit. The bitbang, UART and SPI implementations mask their Rx interrupts before passing the
+ * transmitted bytes, so the two calls never overlap. The Linux implementation receives in another thread while
+ * transmitting, and the function must then serialize the calls itself.
+ * 
+ * @param[in] driver 
+ * @param[in] fn recorder function, NULL to stop recording
+ * @param[in] ctx context passed to `fn`
+ * @return adi_max22x88_Result_e 
+ */
+adi_max22x88_Result_e adi_max22x88_SetRecorder(adi_max22x88_t* driver, adi_max22x88_Record_fn fn, void* ctx);
+#endif
+
 /**
  * @brief Deinitialize the driver. Frees any dynamically allocated resources that have
  * been allocated.
@@ -25,6 +25,57 @@
 #include "max22x88.h"
 #include "io_layer_interface.h"
 
+/**
+ * Set to 1 to measure the latency of the signal timer interrupt.
+ * See adi_max22x88_GetJitterStatsBitbang.
+ */
+#ifndef MAX22X88_BITBANG_JITTER_STATS
+#define MAX22X88_BITBANG_JITTER_STATS (0)
+#endif
+
+/**
+ * Set to 1 to record bus events into a trace ring.
+ * See adi_max22x88_DumpTraceBitbang.
+ */
+#ifndef MAX22X88_BITBANG_TRACE
+#define MAX22X88_BITBANG_TRACE (0)
+#endif
+
+/** Number of records kept in the trace ring. Must be a power of 2. */
+#ifndef MAX22X88_BITBANG_TRACE_LEN
+#define MAX22X88_BITBANG_TRACE_LEN (256)
+#endif
+
+/**
+ * Set to 1 to transmit through a DMA channel writing DIN, instead of the signal timer interrupt.
+ * The HAL must implement the DMA section of bitbang_hal.h.
+ */
+#ifndef MAX22X88_BITBANG_DMA_TX
+#define MAX22X88_BITBANG_DMA_TX (0)
+#endif
+
+/** Number of frames rendered for each DMA transfer. Longer transmissions are sent in several transfers. */
+#ifndef MAX22X88_BITBANG_DMA_TX_FRAMES
+#define MAX22X88_BITBANG_DMA_TX_FRAMES (16)
+#endif
+
+/**
+ * Set to 1 to receive from the timestamps of the edges on DOUT, instead of sampling DOUT with the signal timer.
+ * The DOUT interrupt must be triggered at both edges and call adi_max22x88_EdgeIntCallback. The frames are then
+ * decoded by adi_max22x88_ProcessCaptureBitbang, which must be called regularly from thread context.
+ */
+#ifndef MAX22X88_BITBANG_CAPTURE_RX
+#define MAX22X88_BITBANG_CAPTURE_RX (0)
+#endif
+
+/** Number of edges buffered between the DOUT interrupt and adi_max22x88_ProcessCaptureBitbang. Must be a power of 2. A frame has up to 20 edges. */
+#ifndef MAX22X88_BITBANG_CAPTURE_EDGES
+#define MAX22X88_BITBANG_CAPTURE_EDGES (256)
+#endif
+
+/** Number of bins in the signal timer latency histogram. */
+#define MAX22X88_BITBANG_JITTER_BINS (16)
+
 /**
  * Status codes logged by the bitbang implementation.
  * 
@@ -38,17 +89,70 @@ typedef enum {
     BITBANG_LOG_FRAME_BAD_STOP, /*!< Frame error: the stop bit was sampled "low" */
     BITBANG_LOG_RX_OVF, /*!< Rx buffer is full */
     BITBANG_LOG_INTERNAL_ERROR, /*!< Internal error */
+    BITBANG_LOG_CAPTURE_OVF, /*!< DOUT edges were lost because the capture ring is full */
     BITBANG_LOG_MAX  // Keep BITBANG_LOG_MAX as the last entry
 } adi_max22x88_bitbang_LogCode_e;
 
 /**
  * Initialization parameters for bitbang IO layer.
+ * Fields may be added in later versions, so zero-initialize the struct, e.g. with `= { 0 }`, before setting the fields used.
+ * A field left to zero keeps the behaviour the driver had before it was added.
  * 
  */
 typedef struct {
     uint32_t hbs_baud; /*!< Home Bus System baud rate. The effective bitrate will be twice this value due to the 50% duty cycle. */
+    adi_max22x88_RxMode_e rx_mode; /*!< What the Rx buffer stores for each frame. Use MAX22X88_RX_MODE_FRAMES to also receive frames with errors, or MAX22X88_RX_MODE_TIMESTAMPED to timestamp valid frames. Timestamps are adi_max22x88_hal_TimestampGet ticks taken at the start bit edge. In MAX22X88_RX_MODE_BYTES the timestamp counter is only started and read with MAX22X88_RECORD, MAX22X88_BITBANG_TRACE or MAX22X88_BITBANG_CAPTURE_RX. */
+    uint32_t idle_gap_bits; /*!< Report the end of a burst once DOUT stays idle for this many bit-times after a stop bit, see adi_max22x88_BurstEnded. 0 disables the detection, at most MAX22X88_IDLE_GAP_BITS_MAX. */
 } adi_max22x88_bitbang_InitParams_t;
 
+/**
+ * Bus direction in which a signal timer interrupt was serviced.
+ * 
+ */
+typedef enum {
+    BITBANG_JITTER_DIR_TX, /*!< The interrupt was writing a bit to DIN */
+    BITBANG_JITTER_DIR_RX, /*!< The interrupt was sampling DOUT */
+} adi_max22x88_bitbang_JitterDir_e;
+
+/**
+ * Latency statistics of the signal timer interrupt, in signal timer ticks.
+ * The latency is the time between the timer reaching its compare value and the interrupt reading the timer.
+ * 
+ */
+typedef struct {
+    uint32_t histogram[MAX22X88_BITBANG_JITTER_BINS]; /*!< Bin 0 counts a latency of 0 ticks, bin n counts latencies in [2^(n-1), 2^n). The last bin also counts anything longer. */
+    uint32_t samples; /*!< Number of interrupts measured */
+    uint32_t half_bit_ticks; /*!< Ticks between two signal timer interrupts. A latency close to this value means a sample point was missed. */
+    uint32_t worst_ticks; /*!< Highest latency measured */
+    adi_max22x88_bitbang_JitterDir_e worst_dir; /*!< Bus direction when the highest latency was measured */
+    uint32_t worst_bit; /*!< Half-bit index within the frame when the highest latency was measured */
+    uint32_t worst_byte; /*!< Byte index within the transmission when the highest latency was measured. Always 0 for Rx. */
+} adi_max22x88_bitbang_JitterStats_t;
+
+/**
+ * Events recorded in the trace ring.
+ * 
+ */
+typedef enum {
+    BITBANG_TRACE_START_EDGE, /*!< Falling edge of a start bit detected on DOUT */
+    BITBANG_TRACE_DOUT_SAMPLE, /*!< DOUT sampled. `value` is the level, `index` the half-bit index within the frame */
+    BITBANG_TRACE_DIN_WRITE, /*!< DIN written. `value` is the level, `index` the half-bit index within the frame */
+    BITBANG_TRACE_COLLATION_MISMATCH, /*!< DOUT did not match the last DIN write. `value` is the DOUT level, `index` the half-bit index */
+    BITBANG_TRACE_FRAME_RESULT, /*!< Frame received. `value` is the data, `index` holds the frame error flags */
+    BITBANG_TRACE_RX_OVF, /*!< Frame dropped because the Rx buffer is full. `value` is the data */
+} adi_max22x88_bitbang_TraceEvent_e;
+
+/**
+ * A trace ring record. The layout is fixed so dumps can be decoded on a host, see tools/trace2vcd.
+ * 
+ */
+typedef struct {
+    uint32_t timestamp; /*!< Value of adi_max22x88_hal_TimestampGet when the event was recorded */
+    uint8_t event; /*!< adi_max22x88_bitbang_TraceEvent_e */
+    uint8_t value; /*!< Event specific value */
+    uint16_t index; /*!< Event specific index */
+} adi_max22x88_bitbang_TraceRecord_t;
+
 /**
  * Arguments for initializing driver with bitbang implementation.
  * 
@@ -72,4 +176,72 @@ adi_max22x88_Result_e adi_max22x88_InitBitbang(adi_max22x88_t* driver, adi_max22
  */
 adi_max22x88_Result_e adi_max22x88_FallingEdgeIntCallback(void);
 
+/**
+ * @brief Returns the time at which the last transmission started driving its first start bit.
+ * Compare it with the timestamps of received frames to measure the response latency on the wire.
+ * Always 0 in MAX22X88_RX_MODE_BYTES, unless MAX22X88_RECORD, MAX22X88_BITBANG_TRACE or MAX22X88_BITBANG_CAPTURE_RX
+ * is set: the timestamp counter is then neither started nor read.
+ * 
+ * @param[in] driver the driver
+ * @param[out] timestamp adi_max22x88_hal_TimestampGet ticks
+ * @return adi_max22x88_Result_e 
+ */
+adi_max22x88_Result_e adi_max22x88_GetTxTimestampBitbang(adi_max22x88_t* driver, uint32_t* timestamp);
+
+#if MAX22X88_BITBANG_CAPTURE_RX
+/**
+ * @brief This function must be called when an edge interrupt is triggered for the pin connected to DOUT.
+ * The edge is only stored, it is decoded by adi_max22x88_ProcessCaptureBitbang.
+ * 
+ * @param[in] timestamp adi_max22x88_hal_TimestampGet ticks taken at the edge, as early as possible in the interrupt
+ * @param[in] level the level of DOUT after the edge
+ * @return adi_max22x88_Result_e MAX22X88_ERR_RX_BUFFER_FULL if the capture ring is full, the edge is then lost.
+ */
+adi_max22x88_Result_e adi_max22x88_EdgeIntCallback(uint32_t timestamp, int level);
+
+/**
+ * @brief Decodes the edges captured since the last call, and stores the frames received in the rx buffer.
+ * It must be called often enough for the capture ring not to fill up, and before reading the rx buffer.
+ * Frames ending with "high" half-bits are only completed once their duration has elapsed.
+ * 
+ * @param[in] driver the driver
+ * @return adi_max22x88_Result_e 
+ */
+adi_max22x88_Result_e adi_max22x88_ProcessCaptureBitbang(adi_max22x88_t* driver);
+#endif
+
+#if MAX22X88_BITBANG_TRACE
+/**
+ * @brief Copies the most recent trace records, oldest first.
+ * Records overwritten by the interrupts while being copied are left out.
+ * 
+ * @param[in] driver the driver
+ * @param[out] records where the records are copied to
+ * @param[in] len the length (in records) of `records`
+ * @param[out] count the number of records copied
+ * @return adi_max22x88_Result_e 
+ */
+adi_max22x88_Result_e adi_max22x88_DumpTraceBitbang(adi_max22x88_t* driver, adi_max22x88_bitbang_TraceRecord_t* records, size_t len, size_t* count);
+#endif
+
+#if MAX22X88_BITBANG_JITTER_STATS
+/**
+ * @brief Copies the signal timer latency statistics.
+ * @note The statistics keep being updated by the interrupt while they are copied, so counts may be off by one.
+ * 
+ * @param[in] driver the driver
+ * @param[out] stats the statistics
+ * @return adi_max22x88_Result_e 
+ */
+adi_max22x88_Result_e adi_max22x88_GetJitterStatsBitbang(adi_max22x88_t* driver, adi_max22x88_bitbang_JitterStats_t* stats);
+
+/**
+ * @brief Clears the signal timer latency statistics.
+ * 
+ * @param[in] driver the driver
+ * @return adi_max22x88_Result_e 
+ */
+adi_max22x88_Result_e adi_max22x88_ResetJitterStatsBitbang(adi_max22x88_t* driver);
+#endif
+
 #endif
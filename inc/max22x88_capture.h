@@ -0,0 +1,202 @@
+/* 
+ * Copyright 2024 Analog Devices, Inc.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/**
+ * @file max22x88_capture.h
+ * Append-only capture format for the traffic seen by the driver, and replay of captures into the driver.
+ * 
+ * A capture starts with a MAX22X88_CAPTURE_HEADER_LEN byte header:
+ * | Offset | Size | Content |
+ * | --- | --- | --- |
+ * | 0 | 4 | MAX22X88_CAPTURE_MAGIC |
+ * | 4 | 1 | MAX22X88_CAPTURE_VERSION |
+ * | 5 | 1 | Header length, records start at this offset |
+ * | 6 | 2 | Reserved, 0 |
+ * | 8 | 4 | Timestamp frequency in Hz, little-endian. 0 if unknown. |
+ * 
+ * Each record is made of:
+ * - a tag byte, holding the adi_max22x88_CaptureKind_e in bits 7-6 and the frame error flags
+ *   (adi_max22x88_FrameStatus_e, bits 3-0) in bits 3-0
+ * - the timestamp, as the difference with the previous record's, in 7 bit groups starting with the least significant,
+ *   bit 7 being set in every group but the last. The first record holds its full timestamp.
+ * - the data byte, except for end of burst markers
+ * 
+ * Records are never modified once written, so a capture can be written to a file or a flash region as it grows, and
+ * a capture cut short is read up to its last complete record.
+ */
+
+#ifndef MAX22X88_CAPTURE_H
+#define MAX22X88_CAPTURE_H
+
+#include "max22x88.h"
+
+/** First bytes of a capture. */
+#define MAX22X88_CAPTURE_MAGIC "MXCP"
+
+/** Version of the capture format. */
+#define MAX22X88_CAPTURE_VERSION (1)
+
+/** Length of the header written by adi_max22x88_CaptureWriterInit. */
+#define MAX22X88_CAPTURE_HEADER_LEN (12)
+
+/** Longest record: tag, 5 bytes of timestamp difference and data. */
+#define MAX22X88_CAPTURE_RECORD_MAX_LEN (7)
+
+/**
+ * Kinds of records.
+ * 
+ */
+typedef enum {
+    MAX22X88_CAPTURE_KIND_RX, /*!< A frame received */
+    MAX22X88_CAPTURE_KIND_TX, /*!< A byte transmitted */
+    MAX22X88_CAPTURE_KIND_END_OF_BURST, /*!< The bus has been idle since the previous frame */
+} adi_max22x88_CaptureKind_e;
+
+/** Writes out the buffer of a capture writer. Returns false if the data couldn't be written. */
+typedef bool (*adi_max22x88_CaptureFlush_fn)(void* ctx, const uint8_t* data, size_t len);
+
+/** Reads the clock used to timestamp the records without a timestamp, in the unit of the IO layer's timestamps. */
+typedef uint32_t (*adi_max22x88_CaptureClock_fn)(void);
+
+/**
+ * Capture writer.
+ * 
+ */
+typedef struct {
+    uint8_t* buf; /*!< Buffer the records are appended to */
+    size_t len; /*!< Length of the buffer */
+    size_t used; /*!< Bytes held in the buffer */
+    uint32_t timestamp; /*!< Timestamp of the last record */
+    adi_max22x88_CaptureClock_fn clock; /*!< Clock, may be NULL */
+    adi_max22x88_CaptureFlush_fn flush; /*!< Called when the buffer is full, may be NULL */
+    void* flush_ctx; /*!< Context passed to `flush` */
+    uint32_t records; /*!< Records written */
+    uint32_t dropped; /*!< Records dropped because the buffer was full and couldn't be flushed */
+} adi_max22x88_CaptureWriter_t;
+
+/**
+ * A record read from a capture.
+ * 
+ */
+typedef struct {
+    adi_max22x88_CaptureKind_e kind; /*!< Kind of record */
+    adi_max22x88_Frame_t frame; /*!< The frame, as passed to adi_max22x88_FrameReceived. MAX22X88_FRAME_END_OF_BURST is set in `status` for end of burst markers. */
+    uint64_t elapsed; /*!< Timestamp ticks since the first record of the capture */
+} adi_max22x88_CaptureRecord_t;
+
+/**
+ * Capture reader.
+ * 
+ */
+typedef struct {
+    const uint8_t* buf; /*!< The capture */
+    size_t len; /*!< Length of the capture */
+    size_t pos; /*!< Offset of the next record */
+    uint32_t tick_hz; /*!< Timestamp frequency read from the header, 0 if unknown */
+    uint32_t timestamp; /*!< Timestamp of the last record read */
+    uint64_t elapsed; /*!< Ticks from the first record to the last record read */
+    bool started; /*!< A record has been read */
+} adi_max22x88_CaptureReader_t;
+
+/**
+ * @brief Initializes a capture writer and writes the header of the capture into its buffer.
+ * When the buffer is full, it is passed to `flush` and emptied. Without `flush`, the buffer holds the whole capture
+ * and records are dropped once it is full.
+ * 
+ * @param[out] writer the writer
+ * @param[in] buf buffer the records are appended to
+ * @param[in] len length of the buffer, at least MAX22X88_CAPTURE_HEADER_LEN + MAX22X88_CAPTURE_RECORD_MAX_LEN
+ * @param[in] tick_hz frequency of the timestamps, stored in the header. 0 if unknown.
+ * @param[in] clock reads the timestamp of records passed without one, such as transmitted bytes. May be NULL, such
+ * records then get the timestamp of the previous record.
+ * @param[in] flush writes out a full buffer, may be NULL
+ * @param[in] flush_ctx context passed to `flush`
+ * @return adi_max22x88_Result_e 
+ */
+adi_max22x88_Result_e adi_max22x88_CaptureWriterInit(adi_max22x88_CaptureWriter_t* writer, uint8_t* buf, size_t len, uint32_t tick_hz, adi_max22x88_CaptureClock_fn clock, adi_max22x88_CaptureFlush_fn flush, void* flush_ctx);
+
+/**
+ * @brief Appends a record to a capture. Its signature matches adi_max22x88_Record_fn, so it can be passed to
+ * adi_max22x88_SetRecorder with the writer as context.
+ * Records are expected in timestamp order. A timestamp earlier than the previous record's is recorded as equal to it,
+ * so idle periods longer than half the range of the timestamps are recorded as 0.
+ * 
+ * @param[in] writer the writer, an adi_max22x88_CaptureWriter_t
+ * @param[in] dir direction of the frame
+ * @param[in] frame the frame. Its timestamp is read from the clock if it is 0.
+ */
+void adi_max22x88_CaptureRecord(void* writer, adi_max22x88_RecordDir_e dir, const adi_max22x88_Frame_t* frame);
+
+/**
+ * @brief Passes the records held in the buffer to the flush function, and empties the buffer.
+ * Without a flush function, the buffer is left as is.
+ * 
+ * @param[in] writer the writer
+ * @return adi_max22x88_Result_e MAX22X88_ERR_USER_FN if the flush function failed, the buffer is then kept.
+ */
+adi_max22x88_Result_e adi_max22x88_CaptureWriterFlush(adi_max22x88_CaptureWriter_t* writer);
+
+/**
+ * @brief Initializes a capture reader and checks the header of the capture.
+ * 
+ * @param[out] reader the reader
+ * @param[in] buf the capture
+ * @param[in] len length of the capture
+ * @return adi_max22x88_Result_e MAX22X88_ERR_BAD_PARAM if the header is invalid or of a later version.
+ */
+adi_max22x88_Result_e adi_max22x88_CaptureReaderInit(adi_max22x88_CaptureReader_t* reader, const uint8_t* buf, size_t len);
+
+/**
+ * @brief Reads the next record of a capture.
+ * 
+ * @param[in] reader the reader
+ * @param[out] record the record
+ * @retval MAX22X88_ERR_RX_BUFFER_EMPTY There are no more complete records.
+ * @retval MAX22X88_ERR_RX_FRAME The record is corrupted, reading can't go on.
+ * @return adi_max22x88_Result_e 
+ */
+adi_max22x88_Result_e adi_max22x88_CaptureNext(adi_max22x88_CaptureReader_t* reader, adi_max22x88_CaptureRecord_t* record);
+
+/**
+ * @brief Goes back to the first record of a capture.
+ * 
+ * @param[in] reader the reader
+ * @return adi_max22x88_Result_e 
+ */
+adi_max22x88_Result_e adi_max22x88_CaptureRewind(adi_max22x88_CaptureReader_t* reader);
+
+/**
+ * @brief Passes the received frames and end of burst markers of a capture to the driver, as the IO layer did when the
+ * capture was recorded. Frames are passed to adi_max22x88_FrameReceived, which stores valid frames like
+ * adi_max22x88_DataReceived but keeps their timestamp. Transmitted bytes are skipped, the driver didn't receive them.
+ * Replaying stops before the first record later than `until`, so captures can be replayed at their original timing
+ * by passing the ticks elapsed since the replay started, or as fast as possible by passing UINT64_MAX. It also stops
+ * when the rx buffer is full, and carries on from the same record at the next call.
+ * 
+ * @param[in] reader the reader
+ * @param[in] driver the driver, with an IO layer that doesn't receive anything itself
+ * @param[in] until ticks since the first record of the capture
+ * @param[out] fed number of records passed to the driver, may be NULL
+ * @retval MAX22X88_ERR_OK The next record is later than `until`.
+ * @retval MAX22X88_ERR_RX_BUFFER_FULL The rx buffer is full, it must be read before replaying the rest of the capture.
+ * @retval MAX22X88_ERR_RX_BUFFER_EMPTY The end of the capture has been reached.
+ * @retval MAX22X88_ERR_RX_FRAME The next record is corrupted.
+ * @return adi_max22x88_Result_e 
+ */
+adi_max22x88_Result_e adi_max22x88_CaptureReplay(adi_max22x88_CaptureReader_t* reader, adi_max22x88_t* driver, uint64_t until, size_t* fed);
+
+#endif
@@ -0,0 +1,65 @@
+/* 
+ * Copyright 2024 Analog Devices, Inc.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file max22x88_spi.h
+ * API for the SPI implementation.
+ * 
+ * Each half-bit of a frame is oversampled: it is sent as `oversampling` identical bits on MOSI, so a whole
+ * transmission is written to DIN as one bitstream, without an interrupt per half-bit. DOUT is captured through MISO
+ * at the same rate and decoded in blocks, by majority vote over the samples of each half-bit.
+ */
+
+#ifndef MAX22X88_SPI_H
+#define MAX22X88_SPI_H
+
+#include "max22x88.h"
+#include "io_layer_interface.h"
+
+/** Lowest number of SPI bits per half-bit. */
+#define MAX22X88_SPI_OVERSAMPLING_MIN (4)
+
+/** Highest number of SPI bits per half-bit. */
+#define MAX22X88_SPI_OVERSAMPLING_MAX (8)
+
+/**
+ * Initialization parameters for SPI IO layer.
+ * 
+ */
+typedef struct {
+    uint32_t hbs_baud; /*!< Home Bus System baud rate. The SPI runs at `hbs_baud * 2 * oversampling` bits per second. */
+    uint8_t oversampling; /*!< SPI bits per half-bit, from MAX22X88_SPI_OVERSAMPLING_MIN to MAX22X88_SPI_OVERSAMPLING_MAX */
+    adi_max22x88_RxMode_e rx_mode; /*!< What the Rx buffer stores for each frame. The SPI implementation doesn't timestamp frames. */
+    uint32_t idle_gap_bits; /*!< Report the end of a burst once DOUT stays idle for this many bit-times after a stop bit, see adi_max22x88_BurstEnded. 0 disables the detection, at most MAX22X88_IDLE_GAP_BITS_MAX. */
+} adi_max22x88_spi_InitParams_t;
+
+/**
+ * Arguments for initializing driver with SPI implementation.
+ * 
+ */
+extern const adi_max22x88_Functions_t max22x88_spi_functions;
+
+/**
+ * @brief Initializes the max22x88 driver with the SPI implementation.
+ * 
+ * @param[in] driver the driver to initialize
+ * @param[in] params initialization parameters
+ * @param[in] rx_buffer_len the length of the rx buffer to be allocated
+ * @return adi_max22x88_Result_e 
+ */
+adi_max22x88_Result_e adi_max22x88_InitSpi(adi_max22x88_t* driver, adi_max22x88_spi_InitParams_t* params, size_t rx_buffer_len);
+
+#endif
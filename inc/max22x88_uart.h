@@ -0,0 +1,63 @@
+/* 
+ * Copyright 2024 Analog Devices, Inc.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file max22x88_uart.h
+ * API for the UART implementation.
+ * 
+ * The UART generates and samples the frames in hardware: start bit, 8 data bits, parity bit and stop bit, at the
+ * Home Bus baud rate. The CPU handles one Rx interrupt per received byte instead of four signal timer interrupts
+ * per bit. The bits are sent as full bit-times, without the return to "high" of the second half of each bit
+ * that the bitbang implementation writes to DIN.
+ * 
+ * A node using this implementation can't share a bus with nodes using the bitbang or SPI implementations. Its "0"
+ * bits stay low during the off-duty half-bit, which these nodes reject as MAX22X88_FRAME_ERR_OFFDUTY. The UART
+ * samples each bit in its middle, where the frames of these nodes return to "high" after a "0", so it can't
+ * receive them reliably either. All the nodes of a bus must use this implementation or the Linux one.
+ */
+
+#ifndef MAX22X88_UART_H
+#define MAX22X88_UART_H
+
+#include "max22x88.h"
+#include "io_layer_interface.h"
+
+/**
+ * Initialization parameters for UART IO layer.
+ * 
+ */
+typedef struct {
+    uint32_t hbs_baud; /*!< Home Bus System baud rate. The UART runs at this baud rate. */
+    adi_max22x88_RxMode_e rx_mode; /*!< What the Rx buffer stores for each frame. The UART implementation doesn't timestamp frames. */
+} adi_max22x88_uart_InitParams_t;
+
+/**
+ * Arguments for initializing driver with UART implementation.
+ * 
+ */
+extern const adi_max22x88_Functions_t max22x88_uart_functions;
+
+/**
+ * @brief Initializes the max22x88 driver with the UART implementation.
+ * 
+ * @param[in] driver the driver to initialize
+ * @param[in] params initialization parameters
+ * @param[in] rx_buffer_len the length of the rx buffer to be allocated
+ * @return adi_max22x88_Result_e 
+ */
+adi_max22x88_Result_e adi_max22x88_InitUart(adi_max22x88_t* driver, adi_max22x88_uart_InitParams_t* params, size_t rx_buffer_len);
+
+#endif
@@ -25,6 +25,14 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+/**
+ * Set to 1 to format and parse frames with constant lookup tables, generated at compile time, instead of computing
+ * the parity and the bit-stuffing for each byte. It costs 1.25 KiB of constant data.
+ */
+#ifndef MAX22X88_FRAME_TABLE
+#define MAX22X88_FRAME_TABLE (0)
+#endif
+
 /**
  * @brief Formats a logic value to be transmitted, LSB-first.
  * This adds a bit with value 1 at every second bit position, representing the off-duty period between the actual data bits.
@@ -43,4 +51,22 @@ uint32_t _stuff_byte_u32(uint16_t value);
  */
 bool _calc_even_parity_u8(uint8_t value);
 
+/**
+ * @brief Formats a byte as the 22 half-bits of a Home Bus frame: start bit, 8 data bits, parity bit and stop bit,
+ * each followed by its off-duty half-bit.
+ * 
+ * @param[in] value the byte
+ * @return uint32_t the half-bits to be written to DIN, LSB-first.
+ */
+uint32_t _format_frame_u32(uint8_t value);
+
+/**
+ * @brief Extracts the byte from the 22 half-bits of a received Home Bus frame and checks its framing.
+ * 
+ * @param[in] half_bits the half-bits sampled from DOUT, first one in bit 0
+ * @param[out] data the byte
+ * @return uint8_t adi_max22x88_FrameStatus_e flags, 0 if the frame is valid.
+ */
+uint8_t _parse_frame_u32(uint32_t half_bits, uint8_t* data);
+
 #endif
@@ -154,4 +154,16 @@ _adi_fifo_Result_e _adi_fifo_Read(volatile _adi_fifo_t* queue, void* data);
  */
 _adi_fifo_Result_e _adi_fifo_ReadN(volatile _adi_fifo_t* queue, void* out_buf, size_t len, size_t *read);
 
+/**
+ * @brief Pops up to `len` elements from the queue into `out_buf`.
+ * 
+ * @param[in] queue the FIFO queue.
+ * @param[out] out_buf where the elements are copied to
+ * @param[in] len the length (in elements) of buf.
+ * @param[out] read the number of elements that have been popped
+ * @retval FIFO_ERR_OK Success.
+ * @retval FIFO_ERR_BAD_PARAM
+ */
+_adi_fifo_Result_e _adi_fifo_PopN(volatile _adi_fifo_t* queue, void* out_buf, size_t len, size_t *read);
+
 #endif
@@ -26,7 +26,7 @@
 #include <stddef.h>
 #include <stdbool.h>
 
-/** State machine status codes. */
+/** State machine status codes. The values match adi_max22x88_FrameStatus_e. */
 typedef enum {
     RX_SM_ERROR_NO_ERROR = 0,
     RX_SM_ERROR_START_BIT_SAMPLE = (1 << 0),
@@ -0,0 +1,105 @@
+/* 
+ * Copyright 2024 Analog Devices, Inc.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file max22x88_edge_decoder.h
+ * Decoder rebuilding Home Bus frames from the timestamps of the edges on DOUT.
+ * 
+ * The level of DOUT in the middle of each half-bit is deduced from the last edge before it, so the decoder only
+ * runs when an edge is captured or when it is polled, instead of at every half-bit. Each edge close enough
+ * to a half-bit boundary realigns the timing, which absorbs the baud rate mismatch between nodes.
+ * It doesn't depend on any HAL and can be fed with synthetic edges.
+ */
+
+#ifndef PRIVATE_MAX22X88_EDGE_DECODER_H
+#define PRIVATE_MAX22X88_EDGE_DECODER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/** Events reported by the decoder. */
+typedef enum {
+    EDGE_DEC_NONE = 0, /*!< Nothing to report */
+    EDGE_DEC_FRAME = (1 << 0), /*!< A frame has been decoded into the result */
+    EDGE_DEC_END_OF_BURST = (1 << 1), /*!< DOUT has been idle for the idle gap since the last frame */
+} _adi_edge_dec_Event_e;
+
+/** A decoded frame. */
+typedef struct {
+    uint32_t timestamp; /*!< Time of the start bit edge */
+    uint8_t data; /*!< The data received */
+    uint8_t status; /*!< adi_max22x88_FrameStatus_e flags */
+} _adi_edge_dec_Result_t;
+
+/** The decoder object. */
+typedef struct {
+    uint32_t half_bit_ticks;
+    uint32_t tolerance_ticks;
+    uint32_t idle_gap_ticks;
+    bool level;
+    bool in_frame;
+    uint32_t frame_start;
+    uint32_t anchor;
+    uint32_t anchor_index;
+    uint32_t next_half_bit;
+    uint32_t half_bits;
+    bool burst_open;
+    uint32_t frame_end;
+} _adi_edge_dec_t;
+
+/**
+ * @brief Initializes the decoder. DOUT is assumed idle ("high").
+ * 
+ * @param[in] dec the decoder.
+ * @param[in] half_bit_ticks duration of a half-bit, in the unit of the timestamps.
+ * @param[in] idle_gap_ticks report the end of a burst once DOUT stays idle for this long after a frame. 0 disables
+ * the detection.
+ */
+void _adi_edge_dec_Init(_adi_edge_dec_t* dec, uint32_t half_bit_ticks, uint32_t idle_gap_ticks);
+
+/**
+ * @brief Drops the frame being decoded and assumes DOUT is idle, for instance after edges were lost.
+ * 
+ * @param[in] dec the decoder.
+ * @retval true a burst was open, its end hasn't been reported.
+ * @retval false otherwise.
+ */
+bool _adi_edge_dec_Reset(_adi_edge_dec_t* dec);
+
+/**
+ * @brief Processes an edge on DOUT. Edges must be passed in order.
+ * 
+ * @param[in] dec the decoder.
+ * @param[in] timestamp time of the edge.
+ * @param[in] level level of DOUT after the edge.
+ * @param[out] result the frame, if EDGE_DEC_FRAME is returned.
+ * @return uint32_t _adi_edge_dec_Event_e flags. A frame is always reported before the end of its burst.
+ */
+uint32_t _adi_edge_dec_Edge(_adi_edge_dec_t* dec, uint32_t timestamp, bool level, _adi_edge_dec_Result_t* result);
+
+/**
+ * @brief Tells the decoder that no edge happened up to a point in time, which completes a frame ending with
+ * "high" half-bits and detects the end of a burst.
+ * 
+ * @param[in] dec the decoder.
+ * @param[in] now the time up to which all the edges have been passed to the decoder.
+ * @param[out] result the frame, if EDGE_DEC_FRAME is returned.
+ * @return uint32_t _adi_edge_dec_Event_e flags.
+ */
+uint32_t _adi_edge_dec_Poll(_adi_edge_dec_t* dec, uint32_t now, _adi_edge_dec_Result_t* result);
+
+#endif
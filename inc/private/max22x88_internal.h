@@ -36,6 +36,16 @@
  */
 adi_max22x88_Result_e adi_max22x88_Write(adi_max22x88_t* driver, uint8_t* data, size_t len);
 
+/**
+ * @brief Write data gathered from several segments to the bus.
+ * 
+ * @param[in] driver the driver.
+ * @param[in] segments segments to be written, in order.
+ * @param[in] count number of segments.
+ * @return adi_max22x88_Result_e 
+ */
+adi_max22x88_Result_e adi_max22x88_WriteV(adi_max22x88_t* driver, const adi_max22x88_Segment_t* segments, size_t count);
+
 /**
  * @brief Getter for the IO layer context.
  * 
@@ -53,4 +63,17 @@ void* adi_max22x88_GetLowLevelCtx(adi_max22x88_t* driver);
  */
 adi_max22x88_Result_e adi_max22x88_SetTxState(adi_max22x88_t* driver, bool state);
 
+#if MAX22X88_RECORD
+/**
+ * @brief Passes the bytes about to be transmitted to the recorder, if one is set.
+ * Called by the IO layer's write function once its Rx path is masked, so that the recorder isn't entered from the Rx
+ * path at the same time.
+ * 
+ * @param[in] driver the driver.
+ * @param[in] segments segments to be transmitted, in order.
+ * @param[in] count number of segments.
+ */
+void adi_max22x88_RecordTx(adi_max22x88_t* driver, const adi_max22x88_Segment_t* segments, size_t count);
+#endif
+
 #endif
@@ -0,0 +1,83 @@
+/* 
+ * Copyright 2024 Analog Devices, Inc.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file spi_hal.h
+ * HAL API for the SPI implementation.
+ * 
+ * MOSI is connected to DIN and MISO to DOUT. The SPI controller only provides the bit clock: SCK and CS are not
+ * connected to the transceiver. Bytes are shifted out and in MSB-first.
+ */
+
+#ifndef SPI_HAL_H
+#define SPI_HAL_H
+
+#include "common_hal.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/**
+ * @brief Initializes the SPI controller as a master at the given bit rate. MOSI must idle "high" between transfers,
+ * with a pull-up or by keeping the last bit sent.
+ * 
+ * @param bit_rate SCK frequency in bits per second.
+ */
+void adi_max22x88_hal_SpiInit(uint32_t bit_rate);
+
+/**
+ * @brief Shuts down the SPI controller.
+ * 
+ */
+void adi_max22x88_hal_SpiShutdown(void);
+
+/**
+ * @brief Queues data to be shifted out on MOSI. Blocks while the Tx FIFO is full, and returns once the last byte is
+ * queued. Data queued by consecutive calls must be sent without a gap, as long as the next call comes before the
+ * Tx FIFO runs empty.
+ * 
+ * @param data data to shift out
+ * @param len length of data
+ */
+void adi_max22x88_hal_SpiWrite(const uint8_t* data, size_t len);
+
+/**
+ * @brief Waits until the last bit queued has been shifted out.
+ * 
+ */
+void adi_max22x88_hal_SpiWaitTxDone(void);
+
+/**
+ * @brief Sets the function called with each block of data captured from MISO, typically from the DMA interrupt of
+ * a circular buffer. The block is only valid until the function returns.
+ * 
+ * @param fn the callback function
+ */
+void adi_max22x88_hal_SpiSetRxCallback(void (*fn)(const uint8_t* data, size_t len));
+
+/**
+ * @brief Starts capturing MISO continuously at the SPI bit rate, without gaps between blocks.
+ * 
+ */
+void adi_max22x88_hal_SpiStartRx(void);
+
+/**
+ * @brief Stops capturing MISO. The data captured since the last block is discarded.
+ * 
+ */
+void adi_max22x88_hal_SpiStopRx(void);
+
+#endif
@@ -0,0 +1,104 @@
+/* 
+ * Copyright 2024 Analog Devices, Inc.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file uart_hal.h
+ * HAL API for the UART implementation.
+ */
+
+#ifndef UART_HAL_H
+#define UART_HAL_H
+
+#include "common_hal.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/**
+ * Reception errors reported by adi_max22x88_hal_UartRead.
+ * 
+ */
+typedef enum {
+    MAX22X88_HAL_UART_ERR_PARITY = (1 << 0), /*!< The parity bit is incorrect. */
+    MAX22X88_HAL_UART_ERR_FRAMING = (1 << 1), /*!< The stop bit was sampled "low". */
+    MAX22X88_HAL_UART_ERR_OVERRUN = (1 << 2), /*!< Data was lost before this byte because the Rx FIFO was full. */
+} adi_max22x88_hal_UartError_e;
+
+/**
+ * @brief Initializes the UART connected to DIN and DOUT with 8 data bits, even parity and 1 stop bit, the parity of
+ * the Home Bus frame.
+ * The Rx interrupt is left disabled.
+ * 
+ * @param baud_rate the baud rate in bits per second.
+ */
+void adi_max22x88_hal_UartInit(uint32_t baud_rate);
+
+/**
+ * @brief Shuts down the UART.
+ * 
+ */
+void adi_max22x88_hal_UartShutdown(void);
+
+/**
+ * @brief Queues data for transmission. Blocks while the Tx FIFO is full, and returns once the last byte is queued.
+ * 
+ * @param data data to transmit
+ * @param len length of data
+ */
+void adi_max22x88_hal_UartWrite(const uint8_t* data, size_t len);
+
+/**
+ * @brief Waits until the stop bit of the last byte queued has been transmitted.
+ * 
+ */
+void adi_max22x88_hal_UartWaitTxDone(void);
+
+/**
+ * @brief Reads one byte from the Rx FIFO.
+ * 
+ * @param[out] data the byte read
+ * @param[out] errors adi_max22x88_hal_UartError_e flags of the byte read
+ * @retval true a byte was read.
+ * @retval false the Rx FIFO is empty.
+ */
+bool adi_max22x88_hal_UartRead(uint8_t* data, uint8_t* errors);
+
+/**
+ * @brief Discards the content of the Rx FIFO.
+ * 
+ */
+void adi_max22x88_hal_UartFlushRx(void);
+
+/**
+ * @brief Sets the function called by the Rx interrupt, triggered while the Rx FIFO is not empty.
+ * 
+ * @param fn the callback function
+ */
+void adi_max22x88_hal_UartSetRxCallback(void (*fn)(void));
+
+/**
+ * @brief Enables the Rx interrupt of the UART.
+ * 
+ */
+void adi_max22x88_hal_UartIntEnableRx(void);
+
+/**
+ * @brief Disables the Rx interrupt of the UART. Received data stays in the Rx FIFO.
+ * 
+ */
+void adi_max22x88_hal_UartIntDisableRx(void);
+
+#endif
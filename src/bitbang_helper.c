@@ -14,8 +14,10 @@
  * limitations under the License.
  */
 #include "private/bitbang_helper.h"
+#include "max22x88.h"
 
 #define HBS_32_BIT_PATTERN (0b10101010101010101010101010101010)
+#define HBS_OFFDUTY_MASK (0x2AAAAA)  // Off-duty half-bits of a 22 half-bit frame
 
 uint32_t _stuff_byte_u32(uint16_t value)
 {
@@ -63,3 +65,93 @@ bool _calc_even_parity_u8(uint8_t value)
 {
     return parity_lookup_table_256[value];
 }
+
+#if MAX22X88_FRAME_TABLE
+// The tables are generated by the preprocessor, so they are constant data and can stay in flash
+#define FT_BIT(x, i) ((((uint32_t)(x) >> (i)) & 1u) << (2 * (i)))
+#define FT_STUFF(x) (FT_BIT(x, 0) | FT_BIT(x, 1) | FT_BIT(x, 2) | FT_BIT(x, 3) | FT_BIT(x, 4) | FT_BIT(x, 5) | \
+    FT_BIT(x, 6) | FT_BIT(x, 7) | FT_BIT(x, 8) | FT_BIT(x, 9) | FT_BIT(x, 10) | HBS_32_BIT_PATTERN)
+#define FT_PARITY(v) ((((v) >> 0) ^ ((v) >> 1) ^ ((v) >> 2) ^ ((v) >> 3) ^ ((v) >> 4) ^ ((v) >> 5) ^ ((v) >> 6) ^ ((v) >> 7)) & 1u)
+#define FT_FRAME(v) FT_STUFF(((uint32_t)(v) << 1) | (FT_PARITY(v) << 9) | (1u << 10))
+#define FT_FRAME4(v) FT_FRAME(v), FT_FRAME((v) + 1), FT_FRAME((v) + 2), FT_FRAME((v) + 3)
+#define FT_FRAME16(v) FT_FRAME4(v), FT_FRAME4((v) + 4), FT_FRAME4((v) + 8), FT_FRAME4((v) + 12)
+#define FT_FRAME64(v) FT_FRAME16(v), FT_FRAME16((v) + 16), FT_FRAME16((v) + 32), FT_FRAME16((v) + 48)
+
+// Packs the bits at even positions of a byte into a nibble
+#define UT_NIBBLE(b) (((b) & 1) | (((b) >> 1) & 2) | (((b) >> 2) & 4) | (((b) >> 3) & 8))
+#define UT_NIBBLE4(b) UT_NIBBLE(b), UT_NIBBLE((b) + 1), UT_NIBBLE((b) + 2), UT_NIBBLE((b) + 3)
+#define UT_NIBBLE16(b) UT_NIBBLE4(b), UT_NIBBLE4((b) + 4), UT_NIBBLE4((b) + 8), UT_NIBBLE4((b) + 12)
+#define UT_NIBBLE64(b) UT_NIBBLE16(b), UT_NIBBLE16((b) + 16), UT_NIBBLE16((b) + 32), UT_NIBBLE16((b) + 48)
+
+/** The frame of each byte, as returned by _format_frame_u32. */
+static const uint32_t frame_table[256] = {
+    FT_FRAME64(0), FT_FRAME64(64), FT_FRAME64(128), FT_FRAME64(192)
+};
+
+/** The data bits held by 8 half-bits of a frame, on-duty half-bit first. */
+static const uint8_t unstuff_table[256] = {
+    UT_NIBBLE64(0), UT_NIBBLE64(64), UT_NIBBLE64(128), UT_NIBBLE64(192)
+};
+
+uint32_t _format_frame_u32(uint8_t value)
+{
+    return frame_table[value];
+}
+
+uint8_t _parse_frame_u32(uint32_t half_bits, uint8_t* data)
+{
+    uint8_t status = MAX22X88_FRAME_OK;
+    uint8_t value = unstuff_table[(half_bits >> 2) & 0xFF] | (unstuff_table[(half_bits >> 10) & 0xFF] << 4);
+    if (half_bits & (1 << 0)) {
+        status |= MAX22X88_FRAME_ERR_START;
+    }
+    if (!(half_bits & (1 << 20))) {
+        status |= MAX22X88_FRAME_ERR_STOP;
+    }
+    if ((half_bits & HBS_OFFDUTY_MASK) != HBS_OFFDUTY_MASK) {
+        status |= MAX22X88_FRAME_ERR_OFFDUTY;
+    }
+    if ((half_bits ^ frame_table[value]) & (1 << 18)) {
+        // The parity half-bit differs from the one the byte is sent with
+        status |= MAX22X88_FRAME_ERR_PARITY;
+    }
+    *data = value;
+    return status;
+}
+#else
+uint32_t _format_frame_u32(uint8_t value)
+{
+    bool parity_bit = _calc_even_parity_u8(value);
+
+    // Add start, parity and stop bits
+    uint16_t prepared_data = value; // requires using a a bigger data type
+    prepared_data |= (parity_bit << 8);  // Add the parity bit after the 8 data bits.
+    prepared_data |= (1 << 9);  // Add stop bit after the parity bit. The stop bit has value 1.
+    prepared_data <<= 1;  // Add start bit before all other bits. The start bit has value 0.
+    return _stuff_byte_u32(prepared_data);
+}
+
+uint8_t _parse_frame_u32(uint32_t half_bits, uint8_t* data)
+{
+    uint8_t status = MAX22X88_FRAME_OK;
+    uint8_t value = 0;
+    for (uint32_t i = 0; i < 8; i++) {
+        value |= ((half_bits >> (2 * (i + 1))) & 1) << i;
+    }
+    bool parity_bit = (half_bits >> 18) & 1;
+    if (half_bits & (1 << 0)) {
+        status |= MAX22X88_FRAME_ERR_START;
+    }
+    if (!(half_bits & (1 << 20))) {
+        status |= MAX22X88_FRAME_ERR_STOP;
+    }
+    if ((half_bits & HBS_OFFDUTY_MASK) != HBS_OFFDUTY_MASK) {
+        status |= MAX22X88_FRAME_ERR_OFFDUTY;
+    }
+    if (parity_bit != _calc_even_parity_u8(value)) {
+        status |= MAX22X88_FRAME_ERR_PARITY;
+    }
+    *data = value;
+    return status;
+}
+#endif
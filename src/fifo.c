@@ -25,6 +25,11 @@
 // Assigns a queue buffer index to its next value, one element ahead.
 #define ADVANCE_IDX(queue, idx) (idx) = NEXT_IDX(queue, idx)
 
+// Order the element copies with the index updates. Needed when the producer and the consumer run on
+// different cores, such as the Rx thread of the Linux IO layer. On a single core MCU they only cost a barrier.
+#define PUBLISH_FENCE() __atomic_thread_fence(__ATOMIC_RELEASE)
+#define CONSUME_FENCE() __atomic_thread_fence(__ATOMIC_ACQUIRE)
+
 static _adi_fifo_Result_e fifo_init_buf(volatile _adi_fifo_t *queue, void *buf, size_t buf_size, size_t elem_size)
 {
     if (buf == NULL) {
@@ -90,6 +95,7 @@ _adi_fifo_Result_e _adi_fifo_Push(volatile _adi_fifo_t* queue, void* data)
     }
     char *buf = queue->buf;
     memcpy(&buf[queue->head], data, queue->elem_size);
+    PUBLISH_FENCE();
     ADVANCE_IDX(queue, queue->head);
     return FIFO_ERR_OK;
 }
@@ -105,6 +111,7 @@ _adi_fifo_Result_e _adi_fifo_Pop(volatile _adi_fifo_t* queue, void* data)
         ret = _adi_fifo_Read(queue, data);
     }
     if (ret == FIFO_ERR_OK) {
+        PUBLISH_FENCE();
         ADVANCE_IDX(queue, queue->tail);
     }
     return ret;
@@ -172,6 +179,7 @@ _adi_fifo_Result_e _adi_fifo_Read(volatile _adi_fifo_t* queue, void* data)
     if (_adi_fifo_IsEmpty(queue)) {
         return FIFO_ERR_BUFFER_EMPTY;
     }
+    CONSUME_FENCE();
     char *buf = queue->buf;
     memcpy(data, &buf[queue->tail], queue->elem_size);
     return FIFO_ERR_OK;
@@ -185,12 +193,15 @@ _adi_fifo_Result_e _adi_fifo_ReadN(volatile _adi_fifo_t* queue, void* out_buf, s
 
     size_t head = queue->head;
     size_t tail = queue->tail;
+    CONSUME_FENCE();
     char* src_buf  = queue->buf;
     char* dest_buf = out_buf;
 
-    // Don't try to read more elements than the current length
-    if (len > _adi_fifo_Len(queue)) {
-        len = _adi_fifo_Len(queue);
+    // Don't try to read more elements than the current length. Use the indexes read above, the producer may have
+    // advanced the head since then.
+    size_t available = ((head >= tail) ? (head - tail) : ((queue->buf_size - tail) + head)) / queue->elem_size;
+    if (len > available) {
+        len = available;
     }
 
     // Calculate how many elements are available in sequential storage, starting from the tail
@@ -212,3 +223,17 @@ _adi_fifo_Result_e _adi_fifo_ReadN(volatile _adi_fifo_t* queue, void* out_buf, s
     }
     return FIFO_ERR_OK;
 }
+
+_adi_fifo_Result_e _adi_fifo_PopN(volatile _adi_fifo_t* queue, void* out_buf, size_t len, size_t *read)
+{
+    size_t n = 0;
+    _adi_fifo_Result_e ret = _adi_fifo_ReadN(queue, out_buf, len, &n);
+    if (ret == FIFO_ERR_OK) {
+        PUBLISH_FENCE();
+        queue->tail = (queue->tail + n * queue->elem_size) % queue->buf_size;
+        if (read != NULL) {
+            *read = n;
+        }
+    }
+    return ret;
+}
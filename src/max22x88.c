@@ -15,6 +15,7 @@
  */
 
 #include "max22x88.h"
+#include "io_layer_interface.h"
 #include "private/max22x88_internal.h"
 #include <stdlib.h>
 
@@ -46,18 +47,66 @@ static adi_max22x88_Result_e initialize_io_layer(adi_max22x88_t* driver, adi_max
  */
 static adi_max22x88_Result_e deinitialize_io_layer(adi_max22x88_t* driver);
 
+/**
+ * @brief Returns the size of the elements stored in the rx buffer.
+ * 
+ * @param rx_mode rx buffer mode
+ * @return size_t element size, 0 if the mode is invalid
+ */
+static size_t rx_elem_size(adi_max22x88_RxMode_e rx_mode);
+
+/**
+ * @brief Checks that an rx buffer mode is one of adi_max22x88_RxMode_e.
+ * 
+ * @param rx_mode rx buffer mode
+ * @return true if the mode is valid
+ */
+static bool rx_mode_valid(adi_max22x88_RxMode_e rx_mode);
+
+/**
+ * @brief Stores an element in the rx buffer.
+ * 
+ * @param driver driver
+ * @param elem element matching the rx buffer mode
+ * @return adi_max22x88_Result_e 
+ */
+static adi_max22x88_Result_e push_rx(adi_max22x88_t* driver, void* elem);
+
+/**
+ * @brief Reads the next frame that carries data, skipping end of burst markers.
+ * 
+ * @param driver driver
+ * @param frame frame read
+ * @return adi_max22x88_Result_e 
+ */
+static adi_max22x88_Result_e read_data_frame(adi_max22x88_t* driver, adi_max22x88_Frame_t* frame);
+
 adi_max22x88_Result_e adi_max22x88_Init(adi_max22x88_t* driver,
     size_t rx_buffer_len,
     adi_max22x88_Functions_t fns,
     void* user_params)
 {
-    if (driver == NULL || fns.write_fn == NULL || fns.set_rst_state_fn == NULL) {
+    return adi_max22x88_InitRxMode(driver, rx_buffer_len, MAX22X88_RX_MODE_BYTES, fns, user_params);
+}
+
+adi_max22x88_Result_e adi_max22x88_InitRxMode(adi_max22x88_t* driver,
+    size_t rx_buffer_len,
+    adi_max22x88_RxMode_e rx_mode,
+    adi_max22x88_Functions_t fns,
+    void* user_params)
+{
+    if (driver == NULL || fns.write_fn == NULL || fns.set_rst_state_fn == NULL || !rx_mode_valid(rx_mode)) {
         return MAX22X88_ERR_BAD_PARAM;
     }
 
     adi_max22x88_Result_e ret;
 
-    if (_adi_fifo_Init(&driver->rx_queue, rx_buffer_len, sizeof(uint8_t)) != FIFO_ERR_OK) {
+    driver->rx_mode = rx_mode;
+#if MAX22X88_RECORD
+    driver->record_fn = NULL;
+    driver->record_ctx = NULL;
+#endif
+    if (_adi_fifo_Init(&driver->rx_queue, rx_buffer_len, rx_elem_size(rx_mode)) != FIFO_ERR_OK) {
         ret = MAX22X88_ERR_INTERNAL;
         goto err_1;
     }
@@ -132,6 +181,37 @@ adi_max22x88_Result_e adi_max22x88_Transmit(adi_max22x88_t* driver, uint8_t* dat
     return MAX22X88_ERR_OK;
 }
 
+adi_max22x88_Result_e adi_max22x88_TransmitV(adi_max22x88_t* driver, const adi_max22x88_Segment_t* segments, size_t count)
+{
+    if (driver == NULL || segments == NULL || count == 0) {
+        return MAX22X88_ERR_BAD_PARAM;
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (segments[i].data == NULL && segments[i].len != 0) {
+            return MAX22X88_ERR_BAD_PARAM;
+        }
+    }
+
+    adi_max22x88_Result_e err;
+
+    err = adi_max22x88_SetTxState(driver, true);
+    if (err != MAX22X88_ERR_OK) {
+        return err;
+    }
+
+    err = adi_max22x88_WriteV(driver, segments, count);
+    if (err != MAX22X88_ERR_OK) {
+        return err;
+    }
+
+    err = adi_max22x88_SetTxState(driver, false);
+    if (err != MAX22X88_ERR_OK) {
+        return err;
+    }
+
+    return MAX22X88_ERR_OK;
+}
+
 adi_max22x88_Result_e adi_max22x88_Write(adi_max22x88_t* driver, uint8_t* data, size_t len)
 {
     if (!driver->tx_state) {
@@ -141,13 +221,121 @@ adi_max22x88_Result_e adi_max22x88_Write(adi_max22x88_t* driver, uint8_t* data,
     return driver->fns.write_fn(driver, data, len);
 }
 
+adi_max22x88_Result_e adi_max22x88_WriteV(adi_max22x88_t* driver, const adi_max22x88_Segment_t* segments, size_t count)
+{
+    if (!driver->tx_state) {
+        return MAX22X88_ERR_INTERNAL;
+    }
+
+    if (driver->fns.writev_fn != NULL) {
+        return driver->fns.writev_fn(driver, segments, count);
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        if (segments[i].len == 0) {
+            continue;
+        }
+        // casting to uint8_t* to discard `const` qualifier, the IO layer doesn't modify the data
+        adi_max22x88_Result_e err = driver->fns.write_fn(driver, (uint8_t *)segments[i].data, segments[i].len);
+        if (err != MAX22X88_ERR_OK) {
+            return err;
+        }
+    }
+    return MAX22X88_ERR_OK;
+}
+
 adi_max22x88_Result_e adi_max22x88_Read(adi_max22x88_t* driver, uint8_t* data)
 {
-    if (driver == NULL) {
+    if (driver == NULL || data == NULL) {
+        return MAX22X88_ERR_BAD_PARAM;
+    }
+
+    if (driver->rx_mode == MAX22X88_RX_MODE_BYTES) {
+        _adi_fifo_Result_e fifo_result = _adi_fifo_Pop(&driver->rx_queue, data);
+        switch (fifo_result) {
+            case FIFO_ERR_OK:
+                return MAX22X88_ERR_OK;
+                break;
+            case FIFO_ERR_BUFFER_EMPTY:
+                return MAX22X88_ERR_RX_BUFFER_EMPTY;
+                break;
+            default:
+                return MAX22X88_ERR_INTERNAL;
+                break;
+        }
+    }
+
+    adi_max22x88_Frame_t frame;
+    adi_max22x88_Result_e err = read_data_frame(driver, &frame);
+    if (err != MAX22X88_ERR_OK) {
+        return err;
+    }
+    *data = frame.data;
+    return frame.status == MAX22X88_FRAME_OK ? MAX22X88_ERR_OK : MAX22X88_ERR_RX_FRAME;
+}
+
+adi_max22x88_Result_e adi_max22x88_ReadTimestamped(adi_max22x88_t* driver, uint8_t* data, uint32_t* timestamp)
+{
+    if (driver == NULL || data == NULL || timestamp == NULL) {
         return MAX22X88_ERR_BAD_PARAM;
     }
 
-    _adi_fifo_Result_e fifo_result = _adi_fifo_Pop(&driver->rx_queue, data);
+    adi_max22x88_Frame_t frame;
+    adi_max22x88_Result_e err = read_data_frame(driver, &frame);
+    if (err != MAX22X88_ERR_OK) {
+        return err;
+    }
+    *data = frame.data;
+    *timestamp = frame.timestamp;
+    return frame.status == MAX22X88_FRAME_OK ? MAX22X88_ERR_OK : MAX22X88_ERR_RX_FRAME;
+}
+
+adi_max22x88_Result_e adi_max22x88_ReadN(adi_max22x88_t* driver, uint8_t* data, size_t len, size_t* read)
+{
+    if (driver == NULL || data == NULL || len == 0 || read == NULL) {
+        return MAX22X88_ERR_BAD_PARAM;
+    }
+
+    size_t n = 0;
+    if (driver->rx_mode == MAX22X88_RX_MODE_BYTES) {
+        if (_adi_fifo_PopN(&driver->rx_queue, data, len, &n) != FIFO_ERR_OK) {
+            return MAX22X88_ERR_INTERNAL;
+        }
+    } else {
+        adi_max22x88_Frame_t frame;
+        bool stopped_at_frame = false;
+        while (n < len && _adi_fifo_Read(&driver->rx_queue, &frame) == FIFO_ERR_OK) {
+            if (frame.status != MAX22X88_FRAME_OK) {
+                stopped_at_frame = true;
+                break;
+            }
+            data[n++] = frame.data;
+            _adi_fifo_Pop(&driver->rx_queue, NULL);
+        }
+        // Only the frame peeked decides, a valid frame pushed after the buffer was found empty is read next time
+        if (n == 0 && stopped_at_frame) {
+            *read = 0;
+            return MAX22X88_ERR_RX_FRAME;
+        }
+    }
+
+    *read = n;
+    return n == 0 ? MAX22X88_ERR_RX_BUFFER_EMPTY : MAX22X88_ERR_OK;
+}
+
+adi_max22x88_Result_e adi_max22x88_ReadFrame(adi_max22x88_t* driver, adi_max22x88_Frame_t* frame)
+{
+    if (driver == NULL || frame == NULL) {
+        return MAX22X88_ERR_BAD_PARAM;
+    }
+
+    if (driver->rx_mode == MAX22X88_RX_MODE_BYTES) {
+        frame->status = MAX22X88_FRAME_OK;
+        frame->timestamp = 0;
+        return adi_max22x88_Read(driver, &frame->data);
+    }
+
+    _adi_fifo_Result_e fifo_result = _adi_fifo_Pop(&driver->rx_queue, frame);
     switch (fifo_result) {
         case FIFO_ERR_OK:
             return MAX22X88_ERR_OK;
@@ -194,7 +382,129 @@ adi_max22x88_Result_e adi_max22x88_DataReceived(adi_max22x88_t* driver, uint8_t
         return MAX22X88_ERR_BAD_PARAM;
     }
 
-    _adi_fifo_Result_e fifo_result = _adi_fifo_Push(&driver->rx_queue, &data);
+    adi_max22x88_Frame_t frame = {
+        .timestamp = 0,
+        .data = data,
+        .status = MAX22X88_FRAME_OK
+    };
+#if MAX22X88_RECORD
+    if (driver->record_fn != NULL) {
+        driver->record_fn(driver->record_ctx, MAX22X88_RECORD_RX, &frame);
+    }
+#endif
+    if (driver->rx_mode == MAX22X88_RX_MODE_BYTES) {
+        return push_rx(driver, &data);
+    }
+
+    return push_rx(driver, &frame);
+}
+
+adi_max22x88_Result_e adi_max22x88_FrameReceived(adi_max22x88_t* driver, const adi_max22x88_Frame_t* frame)
+{
+    if (driver == NULL || frame == NULL) {
+        return MAX22X88_ERR_BAD_PARAM;
+    }
+
+#if MAX22X88_RECORD
+    if (driver->record_fn != NULL) {
+        driver->record_fn(driver->record_ctx, MAX22X88_RECORD_RX, frame);
+    }
+#endif
+    if (driver->rx_mode != MAX22X88_RX_MODE_FRAMES && frame->status != MAX22X88_FRAME_OK) {
+        return MAX22X88_ERR_OK;
+    }
+
+    if (driver->rx_mode == MAX22X88_RX_MODE_BYTES) {
+        uint8_t data = frame->data;
+        return push_rx(driver, &data);
+    }
+
+    return push_rx(driver, (void *)frame);  // casting to void* to discard `const` qualifier
+}
+
+adi_max22x88_Result_e adi_max22x88_BurstEnded(adi_max22x88_t* driver, uint32_t timestamp)
+{
+    if (driver == NULL) {
+        return MAX22X88_ERR_BAD_PARAM;
+    }
+
+    adi_max22x88_Frame_t frame = {
+        .timestamp = timestamp,
+        .data = 0,
+        .status = MAX22X88_FRAME_END_OF_BURST
+    };
+    return adi_max22x88_FrameReceived(driver, &frame);
+}
+
+#if MAX22X88_RECORD
+adi_max22x88_Result_e adi_max22x88_SetRecorder(adi_max22x88_t* driver, adi_max22x88_Record_fn fn, void* ctx)
+{
+    if (driver == NULL) {
+        return MAX22X88_ERR_BAD_PARAM;
+    }
+
+    driver->record_ctx = ctx;
+    driver->record_fn = fn;
+    return MAX22X88_ERR_OK;
+}
+
+void adi_max22x88_RecordTx(adi_max22x88_t* driver, const adi_max22x88_Segment_t* segments, size_t count)
+{
+    if (driver->record_fn == NULL) {
+        return;
+    }
+
+    adi_max22x88_Frame_t frame = {
+        .timestamp = 0,
+        .status = MAX22X88_FRAME_OK
+    };
+    for (size_t i = 0; i < count; i++) {
+        for (size_t j = 0; j < segments[i].len; j++) {
+            frame.data = segments[i].data[j];
+            driver->record_fn(driver->record_ctx, MAX22X88_RECORD_TX, &frame);
+        }
+    }
+}
+#endif
+
+static adi_max22x88_Result_e read_data_frame(adi_max22x88_t* driver, adi_max22x88_Frame_t* frame)
+{
+    adi_max22x88_Result_e err;
+    do {
+        err = adi_max22x88_ReadFrame(driver, frame);
+    } while (err == MAX22X88_ERR_OK && frame->status == MAX22X88_FRAME_END_OF_BURST);
+    return err;
+}
+
+static bool rx_mode_valid(adi_max22x88_RxMode_e rx_mode)
+{
+    // An uninitialized init params struct can hold any value, the enum's underlying type may be signed
+    switch (rx_mode) {
+        case MAX22X88_RX_MODE_BYTES:
+        case MAX22X88_RX_MODE_FRAMES:
+        case MAX22X88_RX_MODE_TIMESTAMPED:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static size_t rx_elem_size(adi_max22x88_RxMode_e rx_mode)
+{
+    switch (rx_mode) {
+        case MAX22X88_RX_MODE_BYTES:
+            return sizeof(uint8_t);
+        case MAX22X88_RX_MODE_FRAMES:  // fallthrough
+        case MAX22X88_RX_MODE_TIMESTAMPED:
+            return sizeof(adi_max22x88_Frame_t);
+        default:
+            return 0;
+    }
+}
+
+static adi_max22x88_Result_e push_rx(adi_max22x88_t* driver, void* elem)
+{
+    _adi_fifo_Result_e fifo_result = _adi_fifo_Push(&driver->rx_queue, elem);
     switch (fifo_result) {
         case FIFO_ERR_OK:
             return MAX22X88_ERR_OK;
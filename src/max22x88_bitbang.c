@@ -19,13 +19,33 @@
 #include "private/bitbang_helper.h"
 #include "private/max22x88_bitbang_rx_state_machine.h"
 #include "private/max22x88_common.h"
+#include "private/max22x88_edge_decoder.h"
 #include "private/max22x88_internal.h"
-#include <stdlib.h>
 #include <string.h>
 
 #define HOMEBUS_DATA_BITS (8)
 #define BITS_IN_HOMEBUS_FRAME (HOMEBUS_DATA_BITS + 3)  // + 3 for start, parity, stop bits
 #define START_BIT_OFFSET_TICKS (126)
+#define SIGNAL_INTERRUPTS_PER_BIT (4)  // An edge and a sample event for each half of the bit
+#define DMA_TX_WORDS (MAX22X88_BITBANG_DMA_TX_FRAMES * BITS_IN_HOMEBUS_FRAME * 2)  // One word per half-bit
+// Options that keep timestamps whatever the Rx mode
+#define TIMESTAMPS_ALWAYS_KEPT (MAX22X88_RECORD || MAX22X88_BITBANG_TRACE || MAX22X88_BITBANG_CAPTURE_RX)
+
+// Half-bit index of the last bit written to DIN, `tx_current_bit` has already been advanced past it.
+#define LAST_TX_BIT(ctx) (((ctx)->tx_current_bit == 0 ? BITS_IN_HOMEBUS_FRAME * 2 : (ctx)->tx_current_bit) - 1)
+
+#if MAX22X88_BITBANG_TRACE
+#if (MAX22X88_BITBANG_TRACE_LEN & (MAX22X88_BITBANG_TRACE_LEN - 1)) != 0
+#error "MAX22X88_BITBANG_TRACE_LEN must be a power of 2"
+#endif
+#define TRACE(ctx, event, value, index) trace_record(ctx, event, value, index)
+#else
+#define TRACE(ctx, event, value, index) do { } while (0)
+#endif
+
+#if MAX22X88_BITBANG_CAPTURE_RX && (MAX22X88_BITBANG_CAPTURE_EDGES & (MAX22X88_BITBANG_CAPTURE_EDGES - 1)) != 0
+#error "MAX22X88_BITBANG_CAPTURE_EDGES must be a power of 2"
+#endif
 
 typedef enum {
     MAX22X88_BUS_STATE_IDLE,
@@ -35,6 +55,12 @@ typedef enum {
     MAX22X88_BUS_STATE_UNKNOWN,
 } max22x88_bus_state_e;
 
+/** An edge on DOUT stored by the DOUT interrupt in capture mode. */
+typedef struct {
+    uint32_t timestamp;
+    bool level;
+} max22x88_captured_edge_t;
+
 /**
  * Context used for bitbang implementation.
  * 
@@ -47,13 +73,41 @@ typedef struct
     uint32_t cnt_for_start_bit_sample;
     uint32_t half_bit_cmp;
     volatile int error_log[BITBANG_LOG_MAX];
-    volatile uint32_t* data_to_tx;
-    volatile size_t tx_len;
+    const adi_max22x88_Segment_t* tx_segments;
+    size_t tx_segment_cnt;
+    volatile size_t tx_current_segment;
+    volatile size_t tx_segment_offset;
+    volatile uint32_t tx_frame;
+    volatile bool tx_frame_loaded;
     volatile size_t tx_current_byte;
     volatile size_t tx_current_bit;
     volatile max22x88_bus_state_e bus_state;
+    volatile uint32_t rx_timestamp;
+    volatile uint32_t tx_timestamp;
+    bool timestamps;  // The timestamp source is read, timestamps are otherwise 0
+    uint32_t idle_gap_interrupts;
+    volatile uint32_t idle_interrupts;
     bool perform_bit_collation;
     bool last_bit_tx;
+#if MAX22X88_BITBANG_JITTER_STATS
+    volatile adi_max22x88_bitbang_JitterStats_t jitter;
+#endif
+#if MAX22X88_BITBANG_TRACE
+    volatile adi_max22x88_bitbang_TraceRecord_t trace[MAX22X88_BITBANG_TRACE_LEN];
+    volatile uint32_t trace_head;
+#endif
+#if MAX22X88_BITBANG_DMA_TX
+    uint32_t dma_words[DMA_TX_WORDS];
+    uint32_t dma_capture[DMA_TX_WORDS];
+    volatile bool dma_done;
+#endif
+#if MAX22X88_BITBANG_CAPTURE_RX
+    _adi_edge_dec_t edge_dec;
+    volatile max22x88_captured_edge_t capture[MAX22X88_BITBANG_CAPTURE_EDGES];
+    volatile uint32_t capture_head;
+    volatile uint32_t capture_tail;
+    volatile bool capture_overflow;
+#endif
 } max22x88_bitbang_ctx_t;
 
 static adi_max22x88_t* _driver = NULL;
@@ -63,7 +117,7 @@ static adi_max22x88_t* _driver = NULL;
  * 
  * @param driver 
  * @param ctx 
- * @param user_params
+ * @param user_params 
  * @return adi_max22x88_Result_e 
  */
 static adi_max22x88_Result_e max22x88_gpio_bitbang_init(adi_max22x88_t* driver, void* ctx, void* user_params);
@@ -78,6 +132,16 @@ static adi_max22x88_Result_e max22x88_gpio_bitbang_init(adi_max22x88_t* driver,
  */
 static adi_max22x88_Result_e max22x88_write_bitbang(adi_max22x88_t *driver, uint8_t* data, size_t count);
 
+/**
+ * @brief Max32670 implementation (GPIO bitbang) for Max22x88 gather write callback.
+ * 
+ * @param driver 
+ * @param segments 
+ * @param count 
+ * @return adi_max22x88_Result_e 
+ */
+static adi_max22x88_Result_e max22x88_writev_bitbang(adi_max22x88_t *driver, const adi_max22x88_Segment_t* segments, size_t count);
+
 /**
  * @brief The timer interrupt indicating that the next bit should be written (during Tx) or the next bit should be read (during Rx).
  * 
@@ -86,12 +150,30 @@ static void signal_timer_isr(void);
 
 static void max22x88_bitbang_init_ctx(max22x88_bitbang_ctx_t* ctx, adi_max22x88_bitbang_InitParams_t* user_params);
 
+#if MAX22X88_BITBANG_DMA_TX
+/**
+ * @brief Transmits the segments set in the context through the DMA channel. The frames are rendered into words for
+ * DIN, as many as fit in the buffer, and each batch is sent by a single DMA transfer. The CPU only takes the
+ * completion interrupt of each transfer, then compares the DOUT samples captured by the transfer with what was written.
+ * 
+ * @param driver 
+ * @param ctx 
+ */
+static void transmit_dma(adi_max22x88_t* driver, max22x88_bitbang_ctx_t* ctx);
+
+/**
+ * @brief The DMA completion interrupt, called once the last word of a transfer has been written to DIN.
+ * 
+ */
+static void dma_tx_done_isr(void);
+#else
 /**
  * @brief Starts an asynchronous transmission.
  * 
  * @param ctx 
  */
 static void start_transmission(max22x88_bitbang_ctx_t* ctx);
+#endif
 
 /**
  * @brief Configures the timer interrupt according to the desired Home Bus baud rate.
@@ -101,6 +183,7 @@ static void start_transmission(max22x88_bitbang_ctx_t* ctx);
  */
 static int configure_homebus_signal_timer(max22x88_bitbang_ctx_t* ctx);
 
+#if !MAX22X88_BITBANG_DMA_TX
 /**
  * @brief Enables the hbs timer interrupt. Used by rxing and txing routines.
  * 
@@ -108,6 +191,7 @@ static int configure_homebus_signal_timer(max22x88_bitbang_ctx_t* ctx);
  * @param initial_cnt Timer will be loaded with this CNT value.
  */
 static void begin_hbs_timing(max22x88_bitbang_ctx_t* ctx, uint32_t initial_cnt);
+#endif
 
 /**
  * @brief Stops the hbs timer interrupt.
@@ -118,11 +202,36 @@ static void stop_hbs_timing(max22x88_bitbang_ctx_t* ctx);
 
 /**
  * @brief Reconfigures device to listen for another Home Bus packet.
+ * If end of burst detection is enabled, the signal timer keeps running to measure the idle time on the bus.
  * 
  * @param ctx 
  */
 static void restart_rxing(max22x88_bitbang_ctx_t* ctx);
 
+/**
+ * @brief Counts the signal timer interrupts while the bus is idle after a frame, and reports the end of the burst
+ * once the configured idle gap has elapsed.
+ * 
+ * @param driver 
+ * @param ctx 
+ */
+static void max22x88_handle_interrupt_wait(adi_max22x88_t* driver, max22x88_bitbang_ctx_t* ctx);
+
+/**
+ * @brief Stops measuring the idle time on the bus and reports the end of the burst to the driver.
+ * 
+ * @param driver 
+ * @param ctx 
+ */
+static void end_burst(adi_max22x88_t* driver, max22x88_bitbang_ctx_t* ctx);
+
+/**
+ * @brief Reports the end of the burst to the driver.
+ * 
+ * @param driver 
+ */
+static void report_burst_end(adi_max22x88_t* driver);
+
 /**
  * @brief Converts 8 logic values into Home Bus values, by adding start, parity, stop bits and stuffing them with 1s.
  * 
@@ -131,6 +240,15 @@ static void restart_rxing(max22x88_bitbang_ctx_t* ctx);
  */
 static uint32_t format_byte_for_hbs_tx(uint8_t value);
 
+/**
+ * @brief Formats the next byte of the segments being transmitted into `tx_frame`, skipping empty segments.
+ * 
+ * @param ctx 
+ * @retval true a frame was loaded.
+ * @retval false all the data has been transmitted.
+ */
+static bool load_tx_frame(max22x88_bitbang_ctx_t* ctx);
+
 static void max22x88_handle_interrupt_tx(adi_max22x88_t* driver, max22x88_bitbang_ctx_t* ctx, int sample);
 
 /**
@@ -140,6 +258,39 @@ static void max22x88_handle_interrupt_tx(adi_max22x88_t* driver, max22x88_bitban
  */
 static void max22x88_handle_interrupt_rx(adi_max22x88_t* driver, max22x88_bitbang_ctx_t* ctx, int sample);
 
+/**
+ * @brief Stores a received frame in the rx buffer and logs its status.
+ * 
+ * @param driver 
+ * @param ctx 
+ * @param timestamp time of the start bit edge
+ * @param data the data received
+ * @param error_flags adi_max22x88_FrameStatus_e flags
+ */
+static void frame_received(adi_max22x88_t* driver, max22x88_bitbang_ctx_t* ctx, uint32_t timestamp, uint8_t data, uint8_t error_flags);
+
+#if MAX22X88_BITBANG_CAPTURE_RX
+/**
+ * @brief Passes the edges captured so far to the edge decoder, then tells it no other edge happened until a point
+ * in time, and handles the frames and ends of burst it reports.
+ * 
+ * @param driver 
+ * @param ctx 
+ * @param now the time at which the capture ring is read
+ */
+static void process_captured_edges(adi_max22x88_t* driver, max22x88_bitbang_ctx_t* ctx, uint32_t now);
+
+/**
+ * @brief Handles the events reported by the edge decoder.
+ * 
+ * @param driver 
+ * @param ctx 
+ * @param events _adi_edge_dec_Event_e flags
+ * @param result the frame, if EDGE_DEC_FRAME is set
+ */
+static void handle_decoder_events(adi_max22x88_t* driver, max22x88_bitbang_ctx_t* ctx, uint32_t events, const _adi_edge_dec_Result_t* result);
+#endif
+
 static bool max22x88_bitbang_log(adi_max22x88_t* driver, adi_max22x88_bitbang_LogCode_e code);
 
 /**
@@ -153,6 +304,39 @@ static bool max22x88_bitbang_log(adi_max22x88_t* driver, adi_max22x88_bitbang_Lo
  */
 static void handle_collision(adi_max22x88_t* driver, max22x88_bitbang_ctx_t* ctx);
 
+#if MAX22X88_BITBANG_TRACE
+/**
+ * @brief Appends a record to the trace ring, overwriting the oldest one.
+ * @note Only called from interrupt context, or from adi_max22x88_ProcessCaptureBitbang which doesn't run during
+ * transmissions. The DOUT and signal timer interrupts must not preempt each other.
+ * 
+ * @param ctx 
+ * @param event adi_max22x88_bitbang_TraceEvent_e
+ * @param value event specific value
+ * @param index event specific index
+ */
+static inline void trace_record(max22x88_bitbang_ctx_t* ctx, uint8_t event, uint8_t value, uint16_t index)
+{
+    uint32_t head = ctx->trace_head;
+    volatile adi_max22x88_bitbang_TraceRecord_t* record = &ctx->trace[head & (MAX22X88_BITBANG_TRACE_LEN - 1)];
+    record->timestamp = adi_max22x88_hal_TimestampGet();
+    record->event = event;
+    record->value = value;
+    record->index = index;
+    ctx->trace_head = head + 1;
+}
+#endif
+
+#if MAX22X88_BITBANG_JITTER_STATS
+/**
+ * @brief Adds the latency of the current signal timer interrupt to the statistics.
+ * 
+ * @param ctx 
+ * @param latency ticks elapsed since the timer reached its compare value
+ */
+static void record_jitter(max22x88_bitbang_ctx_t* ctx, uint32_t latency);
+#endif
+
 adi_max22x88_Result_e adi_max22x88_FallingEdgeIntCallback(void)
 {
     adi_max22x88_hal_TimerStartSignal();
@@ -161,6 +345,12 @@ adi_max22x88_Result_e adi_max22x88_FallingEdgeIntCallback(void)
         return MAX22X88_ERR_USER_FN;
     }
     max22x88_bitbang_ctx_t* ctx = adi_max22x88_GetLowLevelCtx(_driver);
+    uint32_t timestamp = ctx->timestamps ? adi_max22x88_hal_TimestampGet() : 0;
+    if (ctx->bus_state == MAX22X88_BUS_STATE_WAIT) {
+        // The timer is still running to measure the idle gap, align it with the start bit
+        adi_max22x88_hal_TimerSetCountSignal(ctx->cnt_for_start_bit_sample);
+        adi_max22x88_hal_TimerClearFlagsSignalInterrupt();
+    }
     bool sm_result = _adi_bitbang_sm_EventStartBitEdge(&ctx->rx_sm);
     if (!sm_result) {
         adi_max22x88_hal_TimerStopSignal();
@@ -172,17 +362,73 @@ adi_max22x88_Result_e adi_max22x88_FallingEdgeIntCallback(void)
     // It is reenabled afterwards
     adi_max22x88_hal_GpioIntDisableDout();
 
+    TRACE(ctx, BITBANG_TRACE_START_EDGE, 0, 0);
+    ctx->rx_timestamp = timestamp;
     ctx->bus_state = MAX22X88_BUS_STATE_RX;
     return MAX22X88_ERR_OK;
 }
 
+#if MAX22X88_BITBANG_DMA_TX
+static void transmit_dma(adi_max22x88_t* driver, max22x88_bitbang_ctx_t* ctx)
+{
+    uint32_t word_high = adi_max22x88_hal_DmaWordDin(1);
+    uint32_t word_low = adi_max22x88_hal_DmaWordDin(0);
+    size_t bits_in_frame = BITS_IN_HOMEBUS_FRAME * 2;
+
+    ctx->bus_state = MAX22X88_BUS_STATE_TX;
+    ctx->tx_current_bit = 0;
+    ctx->tx_current_byte = 0;
+    ctx->tx_current_segment = 0;
+    ctx->tx_segment_offset = 0;
+    for (;;) {
+        size_t count = 0;
+        while (count < DMA_TX_WORDS && load_tx_frame(ctx)) {
+            for (size_t bit = 0; bit < bits_in_frame; bit++) {
+                ctx->dma_words[count++] = (ctx->tx_frame & (1 << bit)) ? word_high : word_low;
+            }
+        }
+        if (count == 0) {
+            break;
+        }
+
+        if (ctx->tx_current_byte == 0 && ctx->timestamps) {
+            ctx->tx_timestamp = adi_max22x88_hal_TimestampGet();
+        }
+        ctx->dma_done = false;
+        adi_max22x88_hal_DmaStartDin(ctx->dma_words, ctx->dma_capture, count, ctx->half_bit_cmp * 2, dma_tx_done_isr);
+        while (!ctx->dma_done)
+            ;
+
+        // Readback collation, after the fact
+        for (size_t i = 0; i < count; i++) {
+            bool bit = adi_max22x88_hal_DmaReadDout(ctx->dma_capture[i]) != 0;
+            if (bit != (ctx->dma_words[i] == word_high)) {
+                TRACE(ctx, BITBANG_TRACE_COLLATION_MISMATCH, bit, i % bits_in_frame);
+                handle_collision(driver, ctx);
+            }
+        }
+        ctx->tx_current_byte += count / bits_in_frame;
+    }
+    ctx->bus_state = MAX22X88_BUS_STATE_IDLE;
+}
+
+static void dma_tx_done_isr(void)
+{
+    max22x88_bitbang_ctx_t* ctx = adi_max22x88_GetLowLevelCtx(_driver);
+    ctx->dma_done = true;
+}
+#else
 static void start_transmission(max22x88_bitbang_ctx_t* ctx)
 {
     ctx->bus_state = MAX22X88_BUS_STATE_TX;
     ctx->tx_current_bit = 0;
     ctx->tx_current_byte = 0;
+    ctx->tx_current_segment = 0;
+    ctx->tx_segment_offset = 0;
+    ctx->tx_frame_loaded = load_tx_frame(ctx);
     begin_hbs_timing(ctx, ctx->half_bit_initial_cnt);
 }
+#endif
 
 static int configure_homebus_signal_timer(max22x88_bitbang_ctx_t* ctx)
 {
@@ -202,7 +448,7 @@ static void handle_collision(adi_max22x88_t* driver, max22x88_bitbang_ctx_t* ctx
 
 static void max22x88_handle_interrupt_tx(adi_max22x88_t* driver, max22x88_bitbang_ctx_t* ctx, int sample)
 {
-    if (ctx->tx_current_byte == ctx->tx_len) {
+    if (!ctx->tx_frame_loaded) {
         ctx->bus_state = MAX22X88_BUS_STATE_IDLE;
         return;
     }
@@ -210,24 +456,31 @@ static void max22x88_handle_interrupt_tx(adi_max22x88_t* driver, max22x88_bitban
     if (ctx->perform_bit_collation) {
         bool bit = sample;
         ctx->perform_bit_collation = false;
+        TRACE(ctx, BITBANG_TRACE_DOUT_SAMPLE, bit, LAST_TX_BIT(ctx));
         if (bit != ctx->last_bit_tx) {
+            TRACE(ctx, BITBANG_TRACE_COLLATION_MISMATCH, bit, LAST_TX_BIT(ctx));
             handle_collision(driver, ctx);
         }
     } else {
-        uint32_t data_to_tx = ctx->data_to_tx[ctx->tx_current_byte];
-        bool bit_to_tx = data_to_tx & (1 << ctx->tx_current_bit);
+        bool bit_to_tx = ctx->tx_frame & (1 << ctx->tx_current_bit);
         if (bit_to_tx) {
             adi_max22x88_hal_GpioSetDin();
         } else {
             adi_max22x88_halGpioClearDin();
         }
+        if (ctx->tx_current_byte == 0 && ctx->tx_current_bit == 0 && ctx->timestamps) {
+            ctx->tx_timestamp = adi_max22x88_hal_TimestampGet();
+        }
+        TRACE(ctx, BITBANG_TRACE_DIN_WRITE, bit_to_tx, ctx->tx_current_bit);
         ctx->perform_bit_collation = true;
         ctx->last_bit_tx = bit_to_tx;
         ctx->tx_current_bit++;
         size_t bits_in_frame = BITS_IN_HOMEBUS_FRAME * 2;
         if (ctx->tx_current_bit == bits_in_frame) {
+            // DIN has already been written, so formatting the next byte doesn't delay the edge
             ctx->tx_current_bit = 0;
             ctx->tx_current_byte++;
+            ctx->tx_frame_loaded = load_tx_frame(ctx);
         }
     }
 }
@@ -239,35 +492,11 @@ static void max22x88_handle_interrupt_rx(adi_max22x88_t* driver, max22x88_bitban
     if (_adi_bitbang_sm_WantSample(&ctx->rx_sm)) {
         uint32_t reading = sample;
         _adi_bitbang_sm_Result_t result = { 0 };
+        TRACE(ctx, BITBANG_TRACE_DOUT_SAMPLE, reading != 0, ctx->rx_sm.sampled_total_bit_cnt);
         sm_status = _adi_bitbang_sm_EventSample(&ctx->rx_sm, reading, &finished, &result);
         if (sm_status && finished) {
-            if (result.error_flags == RX_SM_ERROR_NO_ERROR) {
-                adi_max22x88_Result_e err = adi_max22x88_DataReceived(driver, result.data);
-                switch (err) {
-                    case MAX22X88_ERR_OK:
-                        max22x88_bitbang_log(driver, BITBANG_LOG_FRAME_VALID);
-                        break;
-                    case MAX22X88_ERR_RX_BUFFER_FULL:
-                        max22x88_bitbang_log(driver, BITBANG_LOG_RX_OVF);
-                        break;
-                    default:
-                        max22x88_bitbang_log(driver, BITBANG_LOG_INTERNAL_ERROR);
-                }
-            } else {
-                max22x88_bitbang_log(driver, BITBANG_LOG_FRAME_BAD);
-                if (result.error_flags & RX_SM_ERROR_OFFDUTY_SAMPLE) {
-                    max22x88_bitbang_log(driver, BITBANG_LOG_FRAME_BAD_OFFDUTY);
-                }
-                if (result.error_flags & RX_SM_ERROR_PARITY_ERROR) {
-                    max22x88_bitbang_log(driver, BITBANG_LOG_FRAME_BAD_PARITY);
-                }
-                if (result.error_flags & RX_SM_ERROR_START_BIT_SAMPLE) {
-                    max22x88_bitbang_log(driver, BITBANG_LOG_FRAME_BAD_START);
-                }
-                if (result.error_flags & RX_SM_ERROR_STOP_BIT_SAMPLE) {
-                    max22x88_bitbang_log(driver, BITBANG_LOG_FRAME_BAD_STOP);
-                }
-            }
+            // The state machine flags share their values with adi_max22x88_FrameStatus_e
+            frame_received(driver, ctx, ctx->rx_timestamp, result.data, result.error_flags);
             restart_rxing(ctx);
         }
     } else {
@@ -278,15 +507,131 @@ static void max22x88_handle_interrupt_rx(adi_max22x88_t* driver, max22x88_bitban
     }
 }
 
+static void frame_received(adi_max22x88_t* driver, max22x88_bitbang_ctx_t* ctx, uint32_t timestamp, uint8_t data, uint8_t error_flags)
+{
+    TRACE(ctx, BITBANG_TRACE_FRAME_RESULT, data, error_flags);
+    adi_max22x88_Frame_t frame = {
+        .timestamp = timestamp,
+        .data = data,
+        .status = error_flags
+    };
+    adi_max22x88_Result_e err = adi_max22x88_FrameReceived(driver, &frame);
+    switch (err) {
+        case MAX22X88_ERR_OK:
+            if (error_flags == RX_SM_ERROR_NO_ERROR) {
+                max22x88_bitbang_log(driver, BITBANG_LOG_FRAME_VALID);
+            }
+            break;
+        case MAX22X88_ERR_RX_BUFFER_FULL:
+            TRACE(ctx, BITBANG_TRACE_RX_OVF, data, 0);
+            max22x88_bitbang_log(driver, BITBANG_LOG_RX_OVF);
+            break;
+        default:
+            max22x88_bitbang_log(driver, BITBANG_LOG_INTERNAL_ERROR);
+    }
+    if (error_flags != RX_SM_ERROR_NO_ERROR) {
+        max22x88_bitbang_log(driver, BITBANG_LOG_FRAME_BAD);
+        if (error_flags & RX_SM_ERROR_OFFDUTY_SAMPLE) {
+            max22x88_bitbang_log(driver, BITBANG_LOG_FRAME_BAD_OFFDUTY);
+        }
+        if (error_flags & RX_SM_ERROR_PARITY_ERROR) {
+            max22x88_bitbang_log(driver, BITBANG_LOG_FRAME_BAD_PARITY);
+        }
+        if (error_flags & RX_SM_ERROR_START_BIT_SAMPLE) {
+            max22x88_bitbang_log(driver, BITBANG_LOG_FRAME_BAD_START);
+        }
+        if (error_flags & RX_SM_ERROR_STOP_BIT_SAMPLE) {
+            max22x88_bitbang_log(driver, BITBANG_LOG_FRAME_BAD_STOP);
+        }
+    }
+}
+
+#if MAX22X88_BITBANG_CAPTURE_RX
+adi_max22x88_Result_e adi_max22x88_EdgeIntCallback(uint32_t timestamp, int level)
+{
+    if (_driver == NULL) {
+        return MAX22X88_ERR_USER_FN;
+    }
+    max22x88_bitbang_ctx_t* ctx = adi_max22x88_GetLowLevelCtx(_driver);
+    uint32_t head = ctx->capture_head;
+    if (head - ctx->capture_tail >= MAX22X88_BITBANG_CAPTURE_EDGES) {
+        ctx->capture_overflow = true;
+        return MAX22X88_ERR_RX_BUFFER_FULL;
+    }
+    volatile max22x88_captured_edge_t* edge = &ctx->capture[head & (MAX22X88_BITBANG_CAPTURE_EDGES - 1)];
+    edge->timestamp = timestamp;
+    edge->level = level != 0;
+    ctx->capture_head = head + 1;
+    return MAX22X88_ERR_OK;
+}
+
+static void handle_decoder_events(adi_max22x88_t* driver, max22x88_bitbang_ctx_t* ctx, uint32_t events, const _adi_edge_dec_Result_t* result)
+{
+    if (events & EDGE_DEC_FRAME) {
+        // The decoder reports adi_max22x88_FrameStatus_e flags
+        frame_received(driver, ctx, result->timestamp, result->data, result->status);
+    }
+    if (events & EDGE_DEC_END_OF_BURST) {
+        report_burst_end(driver);
+    }
+}
+
+static void process_captured_edges(adi_max22x88_t* driver, max22x88_bitbang_ctx_t* ctx, uint32_t now)
+{
+    _adi_edge_dec_Result_t result;
+    uint32_t events;
+    uint32_t head = ctx->capture_head;
+    if (ctx->capture_overflow) {
+        // The edges in the ring are followed by a gap, none of them can be trusted
+        max22x88_bitbang_log(driver, BITBANG_LOG_CAPTURE_OVF);
+        ctx->capture_tail = head;
+        ctx->capture_overflow = false;
+        if (_adi_edge_dec_Reset(&ctx->edge_dec)) {
+            report_burst_end(driver);
+        }
+        return;
+    }
+
+    while (ctx->capture_tail != head) {
+        volatile max22x88_captured_edge_t* edge = &ctx->capture[ctx->capture_tail & (MAX22X88_BITBANG_CAPTURE_EDGES - 1)];
+        events = _adi_edge_dec_Edge(&ctx->edge_dec, edge->timestamp, edge->level, &result);
+        ctx->capture_tail++;
+        handle_decoder_events(driver, ctx, events, &result);
+    }
+
+    // Leave a half-bit for an edge whose interrupt was still pending when `now` was read
+    events = _adi_edge_dec_Poll(&ctx->edge_dec, now - ctx->edge_dec.half_bit_ticks, &result);
+    handle_decoder_events(driver, ctx, events, &result);
+}
+
+adi_max22x88_Result_e adi_max22x88_ProcessCaptureBitbang(adi_max22x88_t* driver)
+{
+    if (driver == NULL) {
+        return MAX22X88_ERR_BAD_PARAM;
+    }
+
+    max22x88_bitbang_ctx_t* ctx = adi_max22x88_GetLowLevelCtx(driver);
+    // Read the time first, so every edge before it is already in the ring
+    process_captured_edges(driver, ctx, adi_max22x88_hal_TimestampGet());
+    return MAX22X88_ERR_OK;
+}
+#endif
+
 static void signal_timer_isr(void)
 {
     // Sample DOUT preemptively.
     // Depending on why this isr was triggered, the value may be unused.
     // However, if it is used, the reading has to happen at this point in time.
     int sample = adi_max22x88_hal_GpioReadDout();
+#if MAX22X88_BITBANG_JITTER_STATS
+    uint32_t latency = adi_max22x88_hal_TimerGetLatencySignal();
+#endif
 
     max22x88_bitbang_ctx_t* ctx = adi_max22x88_GetLowLevelCtx(_driver);
     adi_max22x88_hal_TimerClearFlagsSignalInterrupt();
+#if MAX22X88_BITBANG_JITTER_STATS
+    record_jitter(ctx, latency);
+#endif
     switch (ctx->bus_state) {
         case MAX22X88_BUS_STATE_TX:
             max22x88_handle_interrupt_tx(_driver, ctx, sample);
@@ -294,8 +639,10 @@ static void signal_timer_isr(void)
         case MAX22X88_BUS_STATE_RX:
             max22x88_handle_interrupt_rx(_driver, ctx, sample);
             break;
+        case MAX22X88_BUS_STATE_WAIT:
+            max22x88_handle_interrupt_wait(_driver, ctx);
+            break;
         case MAX22X88_BUS_STATE_IDLE:  // fallthrough
-        case MAX22X88_BUS_STATE_WAIT:  // fallthrough
         case MAX22X88_BUS_STATE_UNKNOWN:
             // signal_timer_isr is not supposed be called in these bus states
             max22x88_bitbang_log(_driver, BITBANG_LOG_INTERNAL_ERROR);
@@ -303,18 +650,134 @@ static void signal_timer_isr(void)
     }
 }
 
+#if MAX22X88_BITBANG_TRACE
+adi_max22x88_Result_e adi_max22x88_DumpTraceBitbang(adi_max22x88_t* driver, adi_max22x88_bitbang_TraceRecord_t* records, size_t len, size_t* count)
+{
+    if (driver == NULL || records == NULL || count == NULL) {
+        return MAX22X88_ERR_BAD_PARAM;
+    }
+
+    max22x88_bitbang_ctx_t* ctx = adi_max22x88_GetLowLevelCtx(driver);
+    uint32_t head = ctx->trace_head;
+    uint32_t n = head < MAX22X88_BITBANG_TRACE_LEN ? head : MAX22X88_BITBANG_TRACE_LEN;
+    if (n > len) {
+        n = len;
+    }
+    uint32_t first = head - n;
+    for (uint32_t i = 0; i < n; i++) {
+        records[i] = *(adi_max22x88_bitbang_TraceRecord_t *)&ctx->trace[(first + i) & (MAX22X88_BITBANG_TRACE_LEN - 1)];
+    }
+
+    // Drop the records that the interrupts may have overwritten during the copy.
+    // The record being written when `trace_head` is read has overwritten one more slot.
+    uint32_t written = ctx->trace_head - head + 1;
+    uint32_t overwritten = 0;
+    if (written + n > MAX22X88_BITBANG_TRACE_LEN) {
+        overwritten = written + n - MAX22X88_BITBANG_TRACE_LEN;
+        if (overwritten > n) {
+            overwritten = n;
+        }
+        memmove(records, &records[overwritten], (n - overwritten) * sizeof *records);
+    }
+    *count = n - overwritten;
+    return MAX22X88_ERR_OK;
+}
+#endif
+
+#if MAX22X88_BITBANG_JITTER_STATS
+static void record_jitter(max22x88_bitbang_ctx_t* ctx, uint32_t latency)
+{
+    size_t bin = 0;
+    if (latency > 0) {
+        bin = 32 - __builtin_clz(latency);
+        if (bin >= MAX22X88_BITBANG_JITTER_BINS) {
+            bin = MAX22X88_BITBANG_JITTER_BINS - 1;
+        }
+    }
+    ctx->jitter.histogram[bin]++;
+    ctx->jitter.samples++;
+
+    if (latency >= ctx->jitter.worst_ticks) {
+        ctx->jitter.worst_ticks = latency;
+        if (ctx->bus_state == MAX22X88_BUS_STATE_TX) {
+            ctx->jitter.worst_dir = BITBANG_JITTER_DIR_TX;
+            ctx->jitter.worst_bit = ctx->tx_current_bit;
+            ctx->jitter.worst_byte = ctx->tx_current_byte;
+        } else {
+            ctx->jitter.worst_dir = BITBANG_JITTER_DIR_RX;
+            ctx->jitter.worst_bit = ctx->rx_sm.sampled_total_bit_cnt;
+            ctx->jitter.worst_byte = 0;
+        }
+    }
+}
+
+adi_max22x88_Result_e adi_max22x88_GetJitterStatsBitbang(adi_max22x88_t* driver, adi_max22x88_bitbang_JitterStats_t* stats)
+{
+    if (driver == NULL || stats == NULL) {
+        return MAX22X88_ERR_BAD_PARAM;
+    }
+
+    max22x88_bitbang_ctx_t* ctx = adi_max22x88_GetLowLevelCtx(driver);
+    memcpy(stats, (void *)&ctx->jitter, sizeof *stats);  // casting to void* to discard `volatile` qualifier
+    return MAX22X88_ERR_OK;
+}
+
+adi_max22x88_Result_e adi_max22x88_ResetJitterStatsBitbang(adi_max22x88_t* driver)
+{
+    if (driver == NULL) {
+        return MAX22X88_ERR_BAD_PARAM;
+    }
+
+    max22x88_bitbang_ctx_t* ctx = adi_max22x88_GetLowLevelCtx(driver);
+    uint32_t half_bit_ticks = ctx->jitter.half_bit_ticks;
+    memset((void *)&ctx->jitter, 0, sizeof ctx->jitter);
+    ctx->jitter.half_bit_ticks = half_bit_ticks;
+    return MAX22X88_ERR_OK;
+}
+#endif
+
+#if !MAX22X88_BITBANG_DMA_TX
 static void begin_hbs_timing(max22x88_bitbang_ctx_t* ctx, uint32_t initial_cnt)
 {
     adi_max22x88_hal_TimerSetCountSignal(initial_cnt);
     adi_max22x88_hal_TimerStartSignal();
 }
+#endif
 
 static void restart_rxing(max22x88_bitbang_ctx_t* ctx)
 {
-    stop_hbs_timing(ctx);
+    if (ctx->idle_gap_interrupts > 0) {
+        ctx->idle_interrupts = 0;
+        ctx->bus_state = MAX22X88_BUS_STATE_WAIT;
+    } else {
+        stop_hbs_timing(ctx);
+    }
     adi_max22x88_hal_GpioIntEnableDout();
 }
 
+static void max22x88_handle_interrupt_wait(adi_max22x88_t* driver, max22x88_bitbang_ctx_t* ctx)
+{
+    ctx->idle_interrupts++;
+    if (ctx->idle_interrupts >= ctx->idle_gap_interrupts) {
+        end_burst(driver, ctx);
+    }
+}
+
+static void end_burst(adi_max22x88_t* driver, max22x88_bitbang_ctx_t* ctx)
+{
+    stop_hbs_timing(ctx);
+    report_burst_end(driver);
+}
+
+static void report_burst_end(adi_max22x88_t* driver)
+{
+    max22x88_bitbang_ctx_t* ctx = adi_max22x88_GetLowLevelCtx(driver);
+    uint32_t timestamp = ctx->timestamps ? adi_max22x88_hal_TimestampGet() : 0;
+    if (adi_max22x88_BurstEnded(driver, timestamp) == MAX22X88_ERR_RX_BUFFER_FULL) {
+        max22x88_bitbang_log(driver, BITBANG_LOG_RX_OVF);
+    }
+}
+
 static void stop_hbs_timing(max22x88_bitbang_ctx_t* ctx)
 {
     ctx->bus_state = MAX22X88_BUS_STATE_IDLE;
@@ -327,14 +790,20 @@ const adi_max22x88_Functions_t max22x88_bitbang_functions = {
     .init_fn = max22x88_gpio_bitbang_init,
     .ctx_size = sizeof(max22x88_bitbang_ctx_t),
     .set_rst_state_fn = adi_max22x88_SetTxStateGpio,
-    .write_fn = max22x88_write_bitbang
+    .write_fn = max22x88_write_bitbang,
+    .writev_fn = max22x88_writev_bitbang
 };
 
 adi_max22x88_Result_e adi_max22x88_InitBitbang(adi_max22x88_t* driver, adi_max22x88_bitbang_InitParams_t* params, size_t rx_buffer_len)
 {
-    return adi_max22x88_Init(
+    if (params == NULL) {
+        return MAX22X88_ERR_BAD_PARAM;
+    }
+
+    return adi_max22x88_InitRxMode(
         driver,
         rx_buffer_len,
+        params->rx_mode,
         max22x88_bitbang_functions,
         params
     );
@@ -352,10 +821,39 @@ static void max22x88_bitbang_init_ctx(max22x88_bitbang_ctx_t* ctx, adi_max22x88_
 
     ctx->perform_bit_collation = false;
     ctx->last_bit_tx = false;
+    ctx->tx_segments = NULL;
+    ctx->tx_segment_cnt = 0;
+    ctx->tx_frame_loaded = false;
     _adi_bitbang_sm_Init(&ctx->rx_sm);
 
     ctx->bus_state = MAX22X88_BUS_STATE_UNKNOWN;
+    ctx->rx_timestamp = 0;
+    ctx->tx_timestamp = 0;
+    ctx->idle_gap_interrupts = user_params->idle_gap_bits * SIGNAL_INTERRUPTS_PER_BIT;
+    ctx->idle_interrupts = 0;
+    // In MAX22X88_RX_MODE_BYTES the frames are stored without their timestamps, so the counter is only started if
+    // another option keeps them
+    ctx->timestamps = TIMESTAMPS_ALWAYS_KEPT || user_params->rx_mode != MAX22X88_RX_MODE_BYTES;
+    if (ctx->timestamps) {
+        adi_max22x88_hal_TimestampInit();
+    }
+#if MAX22X88_BITBANG_CAPTURE_RX
+    // The edge decoder measures the idle gap itself, the signal timer is only used for Tx
+    uint32_t half_bit_ticks = adi_max22x88_hal_TimestampFrequency() / ctx->baud_rate;
+    _adi_edge_dec_Init(&ctx->edge_dec, half_bit_ticks, user_params->idle_gap_bits * 2 * half_bit_ticks);
+    ctx->idle_gap_interrupts = 0;
+    ctx->capture_head = 0;
+    ctx->capture_tail = 0;
+    ctx->capture_overflow = false;
+#endif
     memset((void *)ctx->error_log, 0, sizeof ctx->error_log);
+#if MAX22X88_BITBANG_TRACE
+    ctx->trace_head = 0;
+#endif
+#if MAX22X88_BITBANG_JITTER_STATS
+    memset((void *)&ctx->jitter, 0, sizeof ctx->jitter);
+    ctx->jitter.half_bit_ticks = ctx->half_bit_cmp;
+#endif
 }
 
 static adi_max22x88_Result_e max22x88_gpio_bitbang_init(adi_max22x88_t* driver, void* ctx, void* user_params)
@@ -364,6 +862,9 @@ static adi_max22x88_Result_e max22x88_gpio_bitbang_init(adi_max22x88_t* driver,
         // The driver has already been initialized. Only one instance is supported.
         return MAX22X88_ERR_BAD_PARAM;
     }
+    if (((adi_max22x88_bitbang_InitParams_t*)user_params)->idle_gap_bits > MAX22X88_IDLE_GAP_BITS_MAX) {
+        return MAX22X88_ERR_BAD_PARAM;
+    }
 
     max22x88_bitbang_init_ctx(ctx, user_params);
 
@@ -377,7 +878,11 @@ static adi_max22x88_Result_e max22x88_gpio_bitbang_init(adi_max22x88_t* driver,
 
     adi_max22x88_hal_GpioConfigureDout();
 
+#if MAX22X88_BITBANG_CAPTURE_RX
+    adi_max22x88_hal_GpioIntConfigureDoutBothEdges();
+#else
     adi_max22x88_hal_GpioIntConfigureDoutFallingEdge();
+#endif
     _driver = driver;
     adi_max22x88_hal_GpioIntEnableDout();
 
@@ -391,42 +896,84 @@ static adi_max22x88_Result_e max22x88_gpio_bitbang_init(adi_max22x88_t* driver,
  * @return uint32_t 
  */
 static uint32_t format_byte_for_hbs_tx(uint8_t value) {
-    bool parity_bit = _calc_even_parity_u8(value);
-    
-    // Add start, parity and stop bits
-    uint16_t prepared_data = value; // requires using a a bigger data type
-    prepared_data |= (parity_bit << 8);  // Add the parity bit after the 8 data bits.
-    prepared_data |= (1 << 9);  // Add stop bit after the parity bit. The stop bit has value 1.
-    prepared_data <<= 1;  // Add start bit before all other bits. The start bit has value 0.
-    uint32_t stuffed_data = _stuff_byte_u32(prepared_data);
-    return stuffed_data;
+    return _format_frame_u32(value);
+}
+
+static bool load_tx_frame(max22x88_bitbang_ctx_t* ctx)
+{
+    while (ctx->tx_current_segment < ctx->tx_segment_cnt) {
+        const adi_max22x88_Segment_t* segment = &ctx->tx_segments[ctx->tx_current_segment];
+        if (ctx->tx_segment_offset < segment->len) {
+            ctx->tx_frame = format_byte_for_hbs_tx(segment->data[ctx->tx_segment_offset++]);
+            return true;
+        }
+        ctx->tx_current_segment++;
+        ctx->tx_segment_offset = 0;
+    }
+    return false;
 }
 
 static adi_max22x88_Result_e max22x88_write_bitbang(adi_max22x88_t *driver, uint8_t* data, size_t count)
+{
+    adi_max22x88_Segment_t segment = {
+        .data = data,
+        .len = count
+    };
+    return max22x88_writev_bitbang(driver, &segment, 1);
+}
+
+static adi_max22x88_Result_e max22x88_writev_bitbang(adi_max22x88_t *driver, const adi_max22x88_Segment_t* segments, size_t count)
 {
     max22x88_bitbang_ctx_t* ctx = adi_max22x88_GetLowLevelCtx(driver);
-    
-    // Prepare data to Tx
-    size_t num_packets_to_tx = sizeof(*data) * count;
-    ctx->data_to_tx = malloc(num_packets_to_tx * sizeof(*(ctx->data_to_tx)));
-    ctx->tx_len = num_packets_to_tx;
-    if (ctx->data_to_tx == NULL) {
-        return MAX22X88_ERR_INTERNAL;
-    }
-    for (size_t i = 0; i < count; i++) {
-        ctx->data_to_tx[i] = format_byte_for_hbs_tx(data[i]);
-    }
+
+    // Bytes are formatted by the signal timer interrupt as they are transmitted
+    ctx->tx_segments = segments;
+    ctx->tx_segment_cnt = count;
 
     adi_max22x88_hal_GpioIntDisableDout();
+    adi_max22x88_hal_TimerStopSignal();
+    if (ctx->bus_state == MAX22X88_BUS_STATE_WAIT) {
+        // Transmitting ends the burst being received
+        end_burst(driver, ctx);
+    }
+#if MAX22X88_BITBANG_CAPTURE_RX
+    // Complete what has been received, a frame being received is dropped. Transmitting ends the burst being received.
+    process_captured_edges(driver, ctx, adi_max22x88_hal_TimestampGet());
+    if (_adi_edge_dec_Reset(&ctx->edge_dec)) {
+        report_burst_end(driver);
+    }
+#endif
+#if MAX22X88_RECORD
+    adi_max22x88_RecordTx(driver, segments, count);
+#endif
+#if MAX22X88_BITBANG_DMA_TX
+    transmit_dma(driver, ctx);
+#else
     start_transmission(ctx);
     while (ctx->bus_state == MAX22X88_BUS_STATE_TX)
         ;
+#endif
     stop_hbs_timing(ctx);
-    free((void *)ctx->data_to_tx);  // casting to void* to discard `volatile` qualifier
+    ctx->tx_segments = NULL;
+    ctx->tx_segment_cnt = 0;
+#if MAX22X88_BITBANG_CAPTURE_RX
+    ctx->capture_tail = ctx->capture_head;
+#endif
     adi_max22x88_hal_GpioIntEnableDout();
     return MAX22X88_ERR_OK;
 }
 
+adi_max22x88_Result_e adi_max22x88_GetTxTimestampBitbang(adi_max22x88_t* driver, uint32_t* timestamp)
+{
+    if (driver == NULL || timestamp == NULL) {
+        return MAX22X88_ERR_BAD_PARAM;
+    }
+
+    max22x88_bitbang_ctx_t* ctx = adi_max22x88_GetLowLevelCtx(driver);
+    *timestamp = ctx->tx_timestamp;
+    return MAX22X88_ERR_OK;
+}
+
 static bool max22x88_bitbang_log(adi_max22x88_t* driver, adi_max22x88_bitbang_LogCode_e code)
 {
     max22x88_bitbang_ctx_t* ctx = adi_max22x88_GetLowLevelCtx(driver);
@@ -20,8 +20,10 @@
 #define BITS_SAMPLED_IN_PACKET (22)
 
 #define START_BIT_POS 0
-#define PARITY_BIT_POS 19
-#define STOP_BIT_POS 21
+// Samples alternate between the on-duty and off-duty half-bits of each bit, the parity and stop bits are read from
+// their on-duty half-bits
+#define PARITY_BIT_POS 18
+#define STOP_BIT_POS 20
 
 void _adi_bitbang_sm_Init(volatile _adi_bitbang_sm_t* sm)
 {
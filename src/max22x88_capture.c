@@ -0,0 +1,266 @@
+/* 
+ * Copyright 2024 Analog Devices, Inc.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "max22x88_capture.h"
+#include "io_layer_interface.h"
+#include <string.h>
+
+#define TAG_KIND_SHIFT (6)
+#define TAG_STATUS_MASK (0x0F)
+#define TAG_RESERVED_MASK (0x30)
+#define VARINT_GROUP_BITS (7)
+#define VARINT_MORE (0x80)
+#define VARINT_MAX_LEN (5)
+
+/**
+ * @brief Writes a 32 bit value in little-endian order.
+ * 
+ * @param buf destination
+ * @param value value
+ */
+static void put_u32_le(uint8_t* buf, uint32_t value)
+{
+    for (int i = 0; i < 4; i++) {
+        buf[i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+/**
+ * @brief Reads a 32 bit value in little-endian order.
+ * 
+ * @param buf source
+ * @return uint32_t 
+ */
+static uint32_t get_u32_le(const uint8_t* buf)
+{
+    return (uint32_t)buf[0] | (uint32_t)buf[1] << 8 | (uint32_t)buf[2] << 16 | (uint32_t)buf[3] << 24;
+}
+
+adi_max22x88_Result_e adi_max22x88_CaptureWriterInit(adi_max22x88_CaptureWriter_t* writer, uint8_t* buf, size_t len, uint32_t tick_hz, adi_max22x88_CaptureClock_fn clock, adi_max22x88_CaptureFlush_fn flush, void* flush_ctx)
+{
+    if (writer == NULL || buf == NULL || len < MAX22X88_CAPTURE_HEADER_LEN + MAX22X88_CAPTURE_RECORD_MAX_LEN) {
+        return MAX22X88_ERR_BAD_PARAM;
+    }
+
+    memcpy(buf, MAX22X88_CAPTURE_MAGIC, 4);
+    buf[4] = MAX22X88_CAPTURE_VERSION;
+    buf[5] = MAX22X88_CAPTURE_HEADER_LEN;
+    buf[6] = 0;
+    buf[7] = 0;
+    put_u32_le(&buf[8], tick_hz);
+
+    writer->buf = buf;
+    writer->len = len;
+    writer->used = MAX22X88_CAPTURE_HEADER_LEN;
+    writer->timestamp = 0;
+    writer->clock = clock;
+    writer->flush = flush;
+    writer->flush_ctx = flush_ctx;
+    writer->records = 0;
+    writer->dropped = 0;
+    return MAX22X88_ERR_OK;
+}
+
+void adi_max22x88_CaptureRecord(void* ctx, adi_max22x88_RecordDir_e dir, const adi_max22x88_Frame_t* frame)
+{
+    adi_max22x88_CaptureWriter_t* writer = ctx;
+    if (writer == NULL || frame == NULL) {
+        return;
+    }
+
+    if (writer->used + MAX22X88_CAPTURE_RECORD_MAX_LEN > writer->len) {
+        if (adi_max22x88_CaptureWriterFlush(writer) != MAX22X88_ERR_OK || writer->used + MAX22X88_CAPTURE_RECORD_MAX_LEN > writer->len) {
+            writer->dropped++;
+            return;
+        }
+    }
+
+    uint32_t timestamp = frame->timestamp;
+    if (timestamp == 0) {
+        timestamp = writer->clock != NULL ? writer->clock() : writer->timestamp;
+    }
+    uint32_t delta = timestamp - writer->timestamp;
+    if (writer->records > 0 && (int32_t)delta < 0) {
+        // Out of order, such as a frame timestamped at its start bit but recorded after a later event
+        delta = 0;
+        timestamp = writer->timestamp;
+    }
+
+    adi_max22x88_CaptureKind_e kind = MAX22X88_CAPTURE_KIND_RX;
+    if (dir == MAX22X88_RECORD_TX) {
+        kind = MAX22X88_CAPTURE_KIND_TX;
+    } else if (frame->status & MAX22X88_FRAME_END_OF_BURST) {
+        kind = MAX22X88_CAPTURE_KIND_END_OF_BURST;
+    }
+
+    uint8_t* p = &writer->buf[writer->used];
+    *p++ = (uint8_t)(kind << TAG_KIND_SHIFT) | (frame->status & TAG_STATUS_MASK);
+    while (delta >= VARINT_MORE) {
+        *p++ = (uint8_t)(delta | VARINT_MORE);
+        delta >>= VARINT_GROUP_BITS;
+    }
+    *p++ = (uint8_t)delta;
+    if (kind != MAX22X88_CAPTURE_KIND_END_OF_BURST) {
+        *p++ = frame->data;
+    }
+    writer->used = (size_t)(p - writer->buf);
+    writer->timestamp = timestamp;
+    writer->records++;
+}
+
+adi_max22x88_Result_e adi_max22x88_CaptureWriterFlush(adi_max22x88_CaptureWriter_t* writer)
+{
+    if (writer == NULL) {
+        return MAX22X88_ERR_BAD_PARAM;
+    }
+
+    if (writer->flush == NULL || writer->used == 0) {
+        return MAX22X88_ERR_OK;
+    }
+    if (!writer->flush(writer->flush_ctx, writer->buf, writer->used)) {
+        return MAX22X88_ERR_USER_FN;
+    }
+    writer->used = 0;
+    return MAX22X88_ERR_OK;
+}
+
+adi_max22x88_Result_e adi_max22x88_CaptureReaderInit(adi_max22x88_CaptureReader_t* reader, const uint8_t* buf, size_t len)
+{
+    if (reader == NULL || buf == NULL || len < MAX22X88_CAPTURE_HEADER_LEN) {
+        return MAX22X88_ERR_BAD_PARAM;
+    }
+    // Later versions may only lengthen the header
+    if (memcmp(buf, MAX22X88_CAPTURE_MAGIC, 4) != 0 || buf[4] != MAX22X88_CAPTURE_VERSION
+        || buf[5] < MAX22X88_CAPTURE_HEADER_LEN || buf[5] > len) {
+        return MAX22X88_ERR_BAD_PARAM;
+    }
+
+    reader->buf = buf;
+    reader->len = len;
+    reader->tick_hz = get_u32_le(&buf[8]);
+    return adi_max22x88_CaptureRewind(reader);
+}
+
+adi_max22x88_Result_e adi_max22x88_CaptureRewind(adi_max22x88_CaptureReader_t* reader)
+{
+    if (reader == NULL) {
+        return MAX22X88_ERR_BAD_PARAM;
+    }
+
+    reader->pos = reader->buf[5];
+    reader->timestamp = 0;
+    reader->elapsed = 0;
+    reader->started = false;
+    return MAX22X88_ERR_OK;
+}
+
+adi_max22x88_Result_e adi_max22x88_CaptureNext(adi_max22x88_CaptureReader_t* reader, adi_max22x88_CaptureRecord_t* record)
+{
+    if (reader == NULL || record == NULL) {
+        return MAX22X88_ERR_BAD_PARAM;
+    }
+
+    const uint8_t* p = &reader->buf[reader->pos];
+    const uint8_t* end = &reader->buf[reader->len];
+    if (p == end) {
+        return MAX22X88_ERR_RX_BUFFER_EMPTY;
+    }
+    uint8_t tag = *p++;
+    adi_max22x88_CaptureKind_e kind = (adi_max22x88_CaptureKind_e)(tag >> TAG_KIND_SHIFT);
+    if (kind > MAX22X88_CAPTURE_KIND_END_OF_BURST || (tag & TAG_RESERVED_MASK) != 0) {
+        return MAX22X88_ERR_RX_FRAME;
+    }
+
+    uint32_t delta = 0;
+    for (int i = 0; ; i++) {
+        if (p == end) {
+            return MAX22X88_ERR_RX_BUFFER_EMPTY;
+        }
+        if (i == VARINT_MAX_LEN) {
+            return MAX22X88_ERR_RX_FRAME;
+        }
+        uint8_t group = *p++;
+        delta |= (uint32_t)(group & ~VARINT_MORE) << (VARINT_GROUP_BITS * i);
+        if (!(group & VARINT_MORE)) {
+            break;
+        }
+    }
+
+    uint8_t data = 0;
+    if (kind != MAX22X88_CAPTURE_KIND_END_OF_BURST) {
+        if (p == end) {
+            return MAX22X88_ERR_RX_BUFFER_EMPTY;
+        }
+        data = *p++;
+    }
+
+    if (reader->started) {
+        reader->elapsed += delta;
+    }
+    reader->started = true;
+    reader->timestamp += delta;
+    reader->pos = (size_t)(p - reader->buf);
+
+    record->kind = kind;
+    record->frame.timestamp = reader->timestamp;
+    record->frame.data = data;
+    record->frame.status = tag & TAG_STATUS_MASK;
+    if (kind == MAX22X88_CAPTURE_KIND_END_OF_BURST) {
+        record->frame.status |= MAX22X88_FRAME_END_OF_BURST;
+    }
+    record->elapsed = reader->elapsed;
+    return MAX22X88_ERR_OK;
+}
+
+adi_max22x88_Result_e adi_max22x88_CaptureReplay(adi_max22x88_CaptureReader_t* reader, adi_max22x88_t* driver, uint64_t until, size_t* fed)
+{
+    if (reader == NULL || driver == NULL) {
+        return MAX22X88_ERR_BAD_PARAM;
+    }
+
+    size_t count = 0;
+    adi_max22x88_Result_e err;
+    for (;;) {
+        // The reader only moves on once the record has been passed to the driver
+        adi_max22x88_CaptureReader_t next = *reader;
+        adi_max22x88_CaptureRecord_t record;
+        err = adi_max22x88_CaptureNext(&next, &record);
+        if (err != MAX22X88_ERR_OK) {
+            break;
+        }
+        if (record.elapsed > until) {
+            break;
+        }
+        if (record.kind != MAX22X88_CAPTURE_KIND_TX) {
+            if (_adi_fifo_is_Full(&driver->rx_queue)) {
+                err = MAX22X88_ERR_RX_BUFFER_FULL;
+                break;
+            }
+            err = adi_max22x88_FrameReceived(driver, &record.frame);
+            if (err != MAX22X88_ERR_OK) {
+                break;
+            }
+            count++;
+        }
+        *reader = next;
+    }
+
+    if (fed != NULL) {
+        *fed = count;
+    }
+    return err;
+}
@@ -0,0 +1,189 @@
+/* 
+ * Copyright 2024 Analog Devices, Inc.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "private/max22x88_edge_decoder.h"
+#include "private/bitbang_helper.h"
+
+#define HALF_BITS_IN_HOMEBUS_FRAME (22)
+#define TICKS_SINCE(now, tick) ((int32_t)((now) - (tick)))
+
+/**
+ * @brief Returns the time of the middle of a half-bit of the current frame.
+ * 
+ * @param dec 
+ * @param index the half-bit index
+ * @return uint32_t 
+ */
+static uint32_t half_bit_center(const _adi_edge_dec_t* dec, uint32_t index)
+{
+    return dec->anchor + (index - dec->anchor_index) * dec->half_bit_ticks + dec->half_bit_ticks / 2;
+}
+
+/**
+ * @brief Samples the current level for the next half-bit.
+ * 
+ * @param dec 
+ * @param result the frame, if it has been completed
+ * @return uint32_t _adi_edge_dec_Event_e flags
+ */
+static uint32_t sample_half_bit(_adi_edge_dec_t* dec, _adi_edge_dec_Result_t* result)
+{
+    if (dec->level) {
+        if (dec->next_half_bit == 0) {
+            // DOUT went back "high" before the middle of the start bit, the edge was a glitch
+            dec->in_frame = false;
+            return EDGE_DEC_NONE;
+        }
+        dec->half_bits |= 1u << dec->next_half_bit;
+    }
+    dec->next_half_bit++;
+    if (dec->next_half_bit < HALF_BITS_IN_HOMEBUS_FRAME) {
+        return EDGE_DEC_NONE;
+    }
+
+    dec->in_frame = false;
+    dec->frame_end = half_bit_center(dec, HALF_BITS_IN_HOMEBUS_FRAME - 1) + dec->half_bit_ticks / 2;
+    dec->burst_open = dec->idle_gap_ticks > 0;
+    result->timestamp = dec->frame_start;
+    result->status = _parse_frame_u32(dec->half_bits, &result->data);
+    return EDGE_DEC_FRAME;
+}
+
+/**
+ * @brief Samples the current level for every half-bit whose middle is before a point in time.
+ * 
+ * @param dec 
+ * @param until the point in time
+ * @param result the frame, if it has been completed
+ * @return uint32_t _adi_edge_dec_Event_e flags
+ */
+static uint32_t sample_until(_adi_edge_dec_t* dec, uint32_t until, _adi_edge_dec_Result_t* result)
+{
+    uint32_t events = EDGE_DEC_NONE;
+    while (dec->in_frame && events == EDGE_DEC_NONE && TICKS_SINCE(until, half_bit_center(dec, dec->next_half_bit)) > 0) {
+        events = sample_half_bit(dec, result);
+    }
+    return events;
+}
+
+/**
+ * @brief Reports the end of the burst if DOUT has been idle long enough since the last frame.
+ * 
+ * @param dec 
+ * @param now 
+ * @return uint32_t _adi_edge_dec_Event_e flags
+ */
+static uint32_t check_idle_gap(_adi_edge_dec_t* dec, uint32_t now)
+{
+    if (!dec->in_frame && dec->burst_open && TICKS_SINCE(now, dec->frame_end) >= (int32_t)dec->idle_gap_ticks) {
+        dec->burst_open = false;
+        return EDGE_DEC_END_OF_BURST;
+    }
+    return EDGE_DEC_NONE;
+}
+
+/**
+ * @brief Realigns the frame on an edge detected while it is being received.
+ * Falling edges only happen at the start of on-duty half-bits (even indexes) and rising edges at the start of off-duty
+ * ones (odd indexes). If the edge is close enough to such a boundary, the half-bits sampled on the wrong side of it
+ * are fixed and the following ones are sampled relative to the edge, so the baud rate error doesn't add up.
+ * A falling edge past the end of the frame completes it, and is then the start bit of the next one.
+ * 
+ * @param dec 
+ * @param timestamp time of the edge
+ * @param level the level after the edge
+ * @param result the frame, if it has been completed
+ * @return uint32_t _adi_edge_dec_Event_e flags
+ */
+static uint32_t edge_in_frame(_adi_edge_dec_t* dec, uint32_t timestamp, bool level, _adi_edge_dec_Result_t* result)
+{
+    uint32_t elapsed = timestamp - dec->anchor;
+    uint32_t index = dec->anchor_index + elapsed / dec->half_bit_ticks;
+    if (((index & 1) == 0) == level) {
+        index++;
+    }
+    if (!level && dec->next_half_bit == HALF_BITS_IN_HOMEBUS_FRAME - 1) {
+        // Only the last off-duty half-bit is left, this is the start bit of the next frame coming from a faster sender
+        index = HALF_BITS_IN_HOMEBUS_FRAME;
+    }
+    int32_t offset = (int32_t)(elapsed - (index - dec->anchor_index) * dec->half_bit_ticks);
+    if (index < HALF_BITS_IN_HOMEBUS_FRAME && (offset > (int32_t)dec->tolerance_ticks || -offset > (int32_t)dec->tolerance_ticks)) {
+        // Too far from any boundary, most likely a glitch
+        return EDGE_DEC_NONE;
+    }
+
+    uint32_t events = EDGE_DEC_NONE;
+    while (dec->in_frame && dec->next_half_bit < index) {
+        // The edge came early, the half-bits before it still had the previous level
+        events |= sample_half_bit(dec, result);
+    }
+    if (!dec->in_frame) {
+        return events;
+    }
+    for (uint32_t i = index; i < dec->next_half_bit; i++) {
+        // The edge came late, the half-bits after it already have the new level
+        dec->half_bits = level ? (dec->half_bits | (1u << i)) : (dec->half_bits & ~(1u << i));
+    }
+    dec->anchor = timestamp;
+    dec->anchor_index = index;
+    return events;
+}
+
+void _adi_edge_dec_Init(_adi_edge_dec_t* dec, uint32_t half_bit_ticks, uint32_t idle_gap_ticks)
+{
+    dec->half_bit_ticks = half_bit_ticks;
+    dec->tolerance_ticks = half_bit_ticks * 5 / 8;
+    dec->idle_gap_ticks = idle_gap_ticks;
+    dec->burst_open = false;
+    dec->frame_end = 0;
+    _adi_edge_dec_Reset(dec);
+}
+
+bool _adi_edge_dec_Reset(_adi_edge_dec_t* dec)
+{
+    bool burst_open = dec->burst_open;
+    dec->level = true;
+    dec->in_frame = false;
+    dec->burst_open = false;
+    return burst_open;
+}
+
+uint32_t _adi_edge_dec_Edge(_adi_edge_dec_t* dec, uint32_t timestamp, bool level, _adi_edge_dec_Result_t* result)
+{
+    uint32_t events = sample_until(dec, timestamp, result);
+    if (dec->in_frame) {
+        events |= edge_in_frame(dec, timestamp, level, result);
+    }
+    dec->level = level;
+    if (dec->in_frame || level) {
+        return events;
+    }
+
+    events |= check_idle_gap(dec, timestamp);
+    dec->in_frame = true;
+    dec->frame_start = timestamp;
+    dec->anchor = timestamp;
+    dec->anchor_index = 0;
+    dec->next_half_bit = 0;
+    dec->half_bits = 0;
+    return events;
+}
+
+uint32_t _adi_edge_dec_Poll(_adi_edge_dec_t* dec, uint32_t now, _adi_edge_dec_Result_t* result)
+{
+    uint32_t events = sample_until(dec, now, result);
+    return events | check_idle_gap(dec, now);
+}
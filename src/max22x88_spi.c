@@ -0,0 +1,365 @@
+/* 
+ * Copyright 2024 Analog Devices, Inc.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "max22x88_spi.h"
+#include "spi_hal.h"
+#include "private/bitbang_helper.h"
+#include "private/max22x88_common.h"
+#include "private/max22x88_internal.h"
+
+#define HALF_BITS_IN_HOMEBUS_FRAME (22)  // Start, 8 data, parity and stop bits, each followed by an off-duty half-bit
+#define MAX_ENCODED_FRAME_LEN ((HALF_BITS_IN_HOMEBUS_FRAME * MAX22X88_SPI_OVERSAMPLING_MAX + 7) / 8)
+#define TX_CHUNK_LEN (128)
+
+/**
+ * Writes a bitstream MSB-first into a byte buffer.
+ * 
+ */
+typedef struct {
+    uint64_t acc;
+    uint32_t bits;  // Bits in `acc` not written to `out` yet, always fewer than 8 between calls
+    uint8_t* out;
+    size_t len;
+} spi_bit_writer_t;
+
+/**
+ * Context used for SPI implementation.
+ * 
+ */
+typedef struct
+{
+    uint32_t oversampling;
+    uint32_t expansion[16];  // 4 half-bits, first one in bit 0, to the SPI bits sending them, first one in the MSB
+    uint8_t tx_chunk[TX_CHUNK_LEN];
+    bool rx_in_frame;
+    uint32_t rx_half_bit;
+    uint32_t rx_window_samples;
+    uint32_t rx_window_ones;
+    uint32_t rx_half_bits;
+    bool rx_burst_open;
+    uint32_t idle_gap_samples;
+    uint32_t idle_samples;
+} max22x88_spi_ctx_t;
+
+static adi_max22x88_t* _driver = NULL;
+
+/**
+ * @brief SPI implementation for Max22x88 init callback.
+ * 
+ * @param driver 
+ * @param ctx 
+ * @param user_params 
+ * @return adi_max22x88_Result_e 
+ */
+static adi_max22x88_Result_e max22x88_spi_init(adi_max22x88_t* driver, void* ctx, void* user_params);
+
+/**
+ * @brief SPI implementation for Max22x88 write callback.
+ * 
+ * @param driver 
+ * @param data 
+ * @param count 
+ * @return adi_max22x88_Result_e 
+ */
+static adi_max22x88_Result_e max22x88_write_spi(adi_max22x88_t *driver, uint8_t* data, size_t count);
+
+/**
+ * @brief SPI implementation for Max22x88 gather write callback.
+ * The frames are encoded into a chunk buffer, which is queued on MOSI each time it fills up.
+ * 
+ * @param driver 
+ * @param segments 
+ * @param count 
+ * @return adi_max22x88_Result_e 
+ */
+static adi_max22x88_Result_e max22x88_writev_spi(adi_max22x88_t *driver, const adi_max22x88_Segment_t* segments, size_t count);
+
+/**
+ * @brief Called with each block captured from MISO. Decodes the frames it contains.
+ * 
+ * @param data samples of DOUT, MSB-first
+ * @param len length of data
+ */
+static void spi_rx_isr(const uint8_t* data, size_t len);
+
+/**
+ * @brief Fills the table expanding 4 half-bits into the SPI bits sending them.
+ * 
+ * @param ctx 
+ */
+static void init_expansion(max22x88_spi_ctx_t* ctx);
+
+/**
+ * @brief Appends the SPI bits sending a frame to the bitstream.
+ * 
+ * @param ctx 
+ * @param writer the bitstream
+ * @param value the byte to send
+ */
+static void encode_frame(const max22x88_spi_ctx_t* ctx, spi_bit_writer_t* writer, uint8_t value);
+
+/**
+ * @brief Resets the decoder to look for a start bit.
+ * 
+ * @param ctx 
+ */
+static void reset_rx(max22x88_spi_ctx_t* ctx);
+
+/**
+ * @brief Decodes a block of DOUT samples, continuing from the state left by the previous block.
+ * 
+ * @param driver 
+ * @param ctx 
+ * @param data samples of DOUT, MSB-first
+ * @param len length of data
+ */
+static void decode_block(adi_max22x88_t* driver, max22x88_spi_ctx_t* ctx, const uint8_t* data, size_t len);
+
+/**
+ * @brief Checks the half-bits of a complete frame and stores it in the driver's rx buffer.
+ * 
+ * @param driver 
+ * @param half_bits the half-bits voted, first one in bit 0
+ */
+static void frame_decoded(adi_max22x88_t* driver, uint32_t half_bits);
+
+static inline void put_bits(spi_bit_writer_t* writer, uint32_t value, uint32_t count)
+{
+    writer->acc = (writer->acc << count) | value;
+    writer->bits += count;
+    while (writer->bits >= 8) {
+        writer->bits -= 8;
+        writer->out[writer->len++] = (uint8_t)(writer->acc >> writer->bits);
+    }
+}
+
+static void init_expansion(max22x88_spi_ctx_t* ctx)
+{
+    uint32_t osr = ctx->oversampling;
+    uint32_t ones = (1u << osr) - 1;
+    for (uint32_t nibble = 0; nibble < 16; nibble++) {
+        uint32_t bits = 0;
+        for (uint32_t i = 0; i < 4; i++) {
+            if (nibble & (1u << i)) {
+                bits |= ones << ((3 - i) * osr);
+            }
+        }
+        ctx->expansion[nibble] = bits;
+    }
+}
+
+static void encode_frame(const max22x88_spi_ctx_t* ctx, spi_bit_writer_t* writer, uint8_t value)
+{
+    uint32_t osr = ctx->oversampling;
+    uint32_t half_bits = _format_frame_u32(value);
+    for (uint32_t i = 0; i < 20; i += 4) {
+        put_bits(writer, ctx->expansion[(half_bits >> i) & 0xF], 4 * osr);
+    }
+    // The last 2 half-bits only use the first half of their expansion
+    put_bits(writer, ctx->expansion[(half_bits >> 20) & 0x3] >> (2 * osr), 2 * osr);
+}
+
+static void reset_rx(max22x88_spi_ctx_t* ctx)
+{
+    ctx->rx_in_frame = false;
+    ctx->rx_burst_open = false;
+    ctx->idle_samples = 0;
+}
+
+static void frame_decoded(adi_max22x88_t* driver, uint32_t half_bits)
+{
+    adi_max22x88_Frame_t frame = {
+        .timestamp = 0
+    };
+    frame.status = _parse_frame_u32(half_bits, &frame.data);
+    adi_max22x88_FrameReceived(driver, &frame);
+}
+
+static void decode_block(adi_max22x88_t* driver, max22x88_spi_ctx_t* ctx, const uint8_t* data, size_t len)
+{
+    uint32_t osr = ctx->oversampling;
+    for (size_t i = 0; i < len; i++) {
+        uint32_t byte = data[i];
+        uint32_t left = 8;  // Samples of `byte` not consumed yet, the next one is bit `left - 1`
+        while (left != 0) {
+            if (!ctx->rx_in_frame) {
+                // Skip the idle samples up to the falling edge of the next start bit
+                uint32_t low = ~byte & ((1u << left) - 1);
+                uint32_t skipped = low == 0 ? left : left - 1 - (31 - __builtin_clz(low));
+                if (ctx->rx_burst_open) {
+                    ctx->idle_samples += skipped;
+                    if (ctx->idle_samples >= ctx->idle_gap_samples) {
+                        ctx->rx_burst_open = false;
+                        adi_max22x88_BurstEnded(driver, 0);
+                    }
+                }
+                left -= skipped;
+                if (left == 0) {
+                    break;
+                }
+                ctx->rx_in_frame = true;
+                ctx->rx_half_bit = 0;
+                ctx->rx_window_samples = 0;
+                ctx->rx_window_ones = 0;
+                ctx->rx_half_bits = 0;
+            }
+
+            // Count the "high" samples up to the end of the current half-bit.
+            // Only the first half of the last one is sampled, so the next start bit edge is found even if the
+            // windows lag behind the bus by a few samples.
+            uint32_t window = ctx->rx_half_bit == HALF_BITS_IN_HOMEBUS_FRAME - 1 ? osr / 2 : osr;
+            uint32_t take = window - ctx->rx_window_samples;
+            if (take > left) {
+                take = left;
+            }
+            left -= take;
+            ctx->rx_window_ones += __builtin_popcount((byte >> left) & ((1u << take) - 1));
+            ctx->rx_window_samples += take;
+            if (ctx->rx_window_samples < window) {
+                continue;
+            }
+
+            // Majority vote, a tie reads as "low"
+            if (ctx->rx_window_ones * 2 > window) {
+                if (ctx->rx_half_bit == 0) {
+                    // The edge was a glitch, not a start bit
+                    ctx->rx_in_frame = false;
+                    continue;
+                }
+                ctx->rx_half_bits |= 1u << ctx->rx_half_bit;
+            }
+            ctx->rx_window_samples = 0;
+            ctx->rx_window_ones = 0;
+            ctx->rx_half_bit++;
+            if (ctx->rx_half_bit == HALF_BITS_IN_HOMEBUS_FRAME) {
+                frame_decoded(driver, ctx->rx_half_bits);
+                ctx->rx_in_frame = false;
+                ctx->rx_burst_open = ctx->idle_gap_samples > 0;
+                ctx->idle_samples = 0;
+            }
+        }
+    }
+}
+
+static void spi_rx_isr(const uint8_t* data, size_t len)
+{
+    if (_driver == NULL) {
+        return;
+    }
+    decode_block(_driver, adi_max22x88_GetLowLevelCtx(_driver), data, len);
+}
+
+const adi_max22x88_Functions_t max22x88_spi_functions = {
+    .init_fn = max22x88_spi_init,
+    .ctx_size = sizeof(max22x88_spi_ctx_t),
+    .set_rst_state_fn = adi_max22x88_SetTxStateGpio,
+    .write_fn = max22x88_write_spi,
+    .writev_fn = max22x88_writev_spi
+};
+
+adi_max22x88_Result_e adi_max22x88_InitSpi(adi_max22x88_t* driver, adi_max22x88_spi_InitParams_t* params, size_t rx_buffer_len)
+{
+    if (params == NULL) {
+        return MAX22X88_ERR_BAD_PARAM;
+    }
+
+    return adi_max22x88_InitRxMode(
+        driver,
+        rx_buffer_len,
+        params->rx_mode,
+        max22x88_spi_functions,
+        params
+    );
+}
+
+static adi_max22x88_Result_e max22x88_spi_init(adi_max22x88_t* driver, void* ctx, void* user_params)
+{
+    if (_driver != NULL || user_params == NULL) {
+        // The driver has already been initialized. Only one instance is supported.
+        return MAX22X88_ERR_BAD_PARAM;
+    }
+
+    adi_max22x88_spi_InitParams_t* params = user_params;
+    max22x88_spi_ctx_t* spi_ctx = ctx;
+    if (params->hbs_baud == 0 ||
+        params->oversampling < MAX22X88_SPI_OVERSAMPLING_MIN ||
+        params->oversampling > MAX22X88_SPI_OVERSAMPLING_MAX ||
+        params->idle_gap_bits > MAX22X88_IDLE_GAP_BITS_MAX) {
+        return MAX22X88_ERR_BAD_PARAM;
+    }
+    spi_ctx->oversampling = params->oversampling;
+    spi_ctx->idle_gap_samples = params->idle_gap_bits * 2 * params->oversampling;
+    init_expansion(spi_ctx);
+    reset_rx(spi_ctx);
+
+    adi_max22x88_hal_GpioSetRst();
+    adi_max22x88_hal_GpioConfigureRst();
+
+    adi_max22x88_hal_SpiInit(params->hbs_baud * 2 * params->oversampling);
+    adi_max22x88_hal_SpiSetRxCallback(spi_rx_isr);
+    _driver = driver;
+    adi_max22x88_hal_SpiStartRx();
+
+    return MAX22X88_ERR_OK;
+}
+
+static adi_max22x88_Result_e max22x88_write_spi(adi_max22x88_t *driver, uint8_t* data, size_t count)
+{
+    adi_max22x88_Segment_t segment = {
+        .data = data,
+        .len = count
+    };
+    return max22x88_writev_spi(driver, &segment, 1);
+}
+
+static adi_max22x88_Result_e max22x88_writev_spi(adi_max22x88_t *driver, const adi_max22x88_Segment_t* segments, size_t count)
+{
+    max22x88_spi_ctx_t* ctx = adi_max22x88_GetLowLevelCtx(driver);
+    spi_bit_writer_t writer = {
+        .acc = 0,
+        .bits = 0,
+        .out = ctx->tx_chunk,
+        .len = 0
+    };
+
+    // Like the bitbang implementation, nothing is received while transmitting.
+    // The transceiver loops the transmitted frames back to DOUT, they are not captured.
+    adi_max22x88_hal_SpiStopRx();
+#if MAX22X88_RECORD
+    adi_max22x88_RecordTx(driver, segments, count);
+#endif
+    for (size_t i = 0; i < count; i++) {
+        for (size_t j = 0; j < segments[i].len; j++) {
+            encode_frame(ctx, &writer, segments[i].data[j]);
+            if (writer.len > TX_CHUNK_LEN - MAX_ENCODED_FRAME_LEN) {
+                adi_max22x88_hal_SpiWrite(ctx->tx_chunk, writer.len);
+                writer.len = 0;
+            }
+        }
+    }
+    if (writer.bits != 0) {
+        // Complete the last byte with idle "high" bits
+        uint32_t pad = 8 - writer.bits;
+        put_bits(&writer, (1u << pad) - 1, pad);
+    }
+    if (writer.len != 0) {
+        adi_max22x88_hal_SpiWrite(ctx->tx_chunk, writer.len);
+    }
+    adi_max22x88_hal_SpiWaitTxDone();
+    reset_rx(ctx);
+    adi_max22x88_hal_SpiStartRx();
+    return MAX22X88_ERR_OK;
+}
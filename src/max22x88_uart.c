@@ -0,0 +1,176 @@
+/* 
+ * Copyright 2024 Analog Devices, Inc.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "max22x88_uart.h"
+#include "uart_hal.h"
+#include "private/max22x88_common.h"
+#include "private/max22x88_internal.h"
+
+/**
+ * Context used for UART implementation.
+ * 
+ */
+typedef struct
+{
+    uint32_t baud_rate;
+    volatile uint32_t rx_overrun_cnt;
+} max22x88_uart_ctx_t;
+
+static adi_max22x88_t* _driver = NULL;
+
+/**
+ * @brief UART implementation for Max22x88 init callback.
+ * 
+ * @param driver 
+ * @param ctx 
+ * @param user_params 
+ * @return adi_max22x88_Result_e 
+ */
+static adi_max22x88_Result_e max22x88_uart_init(adi_max22x88_t* driver, void* ctx, void* user_params);
+
+/**
+ * @brief UART implementation for Max22x88 write callback.
+ * 
+ * @param driver 
+ * @param data 
+ * @param count 
+ * @return adi_max22x88_Result_e 
+ */
+static adi_max22x88_Result_e max22x88_write_uart(adi_max22x88_t *driver, uint8_t* data, size_t count);
+
+/**
+ * @brief UART implementation for Max22x88 gather write callback.
+ * The segments are queued one after the other, so the UART transmits them back to back.
+ * 
+ * @param driver 
+ * @param segments 
+ * @param count 
+ * @return adi_max22x88_Result_e 
+ */
+static adi_max22x88_Result_e max22x88_writev_uart(adi_max22x88_t *driver, const adi_max22x88_Segment_t* segments, size_t count);
+
+/**
+ * @brief The UART Rx interrupt. Moves the content of the Rx FIFO to the driver's rx buffer.
+ * 
+ */
+static void uart_rx_isr(void);
+
+static void uart_rx_isr(void)
+{
+    if (_driver == NULL) {
+        adi_max22x88_hal_UartFlushRx();
+        return;
+    }
+    max22x88_uart_ctx_t* ctx = adi_max22x88_GetLowLevelCtx(_driver);
+
+    uint8_t data;
+    uint8_t errors;
+    while (adi_max22x88_hal_UartRead(&data, &errors)) {
+        adi_max22x88_Frame_t frame = {
+            .timestamp = 0,
+            .data = data,
+            .status = MAX22X88_FRAME_OK
+        };
+        if (errors & MAX22X88_HAL_UART_ERR_PARITY) {
+            frame.status |= MAX22X88_FRAME_ERR_PARITY;
+        }
+        if (errors & MAX22X88_HAL_UART_ERR_FRAMING) {
+            frame.status |= MAX22X88_FRAME_ERR_STOP;
+        }
+        if (errors & MAX22X88_HAL_UART_ERR_OVERRUN) {
+            ctx->rx_overrun_cnt++;
+        }
+        adi_max22x88_FrameReceived(_driver, &frame);
+    }
+}
+
+const adi_max22x88_Functions_t max22x88_uart_functions = {
+    .init_fn = max22x88_uart_init,
+    .ctx_size = sizeof(max22x88_uart_ctx_t),
+    .set_rst_state_fn = adi_max22x88_SetTxStateGpio,
+    .write_fn = max22x88_write_uart,
+    .writev_fn = max22x88_writev_uart
+};
+
+adi_max22x88_Result_e adi_max22x88_InitUart(adi_max22x88_t* driver, adi_max22x88_uart_InitParams_t* params, size_t rx_buffer_len)
+{
+    if (params == NULL) {
+        return MAX22X88_ERR_BAD_PARAM;
+    }
+
+    return adi_max22x88_InitRxMode(
+        driver,
+        rx_buffer_len,
+        params->rx_mode,
+        max22x88_uart_functions,
+        params
+    );
+}
+
+static adi_max22x88_Result_e max22x88_uart_init(adi_max22x88_t* driver, void* ctx, void* user_params)
+{
+    if (_driver != NULL || user_params == NULL) {
+        // The driver has already been initialized. Only one instance is supported.
+        return MAX22X88_ERR_BAD_PARAM;
+    }
+
+    adi_max22x88_uart_InitParams_t* params = user_params;
+    max22x88_uart_ctx_t* uart_ctx = ctx;
+    if (params->hbs_baud == 0) {
+        return MAX22X88_ERR_BAD_PARAM;
+    }
+    uart_ctx->baud_rate = params->hbs_baud;
+    uart_ctx->rx_overrun_cnt = 0;
+
+    adi_max22x88_hal_GpioSetRst();
+    adi_max22x88_hal_GpioConfigureRst();
+
+    adi_max22x88_hal_UartInit(uart_ctx->baud_rate);
+    adi_max22x88_hal_UartSetRxCallback(uart_rx_isr);
+    adi_max22x88_hal_UartFlushRx();
+    _driver = driver;
+    adi_max22x88_hal_UartIntEnableRx();
+
+    return MAX22X88_ERR_OK;
+}
+
+static adi_max22x88_Result_e max22x88_write_uart(adi_max22x88_t *driver, uint8_t* data, size_t count)
+{
+    adi_max22x88_Segment_t segment = {
+        .data = data,
+        .len = count
+    };
+    return max22x88_writev_uart(driver, &segment, 1);
+}
+
+static adi_max22x88_Result_e max22x88_writev_uart(adi_max22x88_t *driver, const adi_max22x88_Segment_t* segments, size_t count)
+{
+    // Like the bitbang implementation, nothing is received while transmitting.
+    // The transceiver loops the transmitted frames back to DOUT, they are dropped from the Rx FIFO.
+    adi_max22x88_hal_UartIntDisableRx();
+#if MAX22X88_RECORD
+    adi_max22x88_RecordTx(driver, segments, count);
+#endif
+    for (size_t i = 0; i < count; i++) {
+        if (segments[i].len != 0) {
+            adi_max22x88_hal_UartWrite(segments[i].data, segments[i].len);
+        }
+    }
+    adi_max22x88_hal_UartWaitTxDone();
+    adi_max22x88_hal_UartFlushRx();
+    adi_max22x88_hal_UartIntEnableRx();
+    return MAX22X88_ERR_OK;
+}
@@ -0,0 +1,230 @@
+/* 
+ * Copyright 2024 Analog Devices, Inc.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "host_hal.h"
+#include "bitbang_hal.h"
+
+/**
+ * Emulated GPIOs and signal timer. Time only passes in adi_max22x88_hal_HostTimerAdvance, which calls the signal
+ * timer interrupt from the calling thread. The timer and the timestamp counter share one clock. The transceiver
+ * loops DIN back to DOUT, and another node can pull the bus low with adi_max22x88_hal_HostGpioSetBus.
+ * 
+ */
+static struct {
+    uint32_t clock;
+    bool din;
+    bool bus;
+    bool dout_both_edges;
+    bool dout_int_enabled;
+    void (*dout_isr)(void);
+    unsigned long dout_int_cnt;
+    uint32_t timer_cmp;
+    uint32_t timer_cnt;
+    bool timer_running;
+    bool timer_int_enabled;
+    void (*timer_isr)(void);
+    unsigned long timer_int_cnt;
+} bitbang = {
+    .din = true,
+    .bus = true,
+    .timer_cnt = 1,
+};
+
+static bool dout_level(void)
+{
+    return bitbang.din && bitbang.bus;
+}
+
+// Calls the DOUT interrupt if DOUT changed in the direction it is configured for
+static void dout_changed(bool before)
+{
+    bool after = dout_level();
+    if (after == before || !bitbang.dout_int_enabled || bitbang.dout_isr == NULL) {
+        return;
+    }
+    if (!after || bitbang.dout_both_edges) {
+        bitbang.dout_int_cnt++;
+        bitbang.dout_isr();
+    }
+}
+
+void adi_max22x88_hal_HostGpioSetDoutCallback(void (*fn)(void))
+{
+    bitbang.dout_isr = fn;
+}
+
+void adi_max22x88_hal_HostGpioSetBus(int level)
+{
+    bool before = dout_level();
+    bitbang.bus = level != 0;
+    dout_changed(before);
+}
+
+int adi_max22x88_hal_HostGpioGetDin(void)
+{
+    return bitbang.din;
+}
+
+unsigned long adi_max22x88_hal_HostGpioIntCount(void)
+{
+    return bitbang.dout_int_cnt;
+}
+
+void adi_max22x88_hal_HostTimerAdvance(uint32_t ticks)
+{
+    while (ticks != 0) {
+        if (bitbang.timer_running) {
+            // In continuous mode the count is reloaded to 1 on the tick after it reaches the compare value
+            uint32_t to_reload = bitbang.timer_cnt >= bitbang.timer_cmp ? 1 : bitbang.timer_cmp - bitbang.timer_cnt + 1;
+            if (to_reload <= ticks) {
+                bitbang.clock += to_reload;
+                ticks -= to_reload;
+                bitbang.timer_cnt = 1;
+                if (bitbang.timer_int_enabled && bitbang.timer_isr != NULL) {
+                    bitbang.timer_int_cnt++;
+                    bitbang.timer_isr();
+                }
+                continue;
+            }
+            bitbang.timer_cnt += ticks;
+        }
+        bitbang.clock += ticks;
+        ticks = 0;
+    }
+}
+
+unsigned long adi_max22x88_hal_HostTimerIntCount(void)
+{
+    return bitbang.timer_int_cnt;
+}
+
+void adi_max22x88_hal_GpioConfigureDin(void)
+{
+}
+
+void adi_max22x88_hal_GpioSetDin(void)
+{
+    bool before = dout_level();
+    bitbang.din = true;
+    dout_changed(before);
+}
+
+void adi_max22x88_halGpioClearDin(void)
+{
+    bool before = dout_level();
+    bitbang.din = false;
+    dout_changed(before);
+}
+
+void adi_max22x88_hal_GpioConfigureDout(void)
+{
+}
+
+int adi_max22x88_hal_GpioReadDout(void)
+{
+    return dout_level();
+}
+
+void adi_max22x88_hal_GpioIntConfigureDoutFallingEdge(void)
+{
+    bitbang.dout_both_edges = false;
+}
+
+void adi_max22x88_hal_GpioIntConfigureDoutBothEdges(void)
+{
+    bitbang.dout_both_edges = true;
+}
+
+void adi_max22x88_hal_GpioIntEnableDout(void)
+{
+    bitbang.dout_int_enabled = true;
+}
+
+void adi_max22x88_hal_GpioIntDisableDout(void)
+{
+    bitbang.dout_int_enabled = false;
+}
+
+void adi_max22x88_hal_TimerInitSignal(uint32_t cmp)
+{
+    bitbang.timer_cmp = cmp;
+    bitbang.timer_cnt = 1;
+    bitbang.timer_running = false;
+}
+
+void adi_max22x88_hal_TimerStartSignal(void)
+{
+    bitbang.timer_running = true;
+}
+
+void adi_max22x88_hal_TimerStopSignal(void)
+{
+    bitbang.timer_running = false;
+}
+
+void adi_max22x88_hal_TimerShutdowSignal(void)
+{
+    bitbang.timer_running = false;
+    bitbang.timer_int_enabled = false;
+}
+
+void adi_max22x88_hal_TimerSetCountSignal(uint32_t cnt)
+{
+    bitbang.timer_cnt = cnt;
+}
+
+uint32_t adi_max22x88_hal_TimerGetLatencySignal(void)
+{
+    // The interrupt is taken as soon as the count is reloaded
+    return bitbang.timer_cnt - 1;
+}
+
+void adi_max22x88_hal_TimerIntEnableSignal(void)
+{
+    bitbang.timer_int_enabled = true;
+}
+
+void adi_max22x88_hal_TimerClearFlagsSignalInterrupt(void)
+{
+}
+
+uint32_t adi_max22x88_hal_TimerCalcPeriodSignal(uint32_t baud_rate)
+{
+    return HOST_BITBANG_CLOCK_HZ / baud_rate;
+}
+
+void adi_max22x88_hal_NvicSetVectorSignal(void (*fn)(void))
+{
+    bitbang.timer_isr = fn;
+}
+
+void adi_max22x88_hal_NvicEnableSignal(void)
+{
+}
+
+void adi_max22x88_hal_TimestampInit(void)
+{
+}
+
+uint32_t adi_max22x88_hal_TimestampGet(void)
+{
+    return bitbang.clock;
+}
+
+uint32_t adi_max22x88_hal_TimestampFrequency(void)
+{
+    return HOST_BITBANG_CLOCK_HZ;
+}
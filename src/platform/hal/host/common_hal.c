@@ -0,0 +1,40 @@
+/* 
+ * Copyright 2024 Analog Devices, Inc.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "host_hal.h"
+#include "common_hal.h"
+
+// There is no RST pin on a host, its state is only recorded
+static volatile bool rst_state = true;
+
+void adi_max22x88_hal_GpioConfigureRst(void)
+{
+}
+
+void adi_max22x88_hal_GpioSetRst(void)
+{
+    rst_state = true;
+}
+
+void adi_max22x88_hal_GpioClearRst(void)
+{
+    rst_state = false;
+}
+
+bool adi_max22x88_hal_HostGetRst(void)
+{
+    return rst_state;
+}
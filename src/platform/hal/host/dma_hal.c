@@ -0,0 +1,90 @@
+/* 
+ * Copyright 2024 Analog Devices, Inc.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "host_hal.h"
+#include "bitbang_hal.h"
+#include <stdint.h>
+
+/**
+ * Emulated DMA channel writing DIN. A transfer is replayed against a simulated bus as soon as it is started, and the
+ * completion callback is called before adi_max22x88_hal_DmaStartDin returns. The transceiver loops DIN back to DOUT,
+ * unless another node pulls the bus low.
+ * 
+ */
+static struct {
+    uint8_t* din_trace;
+    size_t din_trace_len;
+    size_t din_cnt;
+    size_t collision_index;
+    unsigned long completion_cnt;
+} dma = {
+    .collision_index = SIZE_MAX,
+};
+
+void adi_max22x88_hal_HostDmaSetDinTrace(uint8_t* levels, size_t len)
+{
+    dma.din_trace = levels;
+    dma.din_trace_len = levels == NULL ? 0 : len;
+    dma.din_cnt = 0;
+    dma.collision_index = SIZE_MAX;
+}
+
+size_t adi_max22x88_hal_HostDmaDinCount(void)
+{
+    return dma.din_cnt;
+}
+
+void adi_max22x88_hal_HostDmaForceDoutLow(size_t index)
+{
+    dma.collision_index = index;
+}
+
+unsigned long adi_max22x88_hal_HostDmaCompletionCount(void)
+{
+    return dma.completion_cnt;
+}
+
+uint32_t adi_max22x88_hal_DmaWordDin(int level)
+{
+    return level ? 1 : 0;
+}
+
+int adi_max22x88_hal_DmaReadDout(uint32_t word)
+{
+    return word & 1;
+}
+
+void adi_max22x88_hal_DmaStartDin(const uint32_t* words, uint32_t* capture, size_t count, uint32_t period, void (*fn)(void))
+{
+    for (size_t i = 0; i < count; i++) {
+        uint32_t level = words[i] & 1;
+        if (dma.din_cnt < dma.din_trace_len) {
+            dma.din_trace[dma.din_cnt] = (uint8_t)level;
+        }
+        if (capture != NULL) {
+            capture[i] = dma.din_cnt == dma.collision_index ? 0 : level;
+        }
+        dma.din_cnt++;
+    }
+    dma.completion_cnt++;
+    if (fn != NULL) {
+        fn();
+    }
+}
+
+void adi_max22x88_hal_DmaStopDin(void)
+{
+}
@@ -0,0 +1,186 @@
+/* 
+ * Copyright 2024 Analog Devices, Inc.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file host_hal.h
+ * Host (POSIX) HAL implementation, used to run the driver in simulation.
+ */
+
+#ifndef HOST_HAL_H
+#define HOST_HAL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/** Clock of the emulated signal timer and timestamp counter of the bitbang HAL, in Hz. */
+#define HOST_BITBANG_CLOCK_HZ (16000000)
+
+/**
+ * @brief Makes the UART HAL use a file descriptor, such as a serial port or the slave side of a pseudo-terminal.
+ * Must be called before adi_max22x88_hal_UartInit. The file descriptor is closed by adi_max22x88_hal_UartShutdown.
+ * 
+ * @param fd file descriptor
+ * @return int 0 on success, -1 otherwise
+ */
+int adi_max22x88_hal_HostUartAttach(int fd);
+
+/**
+ * @brief Opens a pseudo-terminal pair and attaches its slave side to the UART HAL.
+ * The master side plays the rest of the bus: bytes written to it are received by the driver, and bytes transmitted
+ * by the driver can be read from it.
+ * 
+ * @param[out] peer_fd master side of the pair, closed by the caller
+ * @return int 0 on success, -1 otherwise
+ */
+int adi_max22x88_hal_HostUartOpenPty(int* peer_fd);
+
+/**
+ * @brief Returns the number of times the Rx callback has been called, i.e. the Rx interrupts a target would take.
+ * 
+ * @return unsigned long interrupt count
+ */
+unsigned long adi_max22x88_hal_HostUartRxIntCount(void);
+
+/**
+ * @brief Sets the buffer receiving the data shifted out on MOSI by the SPI HAL, and resets its count.
+ * Data that doesn't fit is dropped.
+ * 
+ * @param buf the buffer, or NULL to drop all the data
+ * @param len length of buf
+ */
+void adi_max22x88_hal_HostSpiSetTxBuffer(uint8_t* buf, size_t len);
+
+/**
+ * @brief Returns the number of bytes shifted out on MOSI since adi_max22x88_hal_HostSpiSetTxBuffer, dropped ones
+ * included.
+ * 
+ * @return size_t byte count
+ */
+size_t adi_max22x88_hal_HostSpiTxCount(void);
+
+/**
+ * @brief Plays data captured from MISO. While the capture is started, the data is passed to the Rx callback in
+ * blocks, from the calling thread.
+ * 
+ * @param data samples of DOUT, MSB-first
+ * @param len length of data
+ * @return size_t number of bytes passed to the Rx callback, 0 if the capture is stopped
+ */
+size_t adi_max22x88_hal_HostSpiFeedRx(const uint8_t* data, size_t len);
+
+/**
+ * @brief Returns the number of blocks passed to the Rx callback, i.e. the DMA interrupts a target would take.
+ * 
+ * @return unsigned long block count
+ */
+unsigned long adi_max22x88_hal_HostSpiRxBlockCount(void);
+
+/**
+ * @brief Returns the bit rate the SPI HAL was initialized with.
+ * 
+ * @return uint32_t bit rate in bits per second
+ */
+uint32_t adi_max22x88_hal_HostSpiBitRate(void);
+
+/**
+ * @brief Sets the buffer recording the DIN level of each word replayed by the DMA HAL, one byte per word, and resets
+ * the simulated bus. Levels that don't fit are dropped.
+ * 
+ * @param levels the buffer, or NULL to not record the levels
+ * @param len length of levels
+ */
+void adi_max22x88_hal_HostDmaSetDinTrace(uint8_t* levels, size_t len);
+
+/**
+ * @brief Returns the number of words replayed by the DMA HAL since adi_max22x88_hal_HostDmaSetDinTrace, dropped
+ * ones included.
+ * 
+ * @return size_t word count
+ */
+size_t adi_max22x88_hal_HostDmaDinCount(void);
+
+/**
+ * @brief Makes another node pull the simulated bus low during one word, as in a collision. DOUT reads low during
+ * that word whatever DIN is.
+ * 
+ * @param index index of the word, counted like adi_max22x88_hal_HostDmaDinCount, or SIZE_MAX for no collision
+ */
+void adi_max22x88_hal_HostDmaForceDoutLow(size_t index);
+
+/**
+ * @brief Returns the number of DMA transfers completed, i.e. the completion interrupts a target would take.
+ * 
+ * @return unsigned long transfer count
+ */
+unsigned long adi_max22x88_hal_HostDmaCompletionCount(void);
+
+/**
+ * @brief Sets the function called by the DOUT interrupt, as the GPIO interrupt handler of a target would be. It
+ * calls adi_max22x88_FallingEdgeIntCallback or adi_max22x88_EdgeIntCallback, depending on the bitbang options.
+ * 
+ * @param fn the DOUT interrupt handler
+ */
+void adi_max22x88_hal_HostGpioSetDoutCallback(void (*fn)(void));
+
+/**
+ * @brief Sets the level another node drives the simulated bus to. DOUT is low while the bus or DIN is low, and the
+ * DOUT interrupt is called from this function if DOUT changes.
+ * 
+ * @param level 0 to pull the bus low, otherwise released
+ */
+void adi_max22x88_hal_HostGpioSetBus(int level);
+
+/**
+ * @brief Returns the level of DIN.
+ * 
+ * @return int 0 if DIN is low
+ */
+int adi_max22x88_hal_HostGpioGetDin(void);
+
+/**
+ * @brief Returns the number of times the DOUT interrupt handler has been called.
+ * 
+ * @return unsigned long interrupt count
+ */
+unsigned long adi_max22x88_hal_HostGpioIntCount(void);
+
+/**
+ * @brief Lets time pass for the signal timer and the timestamp counter of the bitbang HAL. The signal timer
+ * interrupt is called from this function each time the timer reaches its compare value. Transmitting with the
+ * signal timer waits for its interrupts, so the bitbang layer can only transmit on the host with
+ * MAX22X88_BITBANG_DMA_TX.
+ * 
+ * @param ticks ticks of HOST_BITBANG_CLOCK_HZ
+ */
+void adi_max22x88_hal_HostTimerAdvance(uint32_t ticks);
+
+/**
+ * @brief Returns the number of times the signal timer interrupt has been called.
+ * 
+ * @return unsigned long interrupt count
+ */
+unsigned long adi_max22x88_hal_HostTimerIntCount(void);
+
+/**
+ * @brief Returns the last state written to the RST GPIO.
+ * 
+ * @retval true RST is high
+ * @retval false RST is low
+ */
+bool adi_max22x88_hal_HostGetRst(void);
+
+#endif
@@ -0,0 +1,111 @@
+/* 
+ * Copyright 2024 Analog Devices, Inc.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "host_hal.h"
+#include "spi_hal.h"
+#include <string.h>
+
+#define HOST_SPI_RX_BLOCK_LEN (64)
+
+/**
+ * Emulated SPI controller, backed by memory buffers. MOSI is appended to the Tx buffer, and MISO is played with
+ * adi_max22x88_hal_HostSpiFeedRx. Not thread safe: the data must be fed from the thread using the driver.
+ * 
+ */
+static struct {
+    uint32_t bit_rate;
+    uint8_t* tx_buf;
+    size_t tx_len;
+    size_t tx_cnt;
+    bool rx_started;
+    void (*rx_cb)(const uint8_t* data, size_t len);
+    unsigned long rx_block_cnt;
+} spi;
+
+void adi_max22x88_hal_HostSpiSetTxBuffer(uint8_t* buf, size_t len)
+{
+    spi.tx_buf = buf;
+    spi.tx_len = buf == NULL ? 0 : len;
+    spi.tx_cnt = 0;
+}
+
+size_t adi_max22x88_hal_HostSpiTxCount(void)
+{
+    return spi.tx_cnt;
+}
+
+size_t adi_max22x88_hal_HostSpiFeedRx(const uint8_t* data, size_t len)
+{
+    size_t fed = 0;
+    while (fed < len && spi.rx_started && spi.rx_cb != NULL) {
+        size_t block = len - fed < HOST_SPI_RX_BLOCK_LEN ? len - fed : HOST_SPI_RX_BLOCK_LEN;
+        spi.rx_block_cnt++;
+        spi.rx_cb(&data[fed], block);
+        fed += block;
+    }
+    return fed;
+}
+
+unsigned long adi_max22x88_hal_HostSpiRxBlockCount(void)
+{
+    return spi.rx_block_cnt;
+}
+
+uint32_t adi_max22x88_hal_HostSpiBitRate(void)
+{
+    return spi.bit_rate;
+}
+
+void adi_max22x88_hal_SpiInit(uint32_t bit_rate)
+{
+    spi.bit_rate = bit_rate;
+    spi.rx_started = false;
+    spi.rx_block_cnt = 0;
+}
+
+void adi_max22x88_hal_SpiShutdown(void)
+{
+    spi.rx_started = false;
+    spi.rx_cb = NULL;
+}
+
+void adi_max22x88_hal_SpiWrite(const uint8_t* data, size_t len)
+{
+    if (spi.tx_cnt < spi.tx_len) {
+        size_t room = spi.tx_len - spi.tx_cnt;
+        memcpy(&spi.tx_buf[spi.tx_cnt], data, len < room ? len : room);
+    }
+    spi.tx_cnt += len;
+}
+
+void adi_max22x88_hal_SpiWaitTxDone(void)
+{
+}
+
+void adi_max22x88_hal_SpiSetRxCallback(void (*fn)(const uint8_t* data, size_t len))
+{
+    spi.rx_cb = fn;
+}
+
+void adi_max22x88_hal_SpiStartRx(void)
+{
+    spi.rx_started = true;
+}
+
+void adi_max22x88_hal_SpiStopRx(void)
+{
+    spi.rx_started = false;
+}
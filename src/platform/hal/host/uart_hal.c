@@ -0,0 +1,297 @@
+/* 
+ * Copyright 2024 Analog Devices, Inc.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define _DEFAULT_SOURCE
+
+#include "host_hal.h"
+#include "uart_hal.h"
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <pty.h>
+#include <termios.h>
+#include <unistd.h>
+
+#define HOST_UART_RX_FIFO_LEN (64)
+
+/**
+ * Emulated UART. A thread plays the Rx interrupt: it moves the bytes read from the file descriptor to the Rx FIFO
+ * and calls the Rx callback while the interrupt is enabled.
+ * 
+ */
+static struct {
+    int fd;
+    int wake_fds[2];
+    pthread_t rx_thread;
+    bool rx_thread_started;
+    volatile bool stop;
+    pthread_mutex_t fifo_lock;
+    pthread_mutex_t isr_lock;  // Held while the Rx callback runs, so disabling the interrupt waits for it to return
+    uint8_t fifo[HOST_UART_RX_FIFO_LEN];
+    size_t fifo_head;
+    size_t fifo_cnt;
+    bool overrun;
+    bool int_enabled;
+    void (*rx_cb)(void);
+    unsigned long rx_int_cnt;
+} uart = {
+    .fd = -1,
+    .wake_fds = { -1, -1 },
+    .fifo_lock = PTHREAD_MUTEX_INITIALIZER,
+    .isr_lock = PTHREAD_MUTEX_INITIALIZER,
+};
+
+static speed_t to_speed(uint32_t baud_rate)
+{
+    switch (baud_rate) {
+    case 1200: return B1200;
+    case 2400: return B2400;
+    case 4800: return B4800;
+    case 9600: return B9600;
+    case 19200: return B19200;
+    case 38400: return B38400;
+    case 57600: return B57600;
+    case 115200: return B115200;
+    case 230400: return B230400;
+    default: return B0;
+    }
+}
+
+static void wake_rx_thread(void)
+{
+    uint8_t token = 0;
+    ssize_t ret = write(uart.wake_fds[1], &token, 1);
+    (void)ret;  // A full pipe already wakes the thread
+}
+
+static void push_rx(const uint8_t* data, size_t len)
+{
+    pthread_mutex_lock(&uart.fifo_lock);
+    for (size_t i = 0; i < len; i++) {
+        if (uart.fifo_cnt == HOST_UART_RX_FIFO_LEN) {
+            uart.overrun = true;
+            continue;
+        }
+        uart.fifo[(uart.fifo_head + uart.fifo_cnt) % HOST_UART_RX_FIFO_LEN] = data[i];
+        uart.fifo_cnt++;
+    }
+    pthread_mutex_unlock(&uart.fifo_lock);
+}
+
+static size_t rx_fifo_count(void)
+{
+    pthread_mutex_lock(&uart.fifo_lock);
+    size_t cnt = uart.fifo_cnt;
+    pthread_mutex_unlock(&uart.fifo_lock);
+    return cnt;
+}
+
+static void raise_rx_int(void)
+{
+    pthread_mutex_lock(&uart.isr_lock);
+    size_t cnt = rx_fifo_count();
+    while (cnt != 0 && uart.int_enabled && uart.rx_cb != NULL) {
+        uart.rx_int_cnt++;
+        uart.rx_cb();
+        size_t left = rx_fifo_count();
+        if (left >= cnt) {
+            // The callback didn't read anything, wait for more data instead of spinning
+            break;
+        }
+        cnt = left;
+    }
+    pthread_mutex_unlock(&uart.isr_lock);
+}
+
+static void* rx_thread(void* arg)
+{
+    bool hung_up = false;
+    while (!uart.stop) {
+        struct pollfd fds[2] = {
+            { .fd = hung_up ? -1 : uart.fd, .events = POLLIN },
+            { .fd = uart.wake_fds[0], .events = POLLIN },
+        };
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        if (fds[1].revents & POLLIN) {
+            uint8_t tokens[16];
+            ssize_t ret = read(uart.wake_fds[0], tokens, sizeof tokens);
+            (void)ret;
+        }
+        if (fds[0].revents & POLLIN) {
+            uint8_t buf[HOST_UART_RX_FIFO_LEN];
+            ssize_t n = read(uart.fd, buf, sizeof buf);
+            if (n > 0) {
+                push_rx(buf, (size_t)n);
+            } else if (n == 0 || (errno != EINTR && errno != EAGAIN)) {
+                hung_up = true;
+            }
+        } else if (fds[0].revents & (POLLHUP | POLLERR)) {
+            // The other side of the pseudo-terminal has been closed
+            hung_up = true;
+        }
+        raise_rx_int();
+    }
+    return arg;
+}
+
+int adi_max22x88_hal_HostUartAttach(int fd)
+{
+    if (fd < 0 || uart.fd >= 0) {
+        return -1;
+    }
+    uart.fd = fd;
+    return 0;
+}
+
+int adi_max22x88_hal_HostUartOpenPty(int* peer_fd)
+{
+    int master;
+    int slave;
+    if (peer_fd == NULL || openpty(&master, &slave, NULL, NULL, NULL) != 0) {
+        return -1;
+    }
+    if (adi_max22x88_hal_HostUartAttach(slave) != 0) {
+        close(master);
+        close(slave);
+        return -1;
+    }
+    *peer_fd = master;
+    return 0;
+}
+
+unsigned long adi_max22x88_hal_HostUartRxIntCount(void)
+{
+    return uart.rx_int_cnt;
+}
+
+void adi_max22x88_hal_UartInit(uint32_t baud_rate)
+{
+    struct termios tio;
+    if (tcgetattr(uart.fd, &tio) == 0) {
+        cfmakeraw(&tio);
+        tio.c_cflag |= CS8 | PARENB | CLOCAL | CREAD;
+        tio.c_cflag &= ~CSTOPB;
+        tio.c_cc[VMIN] = 1;
+        tio.c_cc[VTIME] = 0;
+        speed_t speed = to_speed(baud_rate);
+        if (speed != B0) {
+            cfsetispeed(&tio, speed);
+            cfsetospeed(&tio, speed);
+        }
+        tcsetattr(uart.fd, TCSANOW, &tio);
+    }
+
+    uart.fifo_head = 0;
+    uart.fifo_cnt = 0;
+    uart.overrun = false;
+    uart.int_enabled = false;
+    uart.rx_int_cnt = 0;
+    uart.stop = false;
+    if (!uart.rx_thread_started && pipe(uart.wake_fds) == 0) {
+        uart.rx_thread_started = pthread_create(&uart.rx_thread, NULL, rx_thread, NULL) == 0;
+    }
+}
+
+void adi_max22x88_hal_UartShutdown(void)
+{
+    if (uart.rx_thread_started) {
+        uart.stop = true;
+        wake_rx_thread();
+        pthread_join(uart.rx_thread, NULL);
+        uart.rx_thread_started = false;
+        close(uart.wake_fds[0]);
+        close(uart.wake_fds[1]);
+        uart.wake_fds[0] = -1;
+        uart.wake_fds[1] = -1;
+    }
+    if (uart.fd >= 0) {
+        close(uart.fd);
+        uart.fd = -1;
+    }
+}
+
+void adi_max22x88_hal_UartWrite(const uint8_t* data, size_t len)
+{
+    while (len != 0) {
+        ssize_t n = write(uart.fd, data, len);
+        if (n < 0) {
+            if (errno == EINTR || errno == EAGAIN) {
+                continue;
+            }
+            return;
+        }
+        data += n;
+        len -= (size_t)n;
+    }
+}
+
+void adi_max22x88_hal_UartWaitTxDone(void)
+{
+    tcdrain(uart.fd);
+}
+
+bool adi_max22x88_hal_UartRead(uint8_t* data, uint8_t* errors)
+{
+    pthread_mutex_lock(&uart.fifo_lock);
+    bool available = uart.fifo_cnt != 0;
+    if (available) {
+        *data = uart.fifo[uart.fifo_head];
+        *errors = uart.overrun ? MAX22X88_HAL_UART_ERR_OVERRUN : 0;
+        uart.overrun = false;
+        uart.fifo_head = (uart.fifo_head + 1) % HOST_UART_RX_FIFO_LEN;
+        uart.fifo_cnt--;
+    }
+    pthread_mutex_unlock(&uart.fifo_lock);
+    return available;
+}
+
+void adi_max22x88_hal_UartFlushRx(void)
+{
+    tcflush(uart.fd, TCIFLUSH);
+    pthread_mutex_lock(&uart.fifo_lock);
+    uart.fifo_head = 0;
+    uart.fifo_cnt = 0;
+    uart.overrun = false;
+    pthread_mutex_unlock(&uart.fifo_lock);
+}
+
+void adi_max22x88_hal_UartSetRxCallback(void (*fn)(void))
+{
+    pthread_mutex_lock(&uart.isr_lock);
+    uart.rx_cb = fn;
+    pthread_mutex_unlock(&uart.isr_lock);
+}
+
+void adi_max22x88_hal_UartIntEnableRx(void)
+{
+    pthread_mutex_lock(&uart.isr_lock);
+    uart.int_enabled = true;
+    pthread_mutex_unlock(&uart.isr_lock);
+    // Data already in the Rx FIFO triggers the interrupt right away
+    wake_rx_thread();
+}
+
+void adi_max22x88_hal_UartIntDisableRx(void)
+{
+    pthread_mutex_lock(&uart.isr_lock);
+    uart.int_enabled = false;
+    pthread_mutex_unlock(&uart.isr_lock);
+}
@@ -101,6 +101,11 @@ void adi_max22x88_hal_GpioIntConfigureDoutFallingEdge(void)
     MXC_GPIO_IntConfig(&gpio_dout_cfg, MXC_GPIO_INT_FALLING);
 }
 
+void adi_max22x88_hal_GpioIntConfigureDoutBothEdges(void)
+{
+    MXC_GPIO_IntConfig(&gpio_dout_cfg, MXC_GPIO_INT_BOTH);
+}
+
 void adi_max22x88_hal_GpioIntEnableDout(void)
 {
     MXC_GPIO_EnableInt(MAX32670_GPIO_DOUT_PORT, MAX32670_GPIO_DOUT_MASK);
@@ -138,6 +143,12 @@ void adi_max22x88_hal_TimerSetCountSignal(uint32_t cnt)
     MXC_TMR_SetCount(MAX32670_TIMER_SIGNAL, cnt);
 }
 
+uint32_t adi_max22x88_hal_TimerGetLatencySignal(void)
+{
+    // In continuous mode the count is reloaded to 1 when it reaches the compare value
+    return MXC_TMR_GetCount(MAX32670_TIMER_SIGNAL) - 1;
+}
+
 void adi_max22x88_hal_TimerIntEnableSignal(void)
 {
     MXC_TMR_EnableInt(MAX32670_TIMER_SIGNAL);
@@ -162,3 +173,21 @@ void adi_max22x88_hal_NvicEnableSignal(void)
 {
     NVIC_EnableIRQ(MAX32670_TIMER_IRQn_SIGNAL);
 }
+
+void adi_max22x88_hal_TimestampInit(void)
+{
+    // The DWT cycle counter runs at the core clock
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+uint32_t adi_max22x88_hal_TimestampGet(void)
+{
+    return DWT->CYCCNT;
+}
+
+uint32_t adi_max22x88_hal_TimestampFrequency(void)
+{
+    return SystemCoreClock;
+}
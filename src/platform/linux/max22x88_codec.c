@@ -0,0 +1,392 @@
+/* 
+ * Copyright 2024 Analog Devices, Inc.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "max22x88_codec.h"
+#include <pthread.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define CODEC_X86 (1)
+#else
+#define CODEC_X86 (0)
+#endif
+
+#define FRAME_STUFFING (0xAAAAAAAAu)  // Off-duty "1" in every odd half-bit, like _stuff_byte_u32
+#define FRAME_ON_DUTY (0x55555555u)
+#define FRAME_BITS_ON_DUTY (0x155555u)  // On-duty half-bits of a 22 half-bit frame
+#define FRAME_DATA_PARITY_ON_DUTY (0x55554u)  // On-duty half-bits of the data and parity bits
+#define FRAME_CHECKED (0x3AAAABu)  // Half-bits fixed in a valid frame: start, stop and off-duty
+#define FRAME_CHECKED_VALID (0x3AAAAAu)
+#define FRAME_OFFDUTY (0x2AAAAAu)
+#define FRAME_STOP (1u << 20)
+#define AVX2_FRAMES (8)
+
+/**
+ * Functions of a kernel.
+ * 
+ */
+typedef struct {
+    adi_max22x88_CodecKernel_e kernel;
+    void (*encode)(const uint8_t* data, uint32_t* frames, size_t count);
+    size_t (*decode)(const uint32_t* frames, uint8_t* data, uint8_t* status, size_t count);
+    size_t (*validate)(const uint32_t* frames, size_t count);
+} codec_kernel_t;
+
+static const codec_kernel_t* _kernel = NULL;
+static pthread_once_t _kernel_once = PTHREAD_ONCE_INIT;
+
+/**
+ * @brief Returns 1 if the number of bits set is odd. The result matches _calc_even_parity_u8 for a byte.
+ * 
+ * @param value 
+ * @return uint32_t 
+ */
+static inline uint32_t parity_u32(uint32_t value)
+{
+    value ^= value >> 16;
+    value ^= value >> 8;
+    value ^= value >> 4;
+    value ^= value >> 2;
+    value ^= value >> 1;
+    return value & 1;
+}
+
+/**
+ * @brief Returns the start, data, parity and stop bits of a byte, LSB-first.
+ * 
+ * @param value 
+ * @param parity the parity of `value`
+ * @return uint32_t 
+ */
+static inline uint32_t frame_bits(uint32_t value, uint32_t parity)
+{
+    return (value << 1) | (parity << 9) | (1u << 10);
+}
+
+/**
+ * @brief Returns the adi_max22x88_FrameStatus_e flags of a frame word.
+ * 
+ * @param frame the frame word
+ * @param bits the on-duty half-bits of the frame word, compacted
+ * @param parity the parity of the data and parity bits
+ * @return uint8_t 
+ */
+static inline uint8_t frame_status(uint32_t frame, uint32_t bits, uint32_t parity)
+{
+    uint8_t status = MAX22X88_FRAME_OK;
+    if (bits & 1) {
+        status |= MAX22X88_FRAME_ERR_START;
+    }
+    if (!(frame & FRAME_STOP)) {
+        status |= MAX22X88_FRAME_ERR_STOP;
+    }
+    if ((frame & FRAME_OFFDUTY) != FRAME_OFFDUTY) {
+        status |= MAX22X88_FRAME_ERR_OFFDUTY;
+    }
+    if (parity) {
+        status |= MAX22X88_FRAME_ERR_PARITY;
+    }
+    return status;
+}
+
+static void encode_scalar(const uint8_t* data, uint32_t* frames, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        // Interleave the 11 bits with zeroes, then add the off-duty half-bits
+        uint32_t x = frame_bits(data[i], parity_u32(data[i]));
+        x = (x | (x << 8)) & 0x00FF00FFu;
+        x = (x | (x << 4)) & 0x0F0F0F0Fu;
+        x = (x | (x << 2)) & 0x33333333u;
+        x = (x | (x << 1)) & FRAME_ON_DUTY;
+        frames[i] = x | FRAME_STUFFING;
+    }
+}
+
+static size_t decode_scalar(const uint32_t* frames, uint8_t* data, uint8_t* status, size_t count)
+{
+    size_t errors = 0;
+    for (size_t i = 0; i < count; i++) {
+        uint32_t x = frames[i] & FRAME_BITS_ON_DUTY;
+        x = (x | (x >> 1)) & 0x33333333u;
+        x = (x | (x >> 2)) & 0x0F0F0F0Fu;
+        x = (x | (x >> 4)) & 0x00FF00FFu;
+        x = (x | (x >> 8)) & 0x0000FFFFu;
+        data[i] = (uint8_t)(x >> 1);
+        status[i] = frame_status(frames[i], x, parity_u32(frames[i] & FRAME_DATA_PARITY_ON_DUTY));
+        errors += status[i] != MAX22X88_FRAME_OK;
+    }
+    return errors;
+}
+
+static size_t validate_scalar(const uint32_t* frames, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        if ((frames[i] & FRAME_CHECKED) != FRAME_CHECKED_VALID || parity_u32(frames[i] & FRAME_DATA_PARITY_ON_DUTY)) {
+            return i;
+        }
+    }
+    return count;
+}
+
+#if CODEC_X86
+__attribute__((target("bmi2,popcnt")))
+static void encode_bmi2(const uint8_t* data, uint32_t* frames, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        uint32_t bits = frame_bits(data[i], _mm_popcnt_u32(data[i]) & 1);
+        frames[i] = _pdep_u32(bits, FRAME_ON_DUTY) | FRAME_STUFFING;
+    }
+}
+
+__attribute__((target("bmi2,popcnt")))
+static size_t decode_bmi2(const uint32_t* frames, uint8_t* data, uint8_t* status, size_t count)
+{
+    size_t errors = 0;
+    for (size_t i = 0; i < count; i++) {
+        uint32_t bits = _pext_u32(frames[i], FRAME_BITS_ON_DUTY);
+        data[i] = (uint8_t)(bits >> 1);
+        status[i] = frame_status(frames[i], bits, _mm_popcnt_u32(frames[i] & FRAME_DATA_PARITY_ON_DUTY) & 1);
+        errors += status[i] != MAX22X88_FRAME_OK;
+    }
+    return errors;
+}
+
+__attribute__((target("bmi2,popcnt")))
+static size_t validate_bmi2(const uint32_t* frames, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        if ((frames[i] & FRAME_CHECKED) != FRAME_CHECKED_VALID || (_mm_popcnt_u32(frames[i] & FRAME_DATA_PARITY_ON_DUTY) & 1)) {
+            return i;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Returns 1 in the lanes where the number of bits set at even positions is odd.
+ * 
+ * @param x 
+ * @return __m256i 
+ */
+__attribute__((target("avx2")))
+static inline __m256i parity_even_bits_avx2(__m256i x)
+{
+    x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 16));
+    x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 8));
+    x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 4));
+    x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 2));
+    return _mm256_and_si256(x, _mm256_set1_epi32(1));
+}
+
+__attribute__((target("avx2")))
+static void encode_avx2(const uint8_t* data, uint32_t* frames, size_t count)
+{
+    size_t i = 0;
+    for (; i + AVX2_FRAMES <= count; i += AVX2_FRAMES) {
+        __m256i v = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)&data[i]));
+        // The parity of a byte is the parity of its bits at even positions once it is folded by 1
+        __m256i parity = parity_even_bits_avx2(_mm256_xor_si256(v, _mm256_srli_epi32(v, 1)));
+        __m256i x = _mm256_or_si256(_mm256_slli_epi32(v, 1), _mm256_slli_epi32(parity, 9));
+        x = _mm256_or_si256(x, _mm256_set1_epi32(1 << 10));
+        x = _mm256_and_si256(_mm256_or_si256(x, _mm256_slli_epi32(x, 8)), _mm256_set1_epi32(0x00FF00FF));
+        x = _mm256_and_si256(_mm256_or_si256(x, _mm256_slli_epi32(x, 4)), _mm256_set1_epi32(0x0F0F0F0F));
+        x = _mm256_and_si256(_mm256_or_si256(x, _mm256_slli_epi32(x, 2)), _mm256_set1_epi32(0x33333333));
+        x = _mm256_and_si256(_mm256_or_si256(x, _mm256_slli_epi32(x, 1)), _mm256_set1_epi32(FRAME_ON_DUTY));
+        x = _mm256_or_si256(x, _mm256_set1_epi32((int)FRAME_STUFFING));
+        _mm256_storeu_si256((__m256i*)&frames[i], x);
+    }
+    encode_scalar(&data[i], &frames[i], count - i);
+}
+
+__attribute__((target("avx2")))
+static size_t decode_avx2(const uint32_t* frames, uint8_t* data, uint8_t* status, size_t count)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi32(1);
+    // Gathers the lowest byte of the 8 lanes, then of the 8 next lanes after packing
+    const __m256i gather = _mm256_setr_epi32(0, 4, 1, 5, 2, 3, 6, 7);
+    size_t errors = 0;
+    size_t i = 0;
+    for (; i + AVX2_FRAMES <= count; i += AVX2_FRAMES) {
+        __m256i w = _mm256_loadu_si256((const __m256i*)&frames[i]);
+        __m256i x = _mm256_and_si256(w, _mm256_set1_epi32(FRAME_BITS_ON_DUTY));
+        x = _mm256_and_si256(_mm256_or_si256(x, _mm256_srli_epi32(x, 1)), _mm256_set1_epi32(0x33333333));
+        x = _mm256_and_si256(_mm256_or_si256(x, _mm256_srli_epi32(x, 2)), _mm256_set1_epi32(0x0F0F0F0F));
+        x = _mm256_and_si256(_mm256_or_si256(x, _mm256_srli_epi32(x, 4)), _mm256_set1_epi32(0x00FF00FF));
+        x = _mm256_and_si256(_mm256_or_si256(x, _mm256_srli_epi32(x, 8)), _mm256_set1_epi32(0x0000FFFF));
+        __m256i bytes = _mm256_and_si256(_mm256_srli_epi32(x, 1), _mm256_set1_epi32(0xFF));
+
+        // The flags are built in place, each test giving 1 in the lanes with the error
+        __m256i start = _mm256_and_si256(x, one);
+        __m256i stop = _mm256_andnot_si256(_mm256_srli_epi32(w, 20), one);
+        __m256i offduty = _mm256_cmpeq_epi32(_mm256_and_si256(w, _mm256_set1_epi32(FRAME_OFFDUTY)), _mm256_set1_epi32(FRAME_OFFDUTY));
+        offduty = _mm256_andnot_si256(offduty, one);
+        __m256i parity = parity_even_bits_avx2(_mm256_and_si256(w, _mm256_set1_epi32(FRAME_DATA_PARITY_ON_DUTY)));
+        __m256i flags = _mm256_or_si256(
+            _mm256_or_si256(start, _mm256_slli_epi32(stop, 1)),
+            _mm256_or_si256(_mm256_slli_epi32(offduty, 2), _mm256_slli_epi32(parity, 3)));
+
+        // [data 0-3, flags 0-3 | data 4-7, flags 4-7] as 16 bit, then as 8 bit in the lowest dword of each quarter
+        __m256i packed = _mm256_packus_epi16(_mm256_packus_epi32(bytes, flags), zero);
+        packed = _mm256_permutevar8x32_epi32(packed, gather);
+        __m128i low = _mm256_castsi256_si128(packed);
+        _mm_storel_epi64((__m128i*)&data[i], low);
+        _mm_storel_epi64((__m128i*)&status[i], _mm_unpackhi_epi64(low, low));
+
+        int valid = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(flags, zero)));
+        errors += AVX2_FRAMES - (size_t)__builtin_popcount((unsigned)valid);
+    }
+    return errors + decode_scalar(&frames[i], &data[i], &status[i], count - i);
+}
+
+__attribute__((target("avx2")))
+static size_t validate_avx2(const uint32_t* frames, size_t count)
+{
+    size_t i = 0;
+    for (; i + AVX2_FRAMES <= count; i += AVX2_FRAMES) {
+        __m256i w = _mm256_loadu_si256((const __m256i*)&frames[i]);
+        __m256i fixed = _mm256_cmpeq_epi32(_mm256_and_si256(w, _mm256_set1_epi32(FRAME_CHECKED)), _mm256_set1_epi32(FRAME_CHECKED_VALID));
+        __m256i parity = parity_even_bits_avx2(_mm256_and_si256(w, _mm256_set1_epi32(FRAME_DATA_PARITY_ON_DUTY)));
+        __m256i valid = _mm256_and_si256(fixed, _mm256_cmpeq_epi32(parity, _mm256_setzero_si256()));
+        unsigned mask = (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(valid));
+        if (mask != 0xFF) {
+            return i + (size_t)__builtin_ctz(~mask);
+        }
+    }
+    return i + validate_scalar(&frames[i], count - i);
+}
+#endif
+
+static const codec_kernel_t kernels[] = {
+    { MAX22X88_CODEC_KERNEL_SCALAR, encode_scalar, decode_scalar, validate_scalar },
+#if CODEC_X86
+    { MAX22X88_CODEC_KERNEL_BMI2, encode_bmi2, decode_bmi2, validate_bmi2 },
+    { MAX22X88_CODEC_KERNEL_AVX2, encode_avx2, decode_avx2, validate_avx2 },
+#endif
+};
+
+bool adi_max22x88_CodecKernelSupported(adi_max22x88_CodecKernel_e kernel)
+{
+    switch (kernel) {
+        case MAX22X88_CODEC_KERNEL_AUTO:  // fallthrough
+        case MAX22X88_CODEC_KERNEL_SCALAR:
+            return true;
+#if CODEC_X86
+        case MAX22X88_CODEC_KERNEL_BMI2:
+            return __builtin_cpu_supports("bmi2") && __builtin_cpu_supports("popcnt");
+        case MAX22X88_CODEC_KERNEL_AVX2:
+            return __builtin_cpu_supports("avx2");
+#endif
+        default:
+            return false;
+    }
+}
+
+const char* adi_max22x88_CodecKernelName(adi_max22x88_CodecKernel_e kernel)
+{
+    switch (kernel) {
+        case MAX22X88_CODEC_KERNEL_AUTO:
+            return "auto";
+        case MAX22X88_CODEC_KERNEL_SCALAR:
+            return "scalar";
+        case MAX22X88_CODEC_KERNEL_BMI2:
+            return "bmi2";
+        case MAX22X88_CODEC_KERNEL_AVX2:
+            return "avx2";
+        default:
+            return "unknown";
+    }
+}
+
+/**
+ * @brief Selects the fastest kernel supported, the kernels being sorted from the slowest to the fastest.
+ * 
+ */
+static void select_fastest_kernel(void)
+{
+    for (size_t i = 0; i < sizeof kernels / sizeof *kernels; i++) {
+        if (adi_max22x88_CodecKernelSupported(kernels[i].kernel)) {
+            _kernel = &kernels[i];
+        }
+    }
+}
+
+/**
+ * @brief Returns the kernel to use, selecting the fastest one on first use.
+ * 
+ * @return const codec_kernel_t* 
+ */
+static const codec_kernel_t* get_kernel(void)
+{
+    pthread_once(&_kernel_once, select_fastest_kernel);
+    return _kernel;
+}
+
+adi_max22x88_Result_e adi_max22x88_CodecSelectKernel(adi_max22x88_CodecKernel_e kernel)
+{
+    if (!adi_max22x88_CodecKernelSupported(kernel)) {
+        return MAX22X88_ERR_BAD_PARAM;
+    }
+
+    pthread_once(&_kernel_once, select_fastest_kernel);
+    if (kernel == MAX22X88_CODEC_KERNEL_AUTO) {
+        select_fastest_kernel();
+        return MAX22X88_ERR_OK;
+    }
+    for (size_t i = 0; i < sizeof kernels / sizeof *kernels; i++) {
+        if (kernels[i].kernel == kernel) {
+            _kernel = &kernels[i];
+            return MAX22X88_ERR_OK;
+        }
+    }
+    return MAX22X88_ERR_BAD_PARAM;
+}
+
+adi_max22x88_CodecKernel_e adi_max22x88_CodecGetKernel(void)
+{
+    return get_kernel()->kernel;
+}
+
+adi_max22x88_Result_e adi_max22x88_CodecEncode(const uint8_t* data, uint32_t* frames, size_t count)
+{
+    if ((data == NULL || frames == NULL) && count > 0) {
+        return MAX22X88_ERR_BAD_PARAM;
+    }
+
+    get_kernel()->encode(data, frames, count);
+    return MAX22X88_ERR_OK;
+}
+
+adi_max22x88_Result_e adi_max22x88_CodecDecode(const uint32_t* frames, uint8_t* data, uint8_t* status, size_t count, size_t* errors)
+{
+    if (((frames == NULL || data == NULL || status == NULL) && count > 0) || errors == NULL) {
+        return MAX22X88_ERR_BAD_PARAM;
+    }
+
+    *errors = get_kernel()->decode(frames, data, status, count);
+    return MAX22X88_ERR_OK;
+}
+
+adi_max22x88_Result_e adi_max22x88_CodecValidate(const uint32_t* frames, size_t count, size_t* first_error)
+{
+    if ((frames == NULL && count > 0) || first_error == NULL) {
+        return MAX22X88_ERR_BAD_PARAM;
+    }
+
+    *first_error = get_kernel()->validate(frames, count);
+    return MAX22X88_ERR_OK;
+}
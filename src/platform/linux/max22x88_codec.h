@@ -0,0 +1,109 @@
+/* 
+ * Copyright 2024 Analog Devices, Inc.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/**
+ * @file max22x88_codec.h
+ * Bulk codec converting bytes to and from the 22 half-bit words of Home Bus frames, for gateways processing long
+ * captured or replayed streams.
+ * 
+ * The frame words have the layout written to DIN by the bitbang implementation: the start bit in bit 0, the data bits
+ * LSB-first, then the parity and stop bits, each on-duty half-bit followed by an off-duty "1". Encoding gives the same
+ * words as the bitbang implementation, and decoding the same data and status as its Rx state machine, whatever the
+ * kernel. Kernels using x86 BMI2 or AVX2 instructions are selected at runtime if the CPU supports them.
+ */
+
+#ifndef MAX22X88_CODEC_H
+#define MAX22X88_CODEC_H
+
+#include "max22x88.h"
+
+/**
+ * Implementations of the codec.
+ * 
+ */
+typedef enum {
+    MAX22X88_CODEC_KERNEL_AUTO, /*!< The fastest kernel supported by the CPU */
+    MAX22X88_CODEC_KERNEL_SCALAR, /*!< Portable C, one frame at a time */
+    MAX22X88_CODEC_KERNEL_BMI2, /*!< One frame at a time with the x86 PDEP, PEXT and POPCNT instructions */
+    MAX22X88_CODEC_KERNEL_AVX2, /*!< 8 frames at a time with x86 AVX2 instructions */
+} adi_max22x88_CodecKernel_e;
+
+/**
+ * @brief Selects the kernel used by the codec functions. By default the fastest kernel supported is used.
+ * @note Not thread safe, call it before using the codec from several threads.
+ * 
+ * @param[in] kernel the kernel
+ * @return adi_max22x88_Result_e MAX22X88_ERR_BAD_PARAM if the CPU doesn't support the kernel.
+ */
+adi_max22x88_Result_e adi_max22x88_CodecSelectKernel(adi_max22x88_CodecKernel_e kernel);
+
+/**
+ * @brief Returns the kernel used by the codec functions, never MAX22X88_CODEC_KERNEL_AUTO.
+ * 
+ * @return adi_max22x88_CodecKernel_e 
+ */
+adi_max22x88_CodecKernel_e adi_max22x88_CodecGetKernel(void);
+
+/**
+ * @brief Returns whether the CPU supports a kernel.
+ * 
+ * @param[in] kernel the kernel
+ * @return bool 
+ */
+bool adi_max22x88_CodecKernelSupported(adi_max22x88_CodecKernel_e kernel);
+
+/**
+ * @brief Returns the name of a kernel, such as "avx2".
+ * 
+ * @param[in] kernel the kernel
+ * @return const char* 
+ */
+const char* adi_max22x88_CodecKernelName(adi_max22x88_CodecKernel_e kernel);
+
+/**
+ * @brief Encodes bytes into frame words.
+ * 
+ * @param[in] data the bytes
+ * @param[out] frames the frame words, one per byte
+ * @param[in] count the number of bytes
+ * @return adi_max22x88_Result_e 
+ */
+adi_max22x88_Result_e adi_max22x88_CodecEncode(const uint8_t* data, uint32_t* frames, size_t count);
+
+/**
+ * @brief Decodes frame words into bytes, and checks their framing. Only the 22 lower bits of each word are used.
+ * 
+ * @param[in] frames the frame words
+ * @param[out] data the bytes, one per frame word
+ * @param[out] status adi_max22x88_FrameStatus_e flags of each frame
+ * @param[in] count the number of frame words
+ * @param[out] errors the number of frames with errors
+ * @return adi_max22x88_Result_e 
+ */
+adi_max22x88_Result_e adi_max22x88_CodecDecode(const uint32_t* frames, uint8_t* data, uint8_t* status, size_t count, size_t* errors);
+
+/**
+ * @brief Checks the framing of frame words, without decoding them. Only the 22 lower bits of each word are used.
+ * 
+ * @param[in] frames the frame words
+ * @param[in] count the number of frame words
+ * @param[out] first_error the index of the first frame with errors, `count` if all of them are valid
+ * @return adi_max22x88_Result_e 
+ */
+adi_max22x88_Result_e adi_max22x88_CodecValidate(const uint32_t* frames, size_t count, size_t* first_error);
+
+#endif
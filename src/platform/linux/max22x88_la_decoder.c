@@ -0,0 +1,602 @@
+/* 
+ * Copyright 2024 Analog Devices, Inc.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#define _DEFAULT_SOURCE
+
+#include "max22x88_la_decoder.h"
+#include "private/max22x88_edge_decoder.h"
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define PACKED_TICKS_PER_SAMPLE (16)  // Fixed point sample index, a half-bit is rarely a whole number of samples
+#define MIN_SAMPLES_PER_HALF_BIT (4)
+#define CSV_TICKS_PER_SECOND (1000000000ull)
+#define HALF_BITS_IN_HOMEBUS_FRAME (22)
+#define POLL_HORIZON (0x40000000u)  // Longest step given to the edge decoder, well within its 32 bit tick arithmetic
+#define MAX_THREADS (64)
+
+// An edge is stored as its tick, shifted left, and the level after it in bit 0
+#define EDGE(tick, level) (((uint64_t)(tick) << 1) | ((level) ? 1u : 0u))
+#define EDGE_TICK(edge) ((edge) >> 1)
+#define EDGE_LEVEL(edge) ((bool)((edge) & 1))
+
+/**
+ * A growing array.
+ * 
+ */
+typedef struct {
+    void* items;
+    size_t count;
+    size_t cap;
+    bool failed;
+} la_vector_t;
+
+/**
+ * Conversion of a chunk of the capture into edges.
+ * 
+ */
+typedef struct {
+    const uint8_t* buf;
+    size_t begin;
+    size_t end;
+    const adi_max22x88_la_Params_t* params;
+    double csv_t0;
+    la_vector_t edges;  // uint64_t, EDGE()
+    uint64_t last_tick;
+} la_convert_job_t;
+
+/**
+ * Decoding of a part of the edges.
+ * 
+ */
+typedef struct {
+    const uint64_t* edges;
+    size_t begin;
+    size_t end;
+    uint64_t stop_tick;
+    uint32_t half_bit_ticks;
+    uint32_t idle_gap_ticks;
+    uint64_t tick_rate;
+    la_vector_t events;  // adi_max22x88_la_Event_t
+} la_decode_job_t;
+
+/**
+ * @brief Appends an item to a vector, growing it as needed. Sets `failed` if memory can't be allocated.
+ * 
+ * @param vector 
+ * @param item 
+ * @param size size of an item
+ */
+static void vector_push(la_vector_t* vector, const void* item, size_t size)
+{
+    if (vector->count == vector->cap) {
+        size_t cap = vector->cap ? vector->cap * 2 : 1024;
+        void* items = realloc(vector->items, cap * size);
+        if (items == NULL) {
+            vector->failed = true;
+            return;
+        }
+        vector->items = items;
+        vector->cap = cap;
+    }
+    memcpy((uint8_t*)vector->items + vector->count * size, item, size);
+    vector->count++;
+}
+
+static inline void push_edge(la_convert_job_t* job, uint64_t tick, bool level)
+{
+    uint64_t edge = EDGE(tick, level);
+    vector_push(&job->edges, &edge, sizeof edge);
+}
+
+/**
+ * @brief Finds the transitions of a packed chunk, a word of 64 samples at a time.
+ * 
+ * @param job 
+ */
+static void convert_packed(la_convert_job_t* job)
+{
+    const uint8_t* buf = job->buf;
+    // The level before the chunk is the last sample of the previous byte
+    uint64_t prev = job->begin > 0 ? (buf[job->begin - 1] >> 7) & 1 : buf[0] & 1;
+    size_t i = job->begin;
+    for (; i + sizeof(uint64_t) <= job->end; i += sizeof(uint64_t)) {
+        uint64_t x;
+        memcpy(&x, &buf[i], sizeof x);  // The first sample is in the LSB on little-endian hosts
+        uint64_t transitions = x ^ ((x << 1) | prev);
+        prev = x >> 63;
+        while (transitions != 0) {
+            int bit = __builtin_ctzll(transitions);
+            push_edge(job, ((uint64_t)i * 8 + (uint64_t)bit) * PACKED_TICKS_PER_SAMPLE, (x >> bit) & 1);
+            transitions &= transitions - 1;
+        }
+    }
+    for (; i < job->end; i++) {
+        uint32_t x = buf[i];
+        uint32_t transitions = (x ^ ((x << 1) | (uint32_t)prev)) & 0xFF;
+        prev = x >> 7;
+        while (transitions != 0) {
+            int bit = __builtin_ctz(transitions);
+            push_edge(job, ((uint64_t)i * 8 + (uint64_t)bit) * PACKED_TICKS_PER_SAMPLE, (x >> bit) & 1);
+            transitions &= transitions - 1;
+        }
+    }
+    job->last_tick = (uint64_t)job->end * 8 * PACKED_TICKS_PER_SAMPLE;
+}
+
+/**
+ * @brief Parses a decimal number, without reading past the end of the line.
+ * 
+ * @param p the first character, updated past the number
+ * @param end the end of the line
+ * @param value the number
+ * @return bool false if there's no number at `p`.
+ */
+static bool parse_number(const char** p, const char* end, double* value)
+{
+    const char* s = *p;
+    double sign = 1.0;
+    if (s < end && (*s == '-' || *s == '+')) {
+        sign = *s == '-' ? -1.0 : 1.0;
+        s++;
+    }
+    double mantissa = 0.0;
+    int exponent = 0;
+    bool digits = false;
+    for (; s < end && *s >= '0' && *s <= '9'; s++) {
+        mantissa = mantissa * 10.0 + (*s - '0');
+        digits = true;
+    }
+    if (s < end && *s == '.') {
+        for (s++; s < end && *s >= '0' && *s <= '9'; s++) {
+            mantissa = mantissa * 10.0 + (*s - '0');
+            exponent--;
+            digits = true;
+        }
+    }
+    if (!digits) {
+        return false;
+    }
+    if (s < end && (*s == 'e' || *s == 'E')) {
+        const char* e = s + 1;
+        int exp_sign = 1;
+        if (e < end && (*e == '-' || *e == '+')) {
+            exp_sign = *e == '-' ? -1 : 1;
+            e++;
+        }
+        int exp = 0;
+        if (e < end && *e >= '0' && *e <= '9') {
+            for (; e < end && *e >= '0' && *e <= '9'; e++) {
+                exp = exp * 10 + (*e - '0');
+            }
+            exponent += exp_sign * exp;
+            s = e;
+        }
+    }
+    double scale = 1.0;
+    for (int n = exponent < 0 ? -exponent : exponent; n > 0; n--) {
+        scale *= 10.0;
+    }
+    *value = sign * (exponent < 0 ? mantissa / scale : mantissa * scale);
+    *p = s;
+    return true;
+}
+
+/**
+ * @brief Parses a CSV line into a time and a level.
+ * 
+ * @param line the line
+ * @param end the end of the line
+ * @param column the level column
+ * @param time the time, in seconds
+ * @param level the level
+ * @return bool false if the line doesn't hold a sample.
+ */
+static bool parse_csv_line(const char* line, const char* end, unsigned int column, double* time, bool* level)
+{
+    while (line < end && (*line == ' ' || *line == '\t')) {
+        line++;
+    }
+    if (!parse_number(&line, end, time)) {
+        return false;
+    }
+    for (unsigned int c = 0; c <= column; c++) {
+        while (line < end && *line != ',') {
+            line++;
+        }
+        if (line == end) {
+            return false;
+        }
+        line++;
+    }
+    while (line < end && (*line == ' ' || *line == '\t' || *line == '"')) {
+        line++;
+    }
+    if (line == end || *line == '\r') {
+        return false;
+    }
+    *level = *line != '0';
+    return true;
+}
+
+/**
+ * @brief Converts the lines of a CSV chunk into level changes. The first sample of the chunk is always stored, it is
+ * dropped afterwards if it continues the previous chunk.
+ * 
+ * @param job 
+ */
+static void convert_csv(la_convert_job_t* job)
+{
+    const char* p = (const char*)job->buf + job->begin;
+    const char* end = (const char*)job->buf + job->end;
+    bool first = true;
+    bool level = true;
+    while (p < end) {
+        const char* eol = memchr(p, '\n', (size_t)(end - p));
+        if (eol == NULL) {
+            eol = end;
+        }
+        double time;
+        bool sample;
+        if (parse_csv_line(p, eol, job->params->column, &time, &sample)) {
+            double ns = (time - job->csv_t0) * (double)CSV_TICKS_PER_SECOND;
+            uint64_t tick = ns > 0.0 ? (uint64_t)(ns + 0.5) : 0;
+            if (first || sample != level) {
+                push_edge(job, tick, sample);
+            }
+            first = false;
+            level = sample;
+            job->last_tick = tick;
+        }
+        p = eol + 1;
+    }
+}
+
+static void* convert_thread(void* arg)
+{
+    la_convert_job_t* job = arg;
+    if (job->params->format == MAX22X88_LA_FORMAT_PACKED) {
+        convert_packed(job);
+    } else {
+        convert_csv(job);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Stores the events reported by the edge decoder.
+ * 
+ * @param job 
+ * @param dec 
+ * @param events _adi_edge_dec_Event_e flags
+ * @param result the frame, if EDGE_DEC_FRAME is set
+ * @param now the tick passed to the decoder, no event is later than it
+ */
+static void store_events(la_decode_job_t* job, const _adi_edge_dec_t* dec, uint32_t events, const _adi_edge_dec_Result_t* result, uint64_t now)
+{
+    if (events & EDGE_DEC_FRAME) {
+        uint64_t tick = now - (uint32_t)((uint32_t)now - result->timestamp);
+        adi_max22x88_la_Event_t event = {
+            .time_ns = tick / job->tick_rate * CSV_TICKS_PER_SECOND + tick % job->tick_rate * CSV_TICKS_PER_SECOND / job->tick_rate,
+            .type = MAX22X88_LA_EVENT_FRAME,
+            .data = result->data,
+            .status = result->status
+        };
+        vector_push(&job->events, &event, sizeof event);
+    }
+    if (events & EDGE_DEC_END_OF_BURST) {
+        uint64_t tick = now - (uint32_t)((uint32_t)now - (dec->frame_end + dec->idle_gap_ticks));
+        adi_max22x88_la_Event_t event = {
+            .time_ns = tick / job->tick_rate * CSV_TICKS_PER_SECOND + tick % job->tick_rate * CSV_TICKS_PER_SECOND / job->tick_rate,
+            .type = MAX22X88_LA_EVENT_END_OF_BURST,
+        };
+        vector_push(&job->events, &event, sizeof event);
+    }
+}
+
+/**
+ * @brief Tells the decoder no edge happened until a tick, in steps short enough for its 32 bit arithmetic.
+ * 
+ * @param job 
+ * @param dec 
+ * @param last the tick of the last edge passed to the decoder
+ * @param until the tick
+ */
+static void poll_until(la_decode_job_t* job, _adi_edge_dec_t* dec, uint64_t last, uint64_t until)
+{
+    _adi_edge_dec_Result_t result;
+    while (until - last > POLL_HORIZON) {
+        last += POLL_HORIZON;
+        store_events(job, dec, _adi_edge_dec_Poll(dec, (uint32_t)last, &result), &result, last);
+    }
+}
+
+static void* decode_thread(void* arg)
+{
+    la_decode_job_t* job = arg;
+    _adi_edge_dec_t dec;
+    _adi_edge_dec_Result_t result;
+    _adi_edge_dec_Init(&dec, job->half_bit_ticks, job->idle_gap_ticks);
+    // Every part starts after an idle gap, where the decoder of the previous part is idle too
+    uint64_t last = job->begin > 0 ? EDGE_TICK(job->edges[job->begin - 1]) : 0;
+    for (size_t i = job->begin; i < job->end; i++) {
+        uint64_t tick = EDGE_TICK(job->edges[i]);
+        poll_until(job, &dec, last, tick);
+        store_events(job, &dec, _adi_edge_dec_Edge(&dec, (uint32_t)tick, EDGE_LEVEL(job->edges[i]), &result), &result, tick);
+        last = tick;
+    }
+    poll_until(job, &dec, last, job->stop_tick);
+    store_events(job, &dec, _adi_edge_dec_Poll(&dec, (uint32_t)job->stop_tick, &result), &result, job->stop_tick);
+    return NULL;
+}
+
+/**
+ * @brief Runs jobs in threads and waits for them.
+ * 
+ * @param fn the thread function
+ * @param jobs the jobs
+ * @param size size of a job
+ * @param count number of jobs
+ * @return bool false if a thread couldn't be started, the jobs are then run in the calling thread.
+ */
+static bool run_jobs(void* (*fn)(void*), void* jobs, size_t size, size_t count)
+{
+    pthread_t threads[MAX_THREADS];
+    size_t started = 0;
+    for (size_t i = 1; i < count; i++) {
+        if (pthread_create(&threads[started], NULL, fn, (uint8_t*)jobs + i * size) != 0) {
+            break;
+        }
+        started++;
+    }
+    fn(jobs);
+    for (size_t i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    for (size_t i = started + 1; i < count; i++) {
+        fn((uint8_t*)jobs + i * size);
+    }
+    return started + 1 == count;
+}
+
+/**
+ * @brief Moves a CSV offset to the start of the next line.
+ * 
+ * @param buf 
+ * @param len 
+ * @param offset 
+ * @return size_t 
+ */
+static size_t next_line(const uint8_t* buf, size_t len, size_t offset)
+{
+    if (offset == 0 || offset >= len) {
+        return offset > len ? len : offset;
+    }
+    const uint8_t* eol = memchr(&buf[offset - 1], '\n', len - offset + 1);
+    return eol == NULL ? len : (size_t)(eol - buf) + 1;
+}
+
+adi_max22x88_Result_e adi_max22x88_LaDecodeBuffer(const void* buf, size_t len, const adi_max22x88_la_Params_t* params, adi_max22x88_la_Result_t* result)
+{
+    if ((buf == NULL && len > 0) || params == NULL || result == NULL || params->hbs_baud == 0) {
+        return MAX22X88_ERR_BAD_PARAM;
+    }
+    uint64_t tick_rate = CSV_TICKS_PER_SECOND;
+    if (params->format == MAX22X88_LA_FORMAT_PACKED) {
+        if (params->sample_rate < (uint64_t)params->hbs_baud * 2 * MIN_SAMPLES_PER_HALF_BIT) {
+            return MAX22X88_ERR_BAD_PARAM;
+        }
+        tick_rate = params->sample_rate * PACKED_TICKS_PER_SAMPLE;
+    } else if (params->format != MAX22X88_LA_FORMAT_CSV) {
+        return MAX22X88_ERR_BAD_PARAM;
+    }
+    uint64_t half_bit_ticks = tick_rate / ((uint64_t)params->hbs_baud * 2);
+    // A part can only start after DOUT has been idle long enough for the previous frame and burst to be over
+    uint64_t split_gap = (HALF_BITS_IN_HOMEBUS_FRAME + 2 + (uint64_t)params->idle_gap_bits * 2) * half_bit_ticks;
+    if (split_gap >= POLL_HORIZON) {
+        return MAX22X88_ERR_BAD_PARAM;
+    }
+
+    memset(result, 0, sizeof *result);
+    size_t threads = params->threads;
+    if (threads == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cpus > 0 ? (size_t)cpus : 1;
+    }
+    if (threads > MAX_THREADS) {
+        threads = MAX_THREADS;
+    }
+    if (len < threads * 4096) {
+        threads = 1;
+    }
+
+    // Convert the chunks into edges
+    la_convert_job_t converts[MAX_THREADS];
+    double csv_t0 = 0.0;
+    if (params->format == MAX22X88_LA_FORMAT_CSV) {
+        // Times are counted from the first sample of the capture
+        for (size_t offset = 0; offset < len; offset = next_line(buf, len, offset + 1)) {
+            const char* line = (const char*)buf + offset;
+            const char* eol = memchr(line, '\n', len - offset);
+            bool level;
+            if (parse_csv_line(line, eol ? eol : (const char*)buf + len, params->column, &csv_t0, &level)) {
+                break;
+            }
+        }
+    }
+    for (size_t i = 0; i < threads; i++) {
+        memset(&converts[i], 0, sizeof converts[i]);
+        converts[i].buf = buf;
+        converts[i].begin = len / threads * i;
+        converts[i].end = i + 1 == threads ? len : len / threads * (i + 1);
+        if (params->format == MAX22X88_LA_FORMAT_CSV) {
+            converts[i].begin = next_line(buf, len, converts[i].begin);
+            converts[i].end = next_line(buf, len, converts[i].end);
+        }
+        converts[i].params = params;
+        converts[i].csv_t0 = csv_t0;
+    }
+    run_jobs(convert_thread, converts, sizeof *converts, threads);
+
+    // Join the edges, dropping the first sample of the capture and the CSV samples that continue the previous chunk
+    size_t total = 0;
+    bool failed = false;
+    for (size_t i = 0; i < threads; i++) {
+        total += converts[i].edges.count;
+        failed |= converts[i].edges.failed;
+    }
+    uint64_t* edges = malloc((total ? total : 1) * sizeof *edges);
+    size_t count = 0;
+    bool level = true;
+    uint64_t stop_tick = 0;
+    for (size_t i = 0; i < threads; i++) {
+        const uint64_t* chunk = converts[i].edges.items;
+        size_t n = converts[i].edges.count;
+        if (n > 0 && params->format == MAX22X88_LA_FORMAT_CSV) {
+            if (count == 0 && i == 0) {
+                // The first sample of the capture is the initial level, not an edge
+                level = EDGE_LEVEL(chunk[0]);
+                chunk++;
+                n--;
+            } else if (EDGE_LEVEL(chunk[0]) == level) {
+                chunk++;
+                n--;
+            }
+        }
+        if (edges != NULL && n > 0) {
+            memcpy(&edges[count], chunk, n * sizeof *chunk);
+            count += n;
+            level = EDGE_LEVEL(chunk[n - 1]);
+        }
+        if (converts[i].last_tick > stop_tick) {
+            stop_tick = converts[i].last_tick;
+        }
+        free(converts[i].edges.items);
+    }
+    if (edges == NULL || failed) {
+        free(edges);
+        return MAX22X88_ERR_INTERNAL;
+    }
+
+    // Split the edges before falling edges following a long enough idle time, close to an even share for each thread
+    la_decode_job_t decodes[MAX_THREADS];
+    size_t parts = 0;
+    size_t begin = 0;
+    for (size_t i = 1; i <= threads; i++) {
+        size_t end = count;
+        if (i < threads) {
+            end = count / threads * i;
+            if (end <= begin) {
+                end = begin + 1;
+            }
+            while (end < count && !(end > 0 && !EDGE_LEVEL(edges[end]) && EDGE_LEVEL(edges[end - 1])
+                && EDGE_TICK(edges[end]) - EDGE_TICK(edges[end - 1]) >= split_gap)) {
+                end++;
+            }
+        }
+        if (end <= begin && i < threads) {
+            continue;
+        }
+        memset(&decodes[parts], 0, sizeof decodes[parts]);
+        decodes[parts].edges = edges;
+        decodes[parts].begin = begin;
+        decodes[parts].end = end;
+        decodes[parts].stop_tick = end < count ? EDGE_TICK(edges[end]) : stop_tick;
+        decodes[parts].half_bit_ticks = (uint32_t)half_bit_ticks;
+        decodes[parts].idle_gap_ticks = (uint32_t)(params->idle_gap_bits * 2 * half_bit_ticks);
+        decodes[parts].tick_rate = tick_rate;
+        parts++;
+        begin = end;
+        if (end == count) {
+            break;
+        }
+    }
+    run_jobs(decode_thread, decodes, sizeof *decodes, parts);
+
+    size_t events = 0;
+    for (size_t i = 0; i < parts; i++) {
+        events += decodes[i].events.count;
+        failed |= decodes[i].events.failed;
+    }
+    result->events = malloc((events ? events : 1) * sizeof *result->events);
+    failed |= result->events == NULL;
+    for (size_t i = 0; i < parts; i++) {
+        if (!failed) {
+            memcpy(&result->events[result->count], decodes[i].events.items, decodes[i].events.count * sizeof *result->events);
+            result->count += decodes[i].events.count;
+        }
+        free(decodes[i].events.items);
+    }
+    free(edges);
+    if (failed) {
+        adi_max22x88_LaFreeResult(result);
+        return MAX22X88_ERR_INTERNAL;
+    }
+    result->edges = count;
+    result->duration_ns = stop_tick / tick_rate * CSV_TICKS_PER_SECOND + stop_tick % tick_rate * CSV_TICKS_PER_SECOND / tick_rate;
+    result->segments = (unsigned int)parts;
+    return MAX22X88_ERR_OK;
+}
+
+adi_max22x88_Result_e adi_max22x88_LaDecodeFile(const char* path, const adi_max22x88_la_Params_t* params, adi_max22x88_la_Result_t* result)
+{
+    if (path == NULL) {
+        return MAX22X88_ERR_BAD_PARAM;
+    }
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return MAX22X88_ERR_USER_FN;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return MAX22X88_ERR_USER_FN;
+    }
+    size_t len = (size_t)st.st_size;
+    void* buf = NULL;
+    if (len > 0) {
+        buf = mmap(NULL, len, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (buf == MAP_FAILED) {
+            close(fd);
+            return MAX22X88_ERR_USER_FN;
+        }
+        madvise(buf, len, MADV_SEQUENTIAL);
+    }
+    close(fd);
+
+    adi_max22x88_Result_e err = adi_max22x88_LaDecodeBuffer(buf, len, params, result);
+    if (buf != NULL) {
+        munmap(buf, len);
+    }
+    return err;
+}
+
+void adi_max22x88_LaFreeResult(adi_max22x88_la_Result_t* result)
+{
+    if (result == NULL) {
+        return;
+    }
+    free(result->events);
+    result->events = NULL;
+    result->count = 0;
+}
@@ -0,0 +1,117 @@
+/* 
+ * Copyright 2024 Analog Devices, Inc.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/**
+ * @file max22x88_la_decoder.h
+ * Offline decoder for logic analyzer captures of DOUT.
+ * 
+ * The capture is mapped in memory and split in chunks, converted to edges in parallel. The edges are then split at
+ * idle gaps and each part is decoded by its own thread with the edge decoder of the bitbang implementation, which
+ * realigns on every edge and checks the frames with the same rules as the driver. The events are the same whatever
+ * the number of threads.
+ */
+
+#ifndef MAX22X88_LA_DECODER_H
+#define MAX22X88_LA_DECODER_H
+
+#include "max22x88.h"
+
+/**
+ * Formats of the capture.
+ * 
+ */
+typedef enum {
+    MAX22X88_LA_FORMAT_PACKED, /*!< Raw binary, one bit per sample, first sample in the LSB of the first byte */
+    MAX22X88_LA_FORMAT_CSV, /*!< Text lines "time,level[,level...]" with the time in seconds, as exported by most logic analyzers. Lines that don't start with a number, such as headers, are skipped. */
+} adi_max22x88_la_Format_e;
+
+/**
+ * Decoding parameters.
+ * 
+ */
+typedef struct {
+    adi_max22x88_la_Format_e format; /*!< Format of the capture */
+    uint64_t sample_rate; /*!< Samples per second, only used by MAX22X88_LA_FORMAT_PACKED */
+    unsigned int column; /*!< For MAX22X88_LA_FORMAT_CSV, the level column holding DOUT, 0 being the first column after the time */
+    uint32_t hbs_baud; /*!< Home Bus System baud rate */
+    uint32_t idle_gap_bits; /*!< Report the end of a burst once DOUT stays idle for this many bit-times after a stop bit. 0 disables the detection. */
+    unsigned int threads; /*!< Threads used, 0 for one per online CPU */
+} adi_max22x88_la_Params_t;
+
+/**
+ * Types of decoded events.
+ * 
+ */
+typedef enum {
+    MAX22X88_LA_EVENT_FRAME, /*!< A frame, `data` and `status` are set */
+    MAX22X88_LA_EVENT_END_OF_BURST, /*!< DOUT has been idle for the idle gap since the last frame */
+} adi_max22x88_la_EventType_e;
+
+/**
+ * A decoded event.
+ * 
+ */
+typedef struct {
+    uint64_t time_ns; /*!< For a frame, the time of its start bit edge. For an end of burst, the time the idle gap elapsed. From the start of the capture. */
+    uint8_t type; /*!< adi_max22x88_la_EventType_e */
+    uint8_t data; /*!< The data received */
+    uint8_t status; /*!< adi_max22x88_FrameStatus_e flags */
+} adi_max22x88_la_Event_t;
+
+/**
+ * Result of a decoding.
+ * 
+ */
+typedef struct {
+    adi_max22x88_la_Event_t* events; /*!< The events in order, allocated by the decoder */
+    size_t count; /*!< Number of events */
+    uint64_t edges; /*!< Edges found on DOUT */
+    uint64_t duration_ns; /*!< Duration of the capture */
+    unsigned int segments; /*!< Number of parts decoded in parallel */
+} adi_max22x88_la_Result_t;
+
+/**
+ * @brief Decodes a capture held in memory.
+ * 
+ * @param[in] buf the capture
+ * @param[in] len the length of the capture, in bytes
+ * @param[in] params decoding parameters
+ * @param[out] result the events decoded. Free it with adi_max22x88_LaFreeResult.
+ * @return adi_max22x88_Result_e MAX22X88_ERR_BAD_PARAM if the sample rate is lower than 8 samples per bit,
+ * MAX22X88_ERR_INTERNAL if memory or threads couldn't be allocated.
+ */
+adi_max22x88_Result_e adi_max22x88_LaDecodeBuffer(const void* buf, size_t len, const adi_max22x88_la_Params_t* params, adi_max22x88_la_Result_t* result);
+
+/**
+ * @brief Maps a capture file in memory and decodes it.
+ * 
+ * @param[in] path the capture file
+ * @param[in] params decoding parameters
+ * @param[out] result the events decoded. Free it with adi_max22x88_LaFreeResult.
+ * @return adi_max22x88_Result_e MAX22X88_ERR_USER_FN if the file can't be mapped, see adi_max22x88_LaDecodeBuffer
+ * for the other errors.
+ */
+adi_max22x88_Result_e adi_max22x88_LaDecodeFile(const char* path, const adi_max22x88_la_Params_t* params, adi_max22x88_la_Result_t* result);
+
+/**
+ * @brief Frees the events of a result.
+ * 
+ * @param[in] result the result
+ */
+void adi_max22x88_LaFreeResult(adi_max22x88_la_Result_t* result);
+
+#endif
@@ -0,0 +1,465 @@
+/* 
+ * Copyright 2024 Analog Devices, Inc.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define _DEFAULT_SOURCE
+
+#include "max22x88_linux.h"
+#include "private/max22x88_internal.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/ioctl.h>
+#include <sys/uio.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#define RX_CHUNK_LEN (256)
+#define TX_IOV_LEN (16)
+
+/**
+ * Progress of the parity error marking (PARMRK) sequence parser.
+ * 
+ */
+typedef enum {
+    PARMRK_NONE, /*!< Not inside a sequence */
+    PARMRK_FF, /*!< Read 0377, next is 0377 for a literal 0377 or 0 for an error */
+    PARMRK_FF_00, /*!< Read 0377 0, next is the byte received with an error */
+} parmrk_state_e;
+
+/**
+ * Context used for Linux implementation.
+ * 
+ */
+typedef struct
+{
+    adi_max22x88_t* driver;
+    int fd;
+    int wake_fds[2];
+    pthread_t rx_thread;
+    bool rx_thread_started;
+    volatile bool stop;
+    int rst_bits;
+    bool rst_active_high;
+    bool drop_echo;
+    size_t echo_pending;  // Accessed with atomics, written by the writer and consumed by the Rx thread
+    parmrk_state_e parmrk;
+    volatile adi_max22x88_linux_Stats_t stats;
+} max22x88_linux_ctx_t;
+
+/**
+ * @brief Linux implementation for Max22x88 init callback. Opens and configures the serial port, and starts the Rx thread.
+ * 
+ * @param driver 
+ * @param ctx 
+ * @param user_params 
+ * @return adi_max22x88_Result_e 
+ */
+static adi_max22x88_Result_e max22x88_linux_init(adi_max22x88_t* driver, void* ctx, void* user_params);
+
+/**
+ * @brief Linux implementation for Max22x88 RST enable/disable callback. Drives the modem control line connected to RST.
+ * 
+ * @param driver 
+ * @param state 
+ * @return adi_max22x88_Result_e 
+ */
+static adi_max22x88_Result_e max22x88_set_rst_linux(adi_max22x88_t* driver, bool state);
+
+/**
+ * @brief Linux implementation for Max22x88 write callback.
+ * 
+ * @param driver 
+ * @param data 
+ * @param count 
+ * @return adi_max22x88_Result_e 
+ */
+static adi_max22x88_Result_e max22x88_write_linux(adi_max22x88_t *driver, uint8_t* data, size_t count);
+
+/**
+ * @brief Linux implementation for Max22x88 gather write callback. The segments are written with as few system calls
+ * as possible, then the function waits until the serial port has sent them.
+ * 
+ * @param driver 
+ * @param segments 
+ * @param count 
+ * @return adi_max22x88_Result_e 
+ */
+static adi_max22x88_Result_e max22x88_writev_linux(adi_max22x88_t *driver, const adi_max22x88_Segment_t* segments, size_t count);
+
+/**
+ * @brief Rx thread. Blocks reading the serial port and stores the data in the driver's rx buffer.
+ * 
+ * @param arg the IO layer context
+ * @return void* NULL
+ */
+static void* rx_thread(void* arg);
+
+static speed_t to_speed(uint32_t baud_rate)
+{
+    switch (baud_rate) {
+    case 1200: return B1200;
+    case 2400: return B2400;
+    case 4800: return B4800;
+    case 9600: return B9600;
+    case 19200: return B19200;
+    case 38400: return B38400;
+    case 57600: return B57600;
+    case 115200: return B115200;
+    case 230400: return B230400;
+    default: return B0;
+    }
+}
+
+static uint32_t timestamp_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u);
+}
+
+static int configure_port(int fd, uint32_t baud_rate)
+{
+    speed_t speed = to_speed(baud_rate);
+    struct termios tio;
+    if (speed == B0 || tcgetattr(fd, &tio) != 0) {
+        return -1;
+    }
+    cfmakeraw(&tio);
+    tio.c_cflag |= CS8 | PARENB | CLOCAL | CREAD;
+    tio.c_cflag &= ~(CSTOPB | CRTSCTS);
+    // Mark bytes with parity and framing errors with a 0377 0 prefix instead of dropping them
+    tio.c_iflag |= INPCK | PARMRK;
+    tio.c_iflag &= ~(IGNPAR | ISTRIP);
+    tio.c_cc[VMIN] = 1;
+    tio.c_cc[VTIME] = 0;
+    cfsetispeed(&tio, speed);
+    cfsetospeed(&tio, speed);
+    if (tcsetattr(fd, TCSANOW, &tio) != 0) {
+        return -1;
+    }
+    tcflush(fd, TCIOFLUSH);
+    return 0;
+}
+
+static void deliver(max22x88_linux_ctx_t* ctx, uint8_t data, bool error, uint32_t timestamp)
+{
+    if (ctx->drop_echo) {
+        size_t pending = __atomic_load_n(&ctx->echo_pending, __ATOMIC_ACQUIRE);
+        while (pending != 0) {
+            if (__atomic_compare_exchange_n(&ctx->echo_pending, &pending, pending - 1, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+                return;
+            }
+        }
+    }
+
+    adi_max22x88_Frame_t frame = {
+        .timestamp = timestamp,
+        .data = data,
+        .status = MAX22X88_FRAME_OK
+    };
+    if (error) {
+        // termios doesn't tell parity and framing errors apart
+        frame.status = MAX22X88_FRAME_ERR_PARITY;
+        ctx->stats.rx_errors++;
+    }
+    adi_max22x88_Result_e err;
+    if (!error && ctx->driver->rx_mode == MAX22X88_RX_MODE_BYTES) {
+        err = adi_max22x88_DataReceived(ctx->driver, data);
+    } else {
+        err = adi_max22x88_FrameReceived(ctx->driver, &frame);
+    }
+    if (err == MAX22X88_ERR_RX_BUFFER_FULL) {
+        ctx->stats.rx_overflows++;
+    }
+}
+
+static void parse_rx(max22x88_linux_ctx_t* ctx, const uint8_t* buf, size_t len, uint32_t timestamp)
+{
+    for (size_t i = 0; i < len; i++) {
+        uint8_t byte = buf[i];
+        switch (ctx->parmrk) {
+        case PARMRK_NONE:
+            if (byte == 0377) {
+                ctx->parmrk = PARMRK_FF;
+            } else {
+                deliver(ctx, byte, false, timestamp);
+            }
+            break;
+        case PARMRK_FF:
+            if (byte == 0377) {
+                ctx->parmrk = PARMRK_NONE;
+                deliver(ctx, byte, false, timestamp);
+            } else {
+                ctx->parmrk = PARMRK_FF_00;
+            }
+            break;
+        case PARMRK_FF_00:
+            ctx->parmrk = PARMRK_NONE;
+            deliver(ctx, byte, true, timestamp);
+            break;
+        }
+    }
+}
+
+static void* rx_thread(void* arg)
+{
+    max22x88_linux_ctx_t* ctx = arg;
+    uint8_t buf[RX_CHUNK_LEN];
+    while (!ctx->stop) {
+        struct pollfd fds[2] = {
+            { .fd = ctx->fd, .events = POLLIN },
+            { .fd = ctx->wake_fds[0], .events = POLLIN },
+        };
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        if (fds[1].revents & POLLIN) {
+            continue;  // Woken up to stop
+        }
+        if (fds[0].revents & POLLIN) {
+            ssize_t n = read(ctx->fd, buf, sizeof buf);
+            if (n > 0) {
+                uint32_t timestamp = timestamp_us();
+                ctx->stats.rx_bytes += n;
+                parse_rx(ctx, buf, (size_t)n, timestamp);
+                continue;
+            }
+            if (n < 0 && (errno == EINTR || errno == EAGAIN)) {
+                continue;
+            }
+        }
+        if (fds[0].revents & (POLLHUP | POLLERR | POLLNVAL | POLLIN)) {
+            // The serial port is gone, such as an unplugged adapter or a closed pseudo-terminal
+            break;
+        }
+    }
+    return NULL;
+}
+
+const adi_max22x88_Functions_t max22x88_linux_functions = {
+    .init_fn = max22x88_linux_init,
+    .ctx_size = sizeof(max22x88_linux_ctx_t),
+    .set_rst_state_fn = max22x88_set_rst_linux,
+    .write_fn = max22x88_write_linux,
+    .writev_fn = max22x88_writev_linux
+};
+
+adi_max22x88_Result_e adi_max22x88_InitLinux(adi_max22x88_t* driver, adi_max22x88_linux_InitParams_t* params, size_t rx_buffer_len)
+{
+    if (params == NULL) {
+        return MAX22X88_ERR_BAD_PARAM;
+    }
+
+    return adi_max22x88_InitRxMode(
+        driver,
+        rx_buffer_len,
+        params->rx_mode,
+        max22x88_linux_functions,
+        params
+    );
+}
+
+static adi_max22x88_Result_e max22x88_linux_init(adi_max22x88_t* driver, void* ctx, void* user_params)
+{
+    if (user_params == NULL) {
+        return MAX22X88_ERR_BAD_PARAM;
+    }
+
+    adi_max22x88_linux_InitParams_t* params = user_params;
+    max22x88_linux_ctx_t* linux_ctx = ctx;
+    switch (params->rst_line) {
+        case MAX22X88_LINUX_RST_NONE:
+            linux_ctx->rst_bits = 0;
+            break;
+        case MAX22X88_LINUX_RST_RTS:
+            linux_ctx->rst_bits = TIOCM_RTS;
+            break;
+        case MAX22X88_LINUX_RST_DTR:
+            linux_ctx->rst_bits = TIOCM_DTR;
+            break;
+        default:
+            return MAX22X88_ERR_BAD_PARAM;
+    }
+
+    linux_ctx->driver = driver;
+    linux_ctx->rst_active_high = params->rst_active_high;
+    linux_ctx->drop_echo = params->drop_echo;
+    linux_ctx->echo_pending = 0;
+    linux_ctx->parmrk = PARMRK_NONE;
+    linux_ctx->stop = false;
+    linux_ctx->rx_thread_started = false;
+    linux_ctx->stats = (adi_max22x88_linux_Stats_t){ 0 };
+    linux_ctx->wake_fds[0] = -1;
+    linux_ctx->wake_fds[1] = -1;
+    linux_ctx->fd = params->fd >= 0 ? params->fd : open(params->path, O_RDWR | O_NOCTTY | O_CLOEXEC);
+    if (linux_ctx->fd < 0) {
+        return MAX22X88_ERR_USER_FN;
+    }
+
+    if (configure_port(linux_ctx->fd, params->hbs_baud) != 0) {
+        goto error;
+    }
+    // Keep the transmitter disabled until the first transmission
+    if (max22x88_set_rst_linux(driver, false) != MAX22X88_ERR_OK) {
+        goto error;
+    }
+    if (pipe(linux_ctx->wake_fds) != 0) {
+        goto error;
+    }
+    if (pthread_create(&linux_ctx->rx_thread, NULL, rx_thread, linux_ctx) != 0) {
+        goto error;
+    }
+    linux_ctx->rx_thread_started = true;
+    return MAX22X88_ERR_OK;
+
+error:
+    if (linux_ctx->wake_fds[0] >= 0) {
+        close(linux_ctx->wake_fds[0]);
+        close(linux_ctx->wake_fds[1]);
+    }
+    close(linux_ctx->fd);
+    linux_ctx->fd = -1;
+    return MAX22X88_ERR_USER_FN;
+}
+
+adi_max22x88_Result_e adi_max22x88_DeinitLinux(adi_max22x88_t* driver)
+{
+    if (driver == NULL || driver->low_level_ctx == NULL) {
+        return MAX22X88_ERR_BAD_PARAM;
+    }
+
+    max22x88_linux_ctx_t* ctx = adi_max22x88_GetLowLevelCtx(driver);
+    if (ctx->rx_thread_started) {
+        ctx->stop = true;
+        uint8_t token = 0;
+        if (write(ctx->wake_fds[1], &token, 1) == 1) {
+            pthread_join(ctx->rx_thread, NULL);
+        } else {
+            pthread_cancel(ctx->rx_thread);
+            pthread_join(ctx->rx_thread, NULL);
+        }
+        ctx->rx_thread_started = false;
+        close(ctx->wake_fds[0]);
+        close(ctx->wake_fds[1]);
+    }
+    if (ctx->fd >= 0) {
+        close(ctx->fd);
+        ctx->fd = -1;
+    }
+    return adi_max22x88_Deinit(driver);
+}
+
+adi_max22x88_Result_e adi_max22x88_GetStatsLinux(adi_max22x88_t* driver, adi_max22x88_linux_Stats_t* stats)
+{
+    if (driver == NULL || driver->low_level_ctx == NULL || stats == NULL) {
+        return MAX22X88_ERR_BAD_PARAM;
+    }
+
+    max22x88_linux_ctx_t* ctx = adi_max22x88_GetLowLevelCtx(driver);
+    *stats = ctx->stats;
+    return MAX22X88_ERR_OK;
+}
+
+static adi_max22x88_Result_e max22x88_set_rst_linux(adi_max22x88_t* driver, bool state)
+{
+    max22x88_linux_ctx_t* ctx = adi_max22x88_GetLowLevelCtx(driver);
+    if (ctx->rst_bits == 0) {
+        return MAX22X88_ERR_OK;
+    }
+
+    // An asserted line is driven low by most adapters, and a low RST enables the transmitter
+    bool assert = ctx->rst_active_high ? !state : state;
+    if (ioctl(ctx->fd, assert ? TIOCMBIS : TIOCMBIC, &ctx->rst_bits) != 0) {
+        return MAX22X88_ERR_USER_FN;
+    }
+    return MAX22X88_ERR_OK;
+}
+
+static adi_max22x88_Result_e max22x88_write_linux(adi_max22x88_t *driver, uint8_t* data, size_t count)
+{
+    adi_max22x88_Segment_t segment = {
+        .data = data,
+        .len = count
+    };
+    return max22x88_writev_linux(driver, &segment, 1);
+}
+
+static adi_max22x88_Result_e max22x88_writev_linux(adi_max22x88_t *driver, const adi_max22x88_Segment_t* segments, size_t count)
+{
+    max22x88_linux_ctx_t* ctx = adi_max22x88_GetLowLevelCtx(driver);
+
+#if MAX22X88_RECORD
+    // The Rx thread keeps running, the recorder serializes its calls
+    adi_max22x88_RecordTx(driver, segments, count);
+#endif
+    size_t next = 0;
+    size_t offset = 0;  // Bytes of segments[next] already written
+    while (next < count) {
+        struct iovec iov[TX_IOV_LEN];
+        size_t iov_cnt = 0;
+        size_t total = 0;
+        for (size_t i = next; i < count && iov_cnt < TX_IOV_LEN; i++) {
+            size_t skip = i == next ? offset : 0;
+            if (segments[i].len > skip) {
+                iov[iov_cnt].iov_base = (void*)(segments[i].data + skip);
+                iov[iov_cnt].iov_len = segments[i].len - skip;
+                total += iov[iov_cnt].iov_len;
+                iov_cnt++;
+            }
+        }
+        if (iov_cnt == 0) {
+            break;
+        }
+
+        if (ctx->drop_echo) {
+            __atomic_add_fetch(&ctx->echo_pending, total, __ATOMIC_RELEASE);
+        }
+        ssize_t n = writev(ctx->fd, iov, (int)iov_cnt);
+        if (n < 0) {
+            if (ctx->drop_echo) {
+                __atomic_sub_fetch(&ctx->echo_pending, total, __ATOMIC_RELEASE);
+            }
+            if (errno == EINTR || errno == EAGAIN) {
+                continue;
+            }
+            return MAX22X88_ERR_USER_FN;
+        }
+        if (ctx->drop_echo) {
+            __atomic_sub_fetch(&ctx->echo_pending, total - (size_t)n, __ATOMIC_RELEASE);
+        }
+        ctx->stats.tx_bytes += n;
+
+        // Skip past what was written
+        size_t written = (size_t)n;
+        while (next < count && written >= segments[next].len - offset) {
+            written -= segments[next].len - offset;
+            offset = 0;
+            next++;
+        }
+        offset += written;
+    }
+
+    // Returns once the data has left the serial port, so RST isn't released in the middle of a frame
+    if (tcdrain(ctx->fd) != 0) {
+        return MAX22X88_ERR_USER_FN;
+    }
+    return MAX22X88_ERR_OK;
+}
@@ -0,0 +1,100 @@
+/* 
+ * Copyright 2024 Analog Devices, Inc.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file max22x88_linux.h
+ * API for the Linux implementation, for transceivers attached through a serial port such as a USB-UART adapter.
+ * 
+ * Like the UART implementation, frames are sent with 8 data bits, even parity and 1 stop bit at the Home Bus baud rate,
+ * and the nodes of the bus must use one of these two implementations.
+ * A thread per driver blocks reading the serial port and stores the received data in the driver's rx buffer.
+ */
+
+#ifndef MAX22X88_LINUX_H
+#define MAX22X88_LINUX_H
+
+#include "max22x88.h"
+#include "io_layer_interface.h"
+
+/**
+ * Modem control line connected to RST.
+ * 
+ */
+typedef enum {
+    MAX22X88_LINUX_RST_NONE, /*!< RST is not controlled, the transmitter is always enabled */
+    MAX22X88_LINUX_RST_RTS, /*!< RST is connected to RTS */
+    MAX22X88_LINUX_RST_DTR, /*!< RST is connected to DTR */
+} adi_max22x88_linux_RstLine_e;
+
+/**
+ * Initialization parameters for Linux IO layer.
+ * 
+ */
+typedef struct {
+    const char* path; /*!< Serial port, such as "/dev/ttyUSB0". Only used if `fd` is negative. */
+    int fd; /*!< Serial port already open, such as the slave side of a pseudo-terminal pair, or -1 to open `path`. */
+    uint32_t hbs_baud; /*!< Home Bus System baud rate. Must be a standard termios baud rate. */
+    adi_max22x88_RxMode_e rx_mode; /*!< What the Rx buffer stores for each frame. Timestamps are CLOCK_MONOTONIC microseconds taken when the data is read from the serial port. */
+    adi_max22x88_linux_RstLine_e rst_line; /*!< Modem control line connected to RST */
+    bool rst_active_high; /*!< Enabling the transmitter asserts the line, which drives most adapters' pin low. Set if the adapter doesn't invert the line. */
+    bool drop_echo; /*!< Set if the transmitted bytes are looped back to the Rx line, so they're dropped instead of received */
+} adi_max22x88_linux_InitParams_t;
+
+/**
+ * Statistics of the Linux IO layer.
+ * 
+ */
+typedef struct {
+    uint32_t rx_bytes; /*!< Bytes read from the serial port, echoes included */
+    uint32_t tx_bytes; /*!< Bytes written to the serial port */
+    uint32_t rx_errors; /*!< Bytes received with a parity or framing error */
+    uint32_t rx_overflows; /*!< Bytes dropped because the driver's rx buffer was full */
+} adi_max22x88_linux_Stats_t;
+
+/**
+ * Arguments for initializing driver with Linux implementation.
+ * 
+ */
+extern const adi_max22x88_Functions_t max22x88_linux_functions;
+
+/**
+ * @brief Initializes the max22x88 driver with the Linux implementation, and starts its Rx thread.
+ * 
+ * @param[in] driver the driver to initialize
+ * @param[in] params initialization parameters
+ * @param[in] rx_buffer_len the length of the rx buffer to be allocated
+ * @return adi_max22x88_Result_e 
+ */
+adi_max22x88_Result_e adi_max22x88_InitLinux(adi_max22x88_t* driver, adi_max22x88_linux_InitParams_t* params, size_t rx_buffer_len);
+
+/**
+ * @brief Stops the Rx thread, closes the serial port and deinitializes the driver.
+ * 
+ * @param[in] driver the driver
+ * @return adi_max22x88_Result_e 
+ */
+adi_max22x88_Result_e adi_max22x88_DeinitLinux(adi_max22x88_t* driver);
+
+/**
+ * @brief Copies the statistics of the Linux IO layer.
+ * 
+ * @param[in] driver the driver
+ * @param[out] stats the statistics
+ * @return adi_max22x88_Result_e 
+ */
+adi_max22x88_Result_e adi_max22x88_GetStatsLinux(adi_max22x88_t* driver, adi_max22x88_linux_Stats_t* stats);
+
+#endif
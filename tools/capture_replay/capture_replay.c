@@ -0,0 +1,235 @@
+/*
+ * Copyright 2024 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file capture_replay.c
+ * Replays a bus capture through the driver and the protocol stack, at its original timing or as fast as possible.
+ */
+
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "max22x88_capture.h"
+#include "homebus.h"
+#include "homebus_max22x88.h"
+
+#define DEFAULT_ADDR (0x01)
+#define DEFAULT_ROUNDS (1)
+#define DEFAULT_RX_LEN (256)
+
+static unsigned long packets;
+static unsigned long payload_bytes;
+static uint32_t digest;  // FNV-1a of the packets received in a round, to compare runs
+
+#define FNV_OFFSET_BASIS (2166136261u)
+#define FNV_PRIME (16777619u)
+
+static void usage(const char* name)
+{
+    fprintf(stderr, "usage: %s [-r] [-a addr] [-p] [-n rounds] [-l len] capture\n", name);
+    fprintf(stderr, "  -r            replay at the original timing (default as fast as possible)\n");
+    fprintf(stderr, "  -a            node address (default 0x%02x)\n", DEFAULT_ADDR);
+    fprintf(stderr, "  -p            receive packets sent to any address\n");
+    fprintf(stderr, "  -n            replays measured back to back (default %d)\n", DEFAULT_ROUNDS);
+    fprintf(stderr, "  -l            frames in the driver's rx buffer (default %d)\n", DEFAULT_RX_LEN);
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+// The frames are only fed by the replay, nothing is received or transmitted on a bus
+static adi_max22x88_Result_e replay_init(adi_max22x88_t* driver, void* state, void* params)
+{
+    return MAX22X88_ERR_OK;
+}
+
+static adi_max22x88_Result_e replay_set_rst(adi_max22x88_t* driver, bool state)
+{
+    return MAX22X88_ERR_OK;
+}
+
+static adi_max22x88_Result_e replay_write(adi_max22x88_t* driver, uint8_t* data, size_t count)
+{
+    return MAX22X88_ERR_OK;
+}
+
+static const adi_max22x88_Functions_t replay_functions = {
+    .init_fn = replay_init,
+    .ctx_size = 0,
+    .set_rst_state_fn = replay_set_rst,
+    .write_fn = replay_write,
+    .writev_fn = NULL
+};
+
+static void hash(const uint8_t* data, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        digest = (digest ^ data[i]) * FNV_PRIME;
+    }
+}
+
+static hbs_err_e count_packet(adi_hbs_t* hbs, adi_hbs_Packet_t* packet)
+{
+    packets++;
+    payload_bytes += packet->len;
+    hash(&packet->self_addr, 4);
+    hash(packet->data, packet->len);
+    return HBS_ERR_OK;
+}
+
+int main(int argc, char** argv)
+{
+    bool realtime = false;
+    long addr = DEFAULT_ADDR;
+    bool promiscuous = false;
+    long rounds = DEFAULT_ROUNDS;
+    long rx_len = DEFAULT_RX_LEN;
+    int opt;
+    while ((opt = getopt(argc, argv, "ra:pn:l:")) != -1) {
+        switch (opt) {
+        case 'r':
+            realtime = true;
+            break;
+        case 'a':
+            addr = strtol(optarg, NULL, 0);
+            break;
+        case 'p':
+            promiscuous = true;
+            break;
+        case 'n':
+            rounds = strtol(optarg, NULL, 0);
+            break;
+        case 'l':
+            rx_len = strtol(optarg, NULL, 0);
+            break;
+        default:
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (optind != argc - 1 || addr < 0 || addr > 255 || rounds <= 0 || rx_len <= 0) {
+        usage(argv[0]);
+        return 1;
+    }
+    const char* path = argv[optind];
+
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        perror(path);
+        return 1;
+    }
+    size_t len = (size_t)st.st_size;
+    const uint8_t* buf = len > 0 ? mmap(NULL, len, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+    close(fd);
+    adi_max22x88_CaptureReader_t reader;
+    if (buf == MAP_FAILED || adi_max22x88_CaptureReaderInit(&reader, buf, len) != MAX22X88_ERR_OK) {
+        fprintf(stderr, "%s: not a capture\n", path);
+        return 1;
+    }
+    if (realtime && reader.tick_hz == 0) {
+        fprintf(stderr, "%s: the timestamp frequency is unknown, it can only be replayed as fast as possible\n", path);
+        return 1;
+    }
+
+    // Count the records, bursts are only delimited if the capture has end of burst markers
+    unsigned long counts[3] = { 0 };
+    unsigned long bad = 0;
+    adi_max22x88_CaptureRecord_t record;
+    adi_max22x88_Result_e err;
+    while ((err = adi_max22x88_CaptureNext(&reader, &record)) == MAX22X88_ERR_OK) {
+        counts[record.kind]++;
+        bad += record.kind == MAX22X88_CAPTURE_KIND_RX && record.frame.status != MAX22X88_FRAME_OK;
+    }
+    if (err == MAX22X88_ERR_RX_FRAME) {
+        fprintf(stderr, "%s: corrupted record at offset %zu, replaying up to it\n", path, reader.pos);
+    }
+    uint64_t duration = reader.elapsed;
+
+    adi_max22x88_t driver;
+    if (adi_max22x88_InitRxMode(&driver, (size_t)rx_len, MAX22X88_RX_MODE_FRAMES, replay_functions, NULL) != MAX22X88_ERR_OK) {
+        fprintf(stderr, "cannot initialize the driver\n");
+        return 1;
+    }
+    adi_hbs_t hbs;
+    adi_hbs_InitMax22x88(&hbs, (uint8_t)addr, &driver);
+    for (unsigned int a = 0; promiscuous && a < 256; a++) {
+        adi_hbs_AcceptAddr(&hbs, (uint8_t)a, true);
+    }
+    adi_hbs_SetBurstDelimited(&hbs, counts[MAX22X88_CAPTURE_KIND_END_OF_BURST] > 0);
+    adi_hbs_RegisterRxCb(&hbs, count_packet);
+
+    uint64_t start = now_ns();
+    unsigned long fed_total = 0;
+    for (long round = 0; round < rounds; round++) {
+        adi_max22x88_CaptureRewind(&reader);
+        digest = FNV_OFFSET_BASIS;
+        uint64_t round_start = now_ns();
+        do {
+            uint64_t until = UINT64_MAX;
+            if (realtime) {
+                uint64_t elapsed_ns = now_ns() - round_start;
+                until = elapsed_ns / 1000000000u * reader.tick_hz + elapsed_ns % 1000000000u * reader.tick_hz / 1000000000u;
+            }
+            size_t fed;
+            err = adi_max22x88_CaptureReplay(&reader, &driver, until, &fed);
+            fed_total += fed;
+            adi_hbs_ReceiveMax22x88(&hbs, &driver);
+            if (err == MAX22X88_ERR_OK) {
+                // Wait for the next record
+                adi_max22x88_CaptureReader_t next = reader;
+                if (adi_max22x88_CaptureNext(&next, &record) == MAX22X88_ERR_OK) {
+                    uint64_t due = round_start + record.elapsed / reader.tick_hz * 1000000000u
+                        + record.elapsed % reader.tick_hz * 1000000000u / reader.tick_hz;
+                    uint64_t now = now_ns();
+                    if (due > now) {
+                        struct timespec ts = { .tv_sec = (time_t)((due - now) / 1000000000u), .tv_nsec = (long)((due - now) % 1000000000u) };
+                        nanosleep(&ts, NULL);
+                    }
+                }
+            }
+        } while (err == MAX22X88_ERR_OK || err == MAX22X88_ERR_RX_BUFFER_FULL);
+        adi_hbs_EndOfBurst(&hbs);
+    }
+    double elapsed = (double)(now_ns() - start) / 1e9;
+
+    printf("capture:     %lu frames (%lu with errors), %lu bursts, %lu bytes transmitted",
+        counts[MAX22X88_CAPTURE_KIND_RX], bad, counts[MAX22X88_CAPTURE_KIND_END_OF_BURST], counts[MAX22X88_CAPTURE_KIND_TX]);
+    if (reader.tick_hz != 0) {
+        printf(", %.3f s", (double)duration / reader.tick_hz);
+    }
+    printf("\n");
+    printf("stack:       %lu packets, %lu payload bytes, %u dropped, digest %08" PRIx32 "\n",
+        packets / (unsigned long)rounds, payload_bytes / (unsigned long)rounds, hbs.dropped_pkt_cnt / (unsigned int)rounds, digest);
+    printf("replay:      %ld rounds in %.3f s, %.0f frames/s, %.0f packets/s\n",
+        rounds, elapsed, (double)fed_total / elapsed, (double)packets / elapsed);
+
+    adi_max22x88_Deinit(&driver);
+    return 0;
+}
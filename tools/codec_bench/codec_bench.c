@@ -0,0 +1,262 @@
+/*
+ * Copyright 2024 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file codec_bench.c
+ * Checks the bulk codec kernels against the bitbang implementation, and measures their throughput.
+ */
+
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "max22x88_codec.h"
+#include "private/bitbang_helper.h"
+#include "private/max22x88_bitbang_rx_state_machine.h"
+
+#define DEFAULT_COUNT (16 * 1024 * 1024)
+#define DEFAULT_ROUNDS (5)
+#define HALF_BITS_IN_FRAME (22)
+#define FRAME_WORDS (1u << HALF_BITS_IN_FRAME)
+
+static const adi_max22x88_CodecKernel_e kernels[] = {
+    MAX22X88_CODEC_KERNEL_SCALAR,
+    MAX22X88_CODEC_KERNEL_BMI2,
+    MAX22X88_CODEC_KERNEL_AVX2,
+};
+
+static void usage(const char* name)
+{
+    fprintf(stderr, "usage: %s [-n count] [-r rounds] [-k kernel]\n", name);
+    fprintf(stderr, "  -n            frames per round (default %d)\n", DEFAULT_COUNT);
+    fprintf(stderr, "  -r            rounds measured, the best one is reported (default %d)\n", DEFAULT_ROUNDS);
+    fprintf(stderr, "  -k            only this kernel: scalar, bmi2 or avx2 (default all supported)\n");
+}
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+// Decodes a frame word the way the bitbang implementation does, one sample at a time
+static void decode_reference(uint32_t frame, uint8_t* data, uint8_t* status)
+{
+    _adi_bitbang_sm_t sm;
+    _adi_bitbang_sm_Result_t result = { 0 };
+    bool finished = false;
+    _adi_bitbang_sm_Init(&sm);
+    _adi_bitbang_sm_EventStartBitEdge(&sm);
+    for (int i = 0; i < HALF_BITS_IN_FRAME; i++) {
+        if (i > 0) {
+            _adi_bitbang_sm_EventEdge(&sm);
+        }
+        _adi_bitbang_sm_EventSample(&sm, (frame >> i) & 1, &finished, &result);
+    }
+    *data = result.data;
+    *status = (uint8_t)result.error_flags;
+}
+
+// Compares the frame helpers, which may use the constant tables, with the bit-stuffing and parity helpers and with
+// the Rx state machine
+static long check_helpers(void)
+{
+    long mismatches = 0;
+    for (int i = 0; i < 256; i++) {
+        uint16_t bits = (uint16_t)((i | (_calc_even_parity_u8((uint8_t)i) << 8) | (1 << 9)) << 1);
+        uint8_t data;
+        if (_format_frame_u32((uint8_t)i) != _stuff_byte_u32(bits)
+            || _parse_frame_u32(_stuff_byte_u32(bits), &data) != MAX22X88_FRAME_OK || data != i) {
+            mismatches++;
+        }
+    }
+    for (uint32_t i = 0; i < FRAME_WORDS; i++) {
+        uint8_t data;
+        uint8_t ref_data;
+        uint8_t ref_status;
+        decode_reference(i, &ref_data, &ref_status);
+        if (_parse_frame_u32(i, &data) != ref_status || data != ref_data) {
+            mismatches++;
+        }
+    }
+    return mismatches;
+}
+
+// Compares the selected kernel with the bitbang implementation for every byte and every 22 half-bit frame word
+static long check_kernel(uint32_t* frames, uint8_t* data, uint8_t* status)
+{
+    long mismatches = 0;
+    uint8_t bytes[256];
+    for (int i = 0; i < 256; i++) {
+        bytes[i] = (uint8_t)i;
+    }
+    adi_max22x88_CodecEncode(bytes, frames, 256);
+    for (int i = 0; i < 256; i++) {
+        if (frames[i] != _format_frame_u32((uint8_t)i)) {
+            mismatches++;
+        }
+    }
+
+    for (uint32_t i = 0; i < FRAME_WORDS; i++) {
+        // The bits above the frame must be ignored
+        frames[i] = i | ((uint32_t)rand() << HALF_BITS_IN_FRAME);
+    }
+    size_t errors;
+    adi_max22x88_CodecDecode(frames, data, status, FRAME_WORDS, &errors);
+    size_t expected_errors = 0;
+    size_t first_error = FRAME_WORDS;
+    for (uint32_t i = 0; i < FRAME_WORDS; i++) {
+        uint8_t ref_data;
+        uint8_t ref_status;
+        decode_reference(i, &ref_data, &ref_status);
+        if (data[i] != ref_data || status[i] != ref_status) {
+            mismatches++;
+        }
+        if (ref_status != MAX22X88_FRAME_OK) {
+            expected_errors++;
+            if (first_error == FRAME_WORDS) {
+                first_error = i;
+            }
+        }
+    }
+    if (errors != expected_errors) {
+        mismatches++;
+    }
+
+    // Validate every valid frame word, each one followed by an invalid one
+    size_t n = 0;
+    for (uint32_t i = 0; i < FRAME_WORDS; i++) {
+        if (status[i] == MAX22X88_FRAME_OK) {
+            frames[n++] = i;
+        }
+    }
+    size_t found;
+    adi_max22x88_CodecValidate(frames, n, &found);
+    if (found != n) {
+        mismatches++;
+    }
+    for (size_t i = 0; i + 1 < n; i += 97) {
+        uint32_t saved = frames[i];
+        frames[i] ^= 1u << (i % HALF_BITS_IN_FRAME);
+        adi_max22x88_CodecValidate(frames, n, &found);
+        if (found != i) {
+            mismatches++;
+        }
+        frames[i] = saved;
+    }
+    return mismatches;
+}
+
+int main(int argc, char** argv)
+{
+    long count = DEFAULT_COUNT;
+    long rounds = DEFAULT_ROUNDS;
+    const char* only = NULL;
+    int opt;
+    while ((opt = getopt(argc, argv, "n:r:k:")) != -1) {
+        switch (opt) {
+        case 'n':
+            count = strtol(optarg, NULL, 0);
+            break;
+        case 'r':
+            rounds = strtol(optarg, NULL, 0);
+            break;
+        case 'k':
+            only = optarg;
+            break;
+        default:
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (count <= 0 || rounds <= 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    size_t len = (size_t)count > FRAME_WORDS ? (size_t)count : FRAME_WORDS;
+    uint8_t* bytes = malloc(len);
+    uint8_t* data = malloc(len);
+    uint8_t* status = malloc(len);
+    uint32_t* frames = malloc(len * sizeof *frames);
+    if (bytes == NULL || data == NULL || status == NULL || frames == NULL) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    long helper_mismatches = check_helpers();
+    printf("frame helpers:  %s%s\n", helper_mismatches == 0 ? "ok" : "mismatch",
+        MAX22X88_FRAME_TABLE ? " (tables)" : "");
+    printf("default kernel: %s\n", adi_max22x88_CodecKernelName(adi_max22x88_CodecGetKernel()));
+    printf("%-8s %12s %12s %12s %12s\n", "kernel", "check", "encode", "decode", "validate");
+    int rc = helper_mismatches != 0;
+    for (size_t k = 0; k < sizeof kernels / sizeof *kernels; k++) {
+        const char* name = adi_max22x88_CodecKernelName(kernels[k]);
+        if (only != NULL && strcmp(only, name) != 0) {
+            continue;
+        }
+        if (adi_max22x88_CodecSelectKernel(kernels[k]) != MAX22X88_ERR_OK) {
+            printf("%-8s %12s\n", name, "unsupported");
+            continue;
+        }
+
+        long mismatches = check_kernel(frames, data, status);
+        rc |= mismatches != 0;
+
+        for (long i = 0; i < count; i++) {
+            bytes[i] = (uint8_t)rand();
+        }
+        double best_encode = 1e9;
+        double best_decode = 1e9;
+        double best_validate = 1e9;
+        size_t errors = 0;
+        size_t first_error = 0;
+        for (long r = 0; r < rounds; r++) {
+            double t0 = now_s();
+            adi_max22x88_CodecEncode(bytes, frames, (size_t)count);
+            double t1 = now_s();
+            adi_max22x88_CodecDecode(frames, data, status, (size_t)count, &errors);
+            double t2 = now_s();
+            adi_max22x88_CodecValidate(frames, (size_t)count, &first_error);
+            double t3 = now_s();
+            best_encode = t1 - t0 < best_encode ? t1 - t0 : best_encode;
+            best_decode = t2 - t1 < best_decode ? t2 - t1 : best_decode;
+            best_validate = t3 - t2 < best_validate ? t3 - t2 : best_validate;
+        }
+        if (errors != 0 || first_error != (size_t)count || memcmp(bytes, data, (size_t)count) != 0) {
+            mismatches++;
+            rc = 1;
+        }
+
+        // Frame words are the larger side of the conversion, throughput is given in Gbyte/s of frame words
+        double gbytes = (double)count * sizeof *frames / 1e9;
+        char check[16];
+        snprintf(check, sizeof check, mismatches == 0 ? "ok" : "%ld bad", mismatches);
+        printf("%-8s %12s %7.2f GB/s %7.2f GB/s %7.2f GB/s\n", name, check,
+            gbytes / best_encode, gbytes / best_decode, gbytes / best_validate);
+    }
+
+    free(bytes);
+    free(data);
+    free(status);
+    free(frames);
+    return rc;
+}
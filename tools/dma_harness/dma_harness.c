@@ -0,0 +1,197 @@
+/*
+ * Copyright 2024 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file dma_harness.c
+ * Runs the bitbang IO layer with DMA transmission on the host HAL. Checks the DIN levels written by the DMA against
+ * the frame codec, the readback collation with an injected collision, and receives the transmitted frames back
+ * through the emulated signal timer.
+ */
+
+#define _DEFAULT_SOURCE
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "max22x88.h"
+#include "max22x88_bitbang.h"
+#include "private/bitbang_helper.h"
+#include "host_hal.h"
+
+#if !MAX22X88_BITBANG_DMA_TX || !MAX22X88_BITBANG_TRACE
+#error "Build with -DMAX22X88_BITBANG_DMA_TX=1 -DMAX22X88_BITBANG_TRACE=1"
+#endif
+
+#define DEFAULT_BYTES (40)
+#define DEFAULT_COLLISION (23)
+#define DEFAULT_BAUD (9600)
+#define DEFAULT_SEED (1)
+#define HALF_BITS_IN_FRAME (22)  // Start, 8 data, parity and stop bits, two half-bits each
+#define MAX_BYTES (1024)
+
+static void usage(const char* name)
+{
+    fprintf(stderr, "usage: %s [-n bytes] [-c half-bit] [-b baud] [-s seed]\n", name);
+    fprintf(stderr, "  -n            bytes transmitted, at most %d (default %d)\n", MAX_BYTES, DEFAULT_BYTES);
+    fprintf(stderr, "  -c            half-bit of the transmission where DOUT is forced low (default %d)\n", DEFAULT_COLLISION);
+    fprintf(stderr, "  -b            Home Bus baud rate (default %d)\n", DEFAULT_BAUD);
+    fprintf(stderr, "  -s            seed of the random bytes (default %d)\n", DEFAULT_SEED);
+}
+
+static void dout_falling_edge(void)
+{
+    adi_max22x88_FallingEdgeIntCallback();
+}
+
+// Returns the number of collation mismatches in the trace, and the half-bit index of the last collation mismatch in `index`
+static size_t count_mismatches(adi_max22x88_t* driver, uint16_t* index)
+{
+    static adi_max22x88_bitbang_TraceRecord_t records[MAX22X88_BITBANG_TRACE_LEN];
+    size_t count = 0;
+    size_t mismatches = 0;
+    adi_max22x88_DumpTraceBitbang(driver, records, MAX22X88_BITBANG_TRACE_LEN, &count);
+    for (size_t i = 0; i < count; i++) {
+        if (records[i].event == BITBANG_TRACE_COLLATION_MISMATCH) {
+            mismatches++;
+            *index = records[i].index;
+        }
+    }
+    return mismatches;
+}
+
+int main(int argc, char** argv)
+{
+    size_t bytes = DEFAULT_BYTES;
+    size_t collision = DEFAULT_COLLISION;
+    uint32_t baud = DEFAULT_BAUD;
+    unsigned seed = DEFAULT_SEED;
+    int opt;
+    while ((opt = getopt(argc, argv, "n:c:b:s:")) != -1) {
+        switch (opt) {
+            case 'n':
+                bytes = strtoul(optarg, NULL, 0);
+                break;
+            case 'c':
+                collision = strtoul(optarg, NULL, 0);
+                break;
+            case 'b':
+                baud = strtoul(optarg, NULL, 0);
+                break;
+            case 's':
+                seed = strtoul(optarg, NULL, 0);
+                break;
+            default:
+                usage(argv[0]);
+                return 2;
+        }
+    }
+    if (bytes == 0 || bytes > MAX_BYTES || collision >= bytes * HALF_BITS_IN_FRAME || baud == 0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    static uint8_t data[MAX_BYTES];
+    static uint8_t levels[MAX_BYTES * HALF_BITS_IN_FRAME];
+    srand(seed);
+    for (size_t i = 0; i < bytes; i++) {
+        data[i] = (uint8_t)rand();
+    }
+
+    adi_max22x88_t driver;
+    adi_max22x88_bitbang_InitParams_t params = {
+        .hbs_baud = baud,
+        .rx_mode = MAX22X88_RX_MODE_FRAMES,
+    };
+    if (adi_max22x88_InitBitbang(&driver, &params, (MAX_BYTES + 1) * sizeof(adi_max22x88_Frame_t)) != MAX22X88_ERR_OK) {
+        fprintf(stderr, "init failed\n");
+        return 1;
+    }
+    adi_max22x88_hal_HostGpioSetDoutCallback(dout_falling_edge);
+    int failed = 0;
+
+    // The DMA writes every half-bit of the frames formatted by the codec, DMA_TX_FRAMES frames per transfer
+    adi_max22x88_hal_HostDmaSetDinTrace(levels, sizeof levels);
+    unsigned long transfers = adi_max22x88_hal_HostDmaCompletionCount();
+    adi_max22x88_Transmit(&driver, data, bytes);
+    transfers = adi_max22x88_hal_HostDmaCompletionCount() - transfers;
+    size_t words = adi_max22x88_hal_HostDmaDinCount();
+    size_t wrong = 0;
+    for (size_t i = 0; i < bytes * HALF_BITS_IN_FRAME && i < words; i++) {
+        uint32_t frame = _format_frame_u32(data[i / HALF_BITS_IN_FRAME]);
+        if (levels[i] != ((frame >> (i % HALF_BITS_IN_FRAME)) & 1)) {
+            wrong++;
+        }
+    }
+    unsigned long expected_transfers = (bytes + MAX22X88_BITBANG_DMA_TX_FRAMES - 1) / MAX22X88_BITBANG_DMA_TX_FRAMES;
+    uint16_t index = 0;
+    size_t mismatches = count_mismatches(&driver, &index);
+    printf("tx: %zu bytes, %zu DIN words, %zu wrong, %lu transfers, %zu collation mismatches\n",
+        bytes, words, wrong, transfers, mismatches);
+    if (words != bytes * HALF_BITS_IN_FRAME || wrong != 0 || transfers != expected_transfers || mismatches != 0) {
+        failed = 1;
+    }
+
+    // Another node pulls the bus low during one half-bit. Only a half-bit written high can collide.
+    static uint8_t collided[MAX_BYTES * HALF_BITS_IN_FRAME];
+    adi_max22x88_hal_HostDmaSetDinTrace(collided, sizeof collided);
+    adi_max22x88_hal_HostDmaForceDoutLow(collision);
+    adi_max22x88_Transmit(&driver, data, bytes);
+    adi_max22x88_hal_HostDmaForceDoutLow(SIZE_MAX);
+    size_t expected_mismatches = levels[collision];
+    mismatches = count_mismatches(&driver, &index);
+    if (mismatches != 0) {
+        printf("collision: half-bit %zu of the transmission, reported at half-bit %u of the frame\n", collision, index);
+    } else {
+        printf("collision: half-bit %zu of the transmission is low, not reported\n", collision);
+    }
+    if (mismatches != expected_mismatches || (mismatches != 0 && index != collision % HALF_BITS_IN_FRAME)) {
+        failed = 1;
+    }
+
+    // Another node transmits the recorded levels, the driver receives them through the signal timer
+    uint32_t half_bit_ticks = HOST_BITBANG_CLOCK_HZ / (baud * 2);
+    unsigned long timer_ints = adi_max22x88_hal_HostTimerIntCount();
+    unsigned long gpio_ints = adi_max22x88_hal_HostGpioIntCount();
+    for (size_t i = 0; i < bytes * HALF_BITS_IN_FRAME; i++) {
+        adi_max22x88_hal_HostGpioSetBus(levels[i]);
+        adi_max22x88_hal_HostTimerAdvance(half_bit_ticks);
+    }
+    adi_max22x88_hal_HostGpioSetBus(1);
+    adi_max22x88_hal_HostTimerAdvance(HALF_BITS_IN_FRAME * half_bit_ticks);
+    timer_ints = adi_max22x88_hal_HostTimerIntCount() - timer_ints;
+    gpio_ints = adi_max22x88_hal_HostGpioIntCount() - gpio_ints;
+    size_t received = 0;
+    size_t bad = 0;
+    adi_max22x88_Frame_t frame;
+    while (adi_max22x88_ReadFrame(&driver, &frame) != MAX22X88_ERR_RX_BUFFER_EMPTY) {
+        if (received >= bytes || frame.status != MAX22X88_FRAME_OK || frame.data != data[received]) {
+            bad++;
+        }
+        received++;
+    }
+    printf("rx: %zu frames, %zu bad, %.1f timer and %.1f DOUT interrupts per frame\n",
+        received, bad, (double)timer_ints / bytes, (double)gpio_ints / bytes);
+    if (received != bytes || bad != 0) {
+        failed = 1;
+    }
+
+    adi_max22x88_Deinit(&driver);
+    printf("%s\n", failed ? "FAIL" : "OK");
+    return failed;
+}
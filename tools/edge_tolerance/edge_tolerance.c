@@ -0,0 +1,248 @@
+/*
+ * Copyright 2024 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file edge_tolerance.c
+ * Measures the baud rate mismatch and edge jitter tolerated by the edge decoder, with synthetic edge streams.
+ */
+
+#define _DEFAULT_SOURCE
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "max22x88.h"
+#include "private/bitbang_helper.h"
+#include "private/max22x88_edge_decoder.h"
+
+#define DEFAULT_FRAMES (20000)
+#define DEFAULT_BURST (16)
+#define DEFAULT_HALF_BIT (833)  // Ticks of a 16 MHz timer at 9600 baud
+#define DEFAULT_SEED (1)
+#define HALF_BITS_IN_FRAME (22)
+#define BURST_GAP_HALF_BITS (8)
+#define MAX_BURST (64)
+
+static const double grid_mismatch[] = { 0.0, 1.0, 2.0, 3.0, 3.5, 4.0, 5.0, 6.0 };
+static const double grid_jitter[] = { 0.0, 5.0, 10.0, 15.0, 20.0 };
+#define GRID_MISMATCHES (sizeof grid_mismatch / sizeof grid_mismatch[0])
+#define GRID_JITTERS (sizeof grid_jitter / sizeof grid_jitter[0])
+
+/** The tolerance stated in the README: no bad frame up to `mismatch` with edge jitter up to `jitter`. */
+static const struct {
+    double jitter;
+    double mismatch;
+} stated[] = {
+    { 0.0, 3.5 },
+    { 10.0, 2.0 },
+};
+
+typedef struct {
+    unsigned long frames;
+    unsigned long bad;
+} result_t;
+
+static uint64_t rng_state;
+
+static void usage(const char* name)
+{
+    fprintf(stderr, "usage: %s [-m mismatch] [-j jitter] [-n frames] [-b burst] [-t ticks] [-s seed]\n", name);
+    fprintf(stderr, "  -m            sender baud rate error in percent, both signs are run (default: grid)\n");
+    fprintf(stderr, "  -j            edge jitter in percent of a half-bit, uniform in +/- jitter (default: grid)\n");
+    fprintf(stderr, "  -n            frames per run (default %d)\n", DEFAULT_FRAMES);
+    fprintf(stderr, "  -b            frames per burst, at most %d (default %d)\n", MAX_BURST, DEFAULT_BURST);
+    fprintf(stderr, "  -t            ticks per half-bit at the receiver (default %d)\n", DEFAULT_HALF_BIT);
+    fprintf(stderr, "  -s            random seed (default %d)\n", DEFAULT_SEED);
+}
+
+static uint32_t rng_next(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return (uint32_t)(rng_state >> 32);
+}
+
+// Uniform in [-1, 1]
+static double rng_signed(void)
+{
+    return (double)rng_next() / 2147483647.5 - 1.0;
+}
+
+// Compares the frames decoded in a burst with the frames sent, position by position
+static unsigned long count_bad(const uint8_t* sent, size_t sent_cnt, const _adi_edge_dec_Result_t* got, size_t got_cnt)
+{
+    unsigned long bad = sent_cnt > got_cnt ? sent_cnt - got_cnt : got_cnt - sent_cnt;
+    for (size_t i = 0; i < sent_cnt && i < got_cnt; i++) {
+        if (got[i].status != MAX22X88_FRAME_OK || got[i].data != sent[i]) {
+            bad++;
+        }
+    }
+    return bad;
+}
+
+// Sends bursts of random frames, with the sender's baud rate `mismatch` higher and each edge moved by up to `jitter`
+// half-bits, and counts the frames the decoder loses or decodes wrong
+static result_t run(double mismatch, double jitter, unsigned long frames, size_t burst, uint32_t half_bit_ticks)
+{
+    _adi_edge_dec_t dec;
+    _adi_edge_dec_Init(&dec, half_bit_ticks, 0);
+    double sender_half_bit = half_bit_ticks / (1.0 + mismatch);
+    double t = 1000.0;
+    result_t result = { 0 };
+    uint8_t sent[MAX_BURST];
+    _adi_edge_dec_Result_t got[MAX_BURST * 2];
+
+    while (result.frames < frames) {
+        size_t sent_cnt = 0;
+        size_t got_cnt = 0;
+        bool level = true;
+        for (; sent_cnt < burst && result.frames < frames; sent_cnt++, result.frames++) {
+            sent[sent_cnt] = (uint8_t)rng_next();
+            uint32_t half_bits = _format_frame_u32(sent[sent_cnt]);
+            for (int i = 0; i < HALF_BITS_IN_FRAME; i++) {
+                bool next = (half_bits >> i) & 1;
+                if (next != level) {
+                    uint32_t timestamp = (uint32_t)llround(t + jitter * sender_half_bit * rng_signed());
+                    _adi_edge_dec_Result_t frame;
+                    if ((_adi_edge_dec_Edge(&dec, timestamp, next, &frame) & EDGE_DEC_FRAME) && got_cnt < MAX_BURST * 2) {
+                        got[got_cnt++] = frame;
+                    }
+                    level = next;
+                }
+                t += sender_half_bit;
+            }
+        }
+        // The bus stays idle between bursts, long enough for the decoder to complete the last frame
+        t += BURST_GAP_HALF_BITS * sender_half_bit;
+        _adi_edge_dec_Result_t frame;
+        if ((_adi_edge_dec_Poll(&dec, (uint32_t)llround(t), &frame) & EDGE_DEC_FRAME) && got_cnt < MAX_BURST * 2) {
+            got[got_cnt++] = frame;
+        }
+        result.bad += count_bad(sent, sent_cnt, got, got_cnt);
+    }
+    return result;
+}
+
+int main(int argc, char** argv)
+{
+    double mismatch = -1.0;
+    double jitter = -1.0;
+    unsigned long frames = DEFAULT_FRAMES;
+    size_t burst = DEFAULT_BURST;
+    uint32_t half_bit_ticks = DEFAULT_HALF_BIT;
+    unsigned long seed = DEFAULT_SEED;
+    int opt;
+    while ((opt = getopt(argc, argv, "m:j:n:b:t:s:")) != -1) {
+        switch (opt) {
+            case 'm':
+                mismatch = strtod(optarg, NULL);
+                break;
+            case 'j':
+                jitter = strtod(optarg, NULL);
+                break;
+            case 'n':
+                frames = strtoul(optarg, NULL, 0);
+                break;
+            case 'b':
+                burst = strtoul(optarg, NULL, 0);
+                break;
+            case 't':
+                half_bit_ticks = strtoul(optarg, NULL, 0);
+                break;
+            case 's':
+                seed = strtoul(optarg, NULL, 0);
+                break;
+            default:
+                usage(argv[0]);
+                return 2;
+        }
+    }
+    if (frames == 0 || burst == 0 || burst > MAX_BURST || half_bit_ticks < 8 || (mismatch < 0.0) != (jitter < 0.0)) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    if (mismatch >= 0.0) {
+        // A single point, the tool fails if a frame is bad
+        unsigned long bad = 0;
+        for (int sign = -1; sign <= 1; sign += 2) {
+            rng_state = seed * 0x9E3779B97F4A7C15ull + 1;
+            result_t r = run(sign * mismatch / 100.0, jitter / 100.0, frames, burst, half_bit_ticks);
+            printf("mismatch %+.1f%%, jitter %.1f%%: %lu of %lu frames bad\n", sign * mismatch, jitter, r.bad, r.frames);
+            bad += r.bad;
+        }
+        return bad != 0;
+    }
+
+    // The grid, bad frames of the worse sign at each point. The tool fails if a point within the stated tolerance has
+    // bad frames.
+    printf("bad frames out of %lu, worse of +/- mismatch, by edge jitter\n\n", frames);
+    printf("%-10s", "mismatch");
+    for (size_t j = 0; j < GRID_JITTERS; j++) {
+        char label[16];
+        snprintf(label, sizeof label, "%.0f%%", grid_jitter[j]);
+        printf(" %8s", label);
+    }
+    printf("\n");
+    int failed = 0;
+    double clean[GRID_JITTERS];
+    for (size_t j = 0; j < GRID_JITTERS; j++) {
+        clean[j] = -1.0;
+    }
+    bool still_clean[GRID_JITTERS];
+    memset(still_clean, true, sizeof still_clean);
+    for (size_t m = 0; m < GRID_MISMATCHES; m++) {
+        char label[16];
+        snprintf(label, sizeof label, "+/-%.1f%%", grid_mismatch[m]);
+        printf("%-10s", label);
+        for (size_t j = 0; j < GRID_JITTERS; j++) {
+            unsigned long worst = 0;
+            for (int sign = -1; sign <= 1; sign += 2) {
+                rng_state = seed * 0x9E3779B97F4A7C15ull + 1;
+                result_t r = run(sign * grid_mismatch[m] / 100.0, grid_jitter[j] / 100.0, frames, burst, half_bit_ticks);
+                if (r.bad > worst) {
+                    worst = r.bad;
+                }
+            }
+            printf(" %8lu", worst);
+            for (size_t k = 0; k < sizeof stated / sizeof stated[0]; k++) {
+                if (worst != 0 && grid_jitter[j] <= stated[k].jitter && grid_mismatch[m] <= stated[k].mismatch) {
+                    failed = 1;
+                }
+            }
+            if (worst != 0) {
+                still_clean[j] = false;
+            } else if (still_clean[j]) {
+                clean[j] = grid_mismatch[m];
+            }
+        }
+        printf("\n");
+    }
+    printf("\n");
+    for (size_t j = 0; j < GRID_JITTERS; j++) {
+        if (clean[j] < 0.0) {
+            printf("jitter %4.1f%%: bad frames even without mismatch\n", grid_jitter[j]);
+        } else {
+            printf("jitter %4.1f%%: no bad frame up to +/-%.1f%% mismatch\n", grid_jitter[j], clean[j]);
+        }
+    }
+    return failed;
+}
@@ -0,0 +1,240 @@
+/*
+ * Copyright 2024 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file la_decode.c
+ * Decodes a logic analyzer capture of DOUT into Home Bus packets.
+ */
+
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "max22x88_la_decoder.h"
+#include "max22x88_capture.h"
+#include "homebus.h"
+
+#define DEFAULT_SAMPLE_RATE (1000000)
+#define DEFAULT_BAUD (9600)
+#define DEFAULT_IDLE_GAP_BITS (2)
+#define CAPTURE_TICK_HZ (1000000)
+#define CAPTURE_BUFFER_LEN (65536)
+
+static uint64_t packet_ns;  // Time of the first frame of the packet being parsed
+static unsigned long packets;
+
+static void usage(const char* name)
+{
+    fprintf(stderr, "usage: %s [-c] [-s rate] [-b baud] [-k column] [-g bits] [-t threads] [-f] [-q] [-w output] capture\n", name);
+    fprintf(stderr, "  -c            the capture is CSV, instead of packed samples\n");
+    fprintf(stderr, "  -s            samples per second of a packed capture (default %d)\n", DEFAULT_SAMPLE_RATE);
+    fprintf(stderr, "  -b            Home Bus baud rate (default %d)\n", DEFAULT_BAUD);
+    fprintf(stderr, "  -k            CSV level column holding DOUT, 0 is the first after the time (default 0)\n");
+    fprintf(stderr, "  -g            idle bit-times ending a burst, 0 to ignore bursts (default %d)\n", DEFAULT_IDLE_GAP_BITS);
+    fprintf(stderr, "  -t            threads, 0 for one per CPU (default 0)\n");
+    fprintf(stderr, "  -f            print every frame\n");
+    fprintf(stderr, "  -q            only print the statistics\n");
+    fprintf(stderr, "  -w            also write the frames to a capture file, see max22x88_capture.h\n");
+}
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static void print_time(uint64_t ns)
+{
+    printf("%4" PRIu64 ".%09" PRIu64, ns / 1000000000u, ns % 1000000000u);
+}
+
+static bool write_capture(void* ctx, const uint8_t* data, size_t len)
+{
+    return fwrite(data, 1, len, ctx) == len;
+}
+
+// Converts the frames into a capture that capture_replay can feed to the driver, timestamped in microseconds
+static bool save_capture(const char* path, const adi_max22x88_la_Result_t* result)
+{
+    FILE* file = fopen(path, "wb");
+    if (file == NULL) {
+        return false;
+    }
+    static uint8_t buf[CAPTURE_BUFFER_LEN];
+    adi_max22x88_CaptureWriter_t writer;
+    adi_max22x88_CaptureWriterInit(&writer, buf, sizeof buf, CAPTURE_TICK_HZ, NULL, write_capture, file);
+    for (size_t i = 0; i < result->count; i++) {
+        const adi_max22x88_la_Event_t* event = &result->events[i];
+        adi_max22x88_Frame_t frame = {
+            .timestamp = (uint32_t)(event->time_ns / (1000000000u / CAPTURE_TICK_HZ)),
+            .data = event->data,
+            .status = event->type == MAX22X88_LA_EVENT_END_OF_BURST ? MAX22X88_FRAME_END_OF_BURST : event->status
+        };
+        adi_max22x88_CaptureRecord(&writer, MAX22X88_RECORD_RX, &frame);
+    }
+    bool ok = adi_max22x88_CaptureWriterFlush(&writer) == MAX22X88_ERR_OK && writer.dropped == 0;
+    return fclose(file) == 0 && ok;
+}
+
+static hbs_err_e print_packet(adi_hbs_t* hbs, adi_hbs_Packet_t* packet)
+{
+    (void)hbs;
+    packets++;
+    if (packet_ns == UINT64_MAX) {
+        return HBS_ERR_OK;
+    }
+    print_time(packet_ns);
+    printf("  %02x -> %02x  op %02x  len %3u ", packet->self_addr, packet->dest_addr, packet->operation, packet->len);
+    for (unsigned int i = 0; i < packet->len; i++) {
+        printf(" %02x", packet->data[i]);
+    }
+    printf("\n");
+    return HBS_ERR_OK;
+}
+
+int main(int argc, char** argv)
+{
+    adi_max22x88_la_Params_t params = {
+        .format = MAX22X88_LA_FORMAT_PACKED,
+        .sample_rate = DEFAULT_SAMPLE_RATE,
+        .column = 0,
+        .hbs_baud = DEFAULT_BAUD,
+        .idle_gap_bits = DEFAULT_IDLE_GAP_BITS,
+        .threads = 0
+    };
+    bool frames = false;
+    bool quiet = false;
+    const char* output = NULL;
+    int opt;
+    while ((opt = getopt(argc, argv, "cs:b:k:g:t:fqw:")) != -1) {
+        switch (opt) {
+        case 'c':
+            params.format = MAX22X88_LA_FORMAT_CSV;
+            break;
+        case 's':
+            params.sample_rate = strtoull(optarg, NULL, 0);
+            break;
+        case 'b':
+            params.hbs_baud = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 'k':
+            params.column = (unsigned int)strtoul(optarg, NULL, 0);
+            break;
+        case 'g':
+            params.idle_gap_bits = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 't':
+            params.threads = (unsigned int)strtoul(optarg, NULL, 0);
+            break;
+        case 'f':
+            frames = true;
+            break;
+        case 'q':
+            quiet = true;
+            break;
+        case 'w':
+            output = optarg;
+            break;
+        default:
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (optind != argc - 1) {
+        usage(argv[0]);
+        return 1;
+    }
+    const char* path = argv[optind];
+
+    double start = now_s();
+    adi_max22x88_la_Result_t result;
+    adi_max22x88_Result_e err = adi_max22x88_LaDecodeFile(path, &params, &result);
+    double elapsed = now_s() - start;
+    if (err == MAX22X88_ERR_USER_FN) {
+        perror(path);
+        return 1;
+    } else if (err != MAX22X88_ERR_OK) {
+        fprintf(stderr, "cannot decode %s: %s\n", path, err == MAX22X88_ERR_BAD_PARAM ? "bad parameters" : "out of memory");
+        return 1;
+    }
+
+    if (output != NULL && !save_capture(output, &result)) {
+        perror(output);
+        return 1;
+    }
+
+    // Every packet on the bus is parsed, whatever its destination
+    adi_hbs_t hbs;
+    adi_hbs_Init(&hbs, 0, NULL, NULL);
+    for (unsigned int addr = 0; addr < 256; addr++) {
+        adi_hbs_AcceptAddr(&hbs, (uint8_t)addr, true);
+    }
+    adi_hbs_SetBurstDelimited(&hbs, params.idle_gap_bits > 0);
+    adi_hbs_RegisterRxCb(&hbs, print_packet);
+
+    unsigned long valid = 0;
+    unsigned long bad = 0;
+    unsigned long bursts = 0;
+    for (size_t i = 0; i < result.count; i++) {
+        const adi_max22x88_la_Event_t* event = &result.events[i];
+        if (event->type == MAX22X88_LA_EVENT_END_OF_BURST) {
+            bursts++;
+            adi_hbs_EndOfBurst(&hbs);
+            continue;
+        }
+        if (frames && !quiet) {
+            print_time(event->time_ns);
+            printf("  frame %02x%s%s%s%s\n", event->data,
+                (event->status & MAX22X88_FRAME_ERR_START) ? " start" : "",
+                (event->status & MAX22X88_FRAME_ERR_STOP) ? " stop" : "",
+                (event->status & MAX22X88_FRAME_ERR_OFFDUTY) ? " off-duty" : "",
+                (event->status & MAX22X88_FRAME_ERR_PARITY) ? " parity" : "");
+        }
+        if (event->status != MAX22X88_FRAME_OK) {
+            bad++;
+            adi_hbs_ReceivedError(&hbs);
+            continue;
+        }
+        valid++;
+        if (hbs.rx_state == HBS_RX_STATE_WAIT_FOR_SELF_ADDR) {
+            packet_ns = quiet ? UINT64_MAX : event->time_ns;
+        }
+        adi_hbs_Received(&hbs, event->data);
+    }
+
+    struct stat st;
+    double size = stat(path, &st) == 0 ? (double)st.st_size : 0.0;
+    double samples = params.format == MAX22X88_LA_FORMAT_PACKED ? size * 8 : 0.0;
+    fprintf(stderr, "capture:    %.6f s, %" PRIu64 " edges, decoded in %u parts\n",
+        (double)result.duration_ns / 1e9, result.edges, result.segments);
+    fprintf(stderr, "frames:     %lu valid, %lu with errors, %lu bursts\n", valid, bad, bursts);
+    fprintf(stderr, "packets:    %lu, %u dropped\n", packets, hbs.dropped_pkt_cnt);
+    fprintf(stderr, "decoding:   %.3f s, %.0f Mbyte/s", elapsed, size / elapsed / 1e6);
+    if (samples > 0.0) {
+        fprintf(stderr, ", %.0f Msamples/s", samples / elapsed / 1e6);
+    }
+    fprintf(stderr, "\n");
+
+    adi_max22x88_LaFreeResult(&result);
+    return 0;
+}
@@ -0,0 +1,261 @@
+/*
+ * Copyright 2024 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file linux_loopback.c
+ * Measures the throughput and latency of the Linux IO layer over a pseudo-terminal loopback, with a peer checking the
+ * start, parity and stop bits of the port against the Home Bus frame codec.
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <dlfcn.h>
+#include <pthread.h>
+#include <pty.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "max22x88_linux.h"
+#include "private/bitbang_helper.h"
+
+#define DEFAULT_COUNT (1000)
+#define DEFAULT_LEN (32)
+#define DEFAULT_BAUD (9600)
+#define MAX_LEN (256)
+#define TIMEOUT_NS (1000000000LL)
+
+static int peer_fd = -1;
+static int slave_fd = -1;
+static tcflag_t port_cflag;  // Control modes the driver set on its port
+static unsigned long peer_frames;
+static unsigned long peer_rx_rejected;  // Characters of the driver whose start, parity or stop bit the codec rejects
+static unsigned long peer_tx_rejected;  // Frames of the codec whose start, parity or stop bit the port would reject
+
+static void usage(const char* name)
+{
+    fprintf(stderr, "usage: %s [-n count] [-l len] [-b baud]\n", name);
+    fprintf(stderr, "  -n            transmissions to measure (default %d)\n", DEFAULT_COUNT);
+    fprintf(stderr, "  -l            bytes per transmission, up to %d (default %d)\n", MAX_LEN, DEFAULT_LEN);
+    fprintf(stderr, "  -b            baud rate set on the serial port (default %d)\n", DEFAULT_BAUD);
+}
+
+static int64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// Returns the bits a UART configured with `cflag` sends for a byte, LSB-first: start, data, parity and stop bits
+static uint32_t uart_char_bits(uint8_t value, tcflag_t cflag)
+{
+    uint32_t bits = (uint32_t)value << 1;
+    if (cflag & PARENB) {
+        uint32_t parity = (uint32_t)__builtin_parity(value) ^ ((cflag & PARODD) ? 1 : 0);
+        return bits | (parity << 9) | (1u << 10);
+    }
+    return bits | (1u << 9) | (1u << 10);  // The next bit is already idle
+}
+
+// Returns the Home Bus frame with these bits in its on-duty half-bits. The off-duty half-bits are set as the codec
+// expects them: a UART line is NRZ, so only the polarity of the bits is compared.
+static uint32_t line_bits_to_frame(uint32_t bits)
+{
+    uint32_t frame = 0;
+    for (int i = 0; i < 11; i++) {
+        frame |= (((bits >> i) & 1) << (2 * i)) | (1u << (2 * i + 1));
+    }
+    return frame;
+}
+
+// Returns the on-duty half-bits of a Home Bus frame
+static uint32_t frame_to_line_bits(uint32_t frame)
+{
+    uint32_t bits = 0;
+    for (int i = 0; i < 11; i++) {
+        bits |= ((frame >> (2 * i)) & 1) << i;
+    }
+    return bits;
+}
+
+// Records the control modes the driver sets on its port. Linux pseudo-terminals clear PARENB and CSIZE, so
+// tcgetattr doesn't return them.
+int tcsetattr(int fd, int optional_actions, const struct termios* tio)
+{
+    static int (*next)(int, int, const struct termios*) = NULL;
+    if (next == NULL) {
+        next = (int (*)(int, int, const struct termios*))dlsym(RTLD_NEXT, "tcsetattr");
+    }
+    if (fd == slave_fd && fd >= 0) {
+        port_cflag = tio->c_cflag;
+    }
+    return next(fd, optional_actions, tio);
+}
+
+// Sends back the characters received, and checks that the start, parity and stop bits of the driver's port match the
+// Home Bus frame codec both ways. The pseudo-terminal only carries the data, so the bits of each character are rebuilt
+// from the settings of the port.
+static void* echo_peer(void* arg)
+{
+    uint8_t buf[MAX_LEN];
+    for (;;) {
+        ssize_t n = read(peer_fd, buf, sizeof buf);
+        if (n <= 0) {
+            break;
+        }
+        for (ssize_t i = 0; i < n; i++) {
+            uint8_t data;
+            uint8_t status = _parse_frame_u32(line_bits_to_frame(uart_char_bits(buf[i], port_cflag)), &data);
+            if (status != MAX22X88_FRAME_OK || data != buf[i]) {
+                peer_rx_rejected++;
+            }
+            uint32_t frame = _format_frame_u32(data);
+            if (frame_to_line_bits(frame) != uart_char_bits(data, port_cflag)) {
+                peer_tx_rejected++;
+            }
+            buf[i] = data;
+            peer_frames++;
+        }
+        for (ssize_t off = 0; off < n; ) {
+            ssize_t w = write(peer_fd, buf + off, (size_t)(n - off));
+            if (w <= 0) {
+                return arg;
+            }
+            off += w;
+        }
+    }
+    return arg;
+}
+
+int main(int argc, char** argv)
+{
+    long count = DEFAULT_COUNT;
+    long len = DEFAULT_LEN;
+    long baud = DEFAULT_BAUD;
+    int opt;
+    while ((opt = getopt(argc, argv, "n:l:b:")) != -1) {
+        switch (opt) {
+        case 'n':
+            count = strtol(optarg, NULL, 0);
+            break;
+        case 'l':
+            len = strtol(optarg, NULL, 0);
+            break;
+        case 'b':
+            baud = strtol(optarg, NULL, 0);
+            break;
+        default:
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (count <= 0 || len <= 0 || len > MAX_LEN || baud <= 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    if (openpty(&peer_fd, &slave_fd, NULL, NULL, NULL) != 0) {
+        perror("openpty");
+        return 1;
+    }
+    // The peer side only passes bytes through
+    struct termios tio;
+    tcgetattr(peer_fd, &tio);
+    cfmakeraw(&tio);
+    tcsetattr(peer_fd, TCSANOW, &tio);
+
+    adi_max22x88_t driver;
+    adi_max22x88_linux_InitParams_t params = {
+        .fd = slave_fd,
+        .hbs_baud = (uint32_t)baud,
+        .rx_mode = MAX22X88_RX_MODE_BYTES,
+        .rst_line = MAX22X88_LINUX_RST_NONE,
+        .drop_echo = false
+    };
+    if (adi_max22x88_InitLinux(&driver, &params, 4 * MAX_LEN) != MAX22X88_ERR_OK) {
+        fprintf(stderr, "cannot initialize the driver\n");
+        return 1;
+    }
+
+    pthread_t peer;
+    pthread_create(&peer, NULL, echo_peer, NULL);
+
+    uint8_t tx[MAX_LEN];
+    uint8_t rx[MAX_LEN];
+    int64_t lat_min = INT64_MAX;
+    int64_t lat_max = 0;
+    int64_t lat_sum = 0;
+    long errors = 0;
+    int64_t start = now_ns();
+    for (long i = 0; i < count; i++) {
+        for (long j = 0; j < len; j++) {
+            tx[j] = (uint8_t)(i + j);
+        }
+
+        int64_t sent = now_ns();
+        if (adi_max22x88_Transmit(&driver, tx, (size_t)len) != MAX22X88_ERR_OK) {
+            fprintf(stderr, "transmission %ld failed\n", i);
+            return 1;
+        }
+        size_t received = 0;
+        while (received < (size_t)len) {
+            size_t n = 0;
+            adi_max22x88_ReadN(&driver, &rx[received], (size_t)len - received, &n);
+            received += n;
+            if (n == 0) {
+                if (now_ns() - sent > TIMEOUT_NS) {
+                    fprintf(stderr, "transmission %ld: received %zu of %ld bytes\n", i, received, len);
+                    return 1;
+                }
+                sched_yield();
+            }
+        }
+        int64_t latency = now_ns() - sent;
+
+        if (memcmp(tx, rx, (size_t)len) != 0) {
+            errors++;
+        }
+        lat_sum += latency;
+        if (latency < lat_min) {
+            lat_min = latency;
+        }
+        if (latency > lat_max) {
+            lat_max = latency;
+        }
+    }
+    double elapsed = (double)(now_ns() - start) / 1e9;
+
+    adi_max22x88_linux_Stats_t stats;
+    adi_max22x88_GetStatsLinux(&driver, &stats);
+    adi_max22x88_DeinitLinux(&driver);
+    close(peer_fd);
+    pthread_join(peer, NULL);
+
+    printf("transmissions: %ld of %ld bytes, %ld corrupted\n", count, len, errors);
+    printf("throughput:    %.0f bytes/s each way\n", (double)(count * len) / elapsed);
+    printf("round trip:    min %.1f us, avg %.1f us, max %.1f us\n",
+        lat_min / 1e3, (double)lat_sum / count / 1e3, lat_max / 1e3);
+    printf("driver:        rx %" PRIu32 " tx %" PRIu32 " errors %" PRIu32 " overflows %" PRIu32 "\n",
+        stats.rx_bytes, stats.tx_bytes, stats.rx_errors, stats.rx_overflows);
+    printf("peer frames:   %lu, %lu with bits the codec rejects, %lu with bits the port rejects\n",
+        peer_frames, peer_rx_rejected, peer_tx_rejected);
+    return errors != 0 || peer_rx_rejected != 0 || peer_tx_rejected != 0;
+}
@@ -0,0 +1,248 @@
+/*
+ * Copyright 2024 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file monitor_bench.c
+ * Measures the sustained throughput of the protocol stack's monitor mode on the host, and of a normal node for
+ * comparison.
+ */
+
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "homebus.h"
+
+#define DEFAULT_PACKETS (1000000)
+#define DEFAULT_MAX_LEN (32)
+#define DEFAULT_CHUNK (32)
+#define DEFAULT_RING (64)
+#define DEFAULT_DRAIN (16)
+#define DEFAULT_ROUNDS (5)
+#define NODE_ADDR (0x01)
+
+typedef struct {
+    const uint8_t* stream;  // The packets, back to back
+    const size_t* offsets;  // Offset of each packet in the stream
+    size_t next;  // Next packet expected
+    unsigned long mismatches;
+    unsigned long batches;
+} check_t;
+
+static void usage(const char* name)
+{
+    fprintf(stderr, "usage: %s [-m mode] [-n packets] [-l len] [-c chunk] [-r ring] [-d chunks] [-k rounds]\n", name);
+    fprintf(stderr, "  -m            monitor: every packet is stored in the monitor ring (default)\n");
+    fprintf(stderr, "                normal: a node receives the packets sent to it, for comparison\n");
+    fprintf(stderr, "  -n            packets per round (default %d)\n", DEFAULT_PACKETS);
+    fprintf(stderr, "  -l            longest payload, lengths are random up to it (default %d)\n", DEFAULT_MAX_LEN);
+    fprintf(stderr, "  -c            bytes passed to adi_hbs_ReceivedN at once, 1 uses adi_hbs_Received (default %d)\n", DEFAULT_CHUNK);
+    fprintf(stderr, "  -r            records in the monitor ring (default %d)\n", DEFAULT_RING);
+    fprintf(stderr, "  -d            chunks received between two drains of the ring (default %d)\n", DEFAULT_DRAIN);
+    fprintf(stderr, "  -k            rounds measured, the fastest one is reported (default %d)\n", DEFAULT_ROUNDS);
+}
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static unsigned long node_packets;
+
+static hbs_err_e count_packet(adi_hbs_t* hbs, adi_hbs_Packet_t* packet)
+{
+    node_packets++;
+    return HBS_ERR_OK;
+}
+
+#if HBS_CONFIG_MONITOR
+static uint32_t clock_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u);
+}
+
+// Compares the records with the packets sent, as a sink would copy them out
+static hbs_err_e check_records(adi_hbs_t* hbs, const adi_hbs_MonitorRecord_t* records, size_t count, void* ctx)
+{
+    check_t* check = ctx;
+    check->batches++;
+    for (size_t i = 0; i < count; i++) {
+        const adi_hbs_MonitorRecord_t* record = &records[i];
+        const uint8_t* expected = &check->stream[check->offsets[check->next++]];
+        if (record->status != HBS_MONITOR_COMPLETE || record->received != HBS_HEADER_SIZE + expected[3]
+            || memcmp(&record->packet, expected, HBS_HEADER_SIZE + expected[3]) != 0) {
+            check->mismatches++;
+        }
+    }
+    return HBS_ERR_OK;
+}
+#endif
+
+int main(int argc, char** argv)
+{
+    bool monitor = true;
+    long packets = DEFAULT_PACKETS;
+    long max_len = DEFAULT_MAX_LEN;
+    long chunk = DEFAULT_CHUNK;
+    long ring_len = DEFAULT_RING;
+    long drain = DEFAULT_DRAIN;
+    long rounds = DEFAULT_ROUNDS;
+    int opt;
+    while ((opt = getopt(argc, argv, "m:n:l:c:r:d:k:")) != -1) {
+        switch (opt) {
+        case 'm':
+            if (strcmp(optarg, "monitor") == 0) {
+                monitor = true;
+            } else if (strcmp(optarg, "normal") == 0) {
+                monitor = false;
+            } else {
+                usage(argv[0]);
+                return 1;
+            }
+            break;
+        case 'n':
+            packets = strtol(optarg, NULL, 0);
+            break;
+        case 'l':
+            max_len = strtol(optarg, NULL, 0);
+            break;
+        case 'c':
+            chunk = strtol(optarg, NULL, 0);
+            break;
+        case 'r':
+            ring_len = strtol(optarg, NULL, 0);
+            break;
+        case 'd':
+            drain = strtol(optarg, NULL, 0);
+            break;
+        case 'k':
+            rounds = strtol(optarg, NULL, 0);
+            break;
+        default:
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (packets <= 0 || max_len < 0 || max_len > HBS_MAX_DATA_LEN || chunk <= 0 || ring_len <= 0 || drain <= 0 || rounds <= 0) {
+        usage(argv[0]);
+        return 1;
+    }
+#if !HBS_CONFIG_MONITOR
+    if (monitor) {
+        fprintf(stderr, "the monitor mode isn't built, rebuild with -DHBS_CONFIG_MONITOR=1 or use -m normal\n");
+        return 1;
+    }
+#endif
+
+    // Packets to random addresses, a few of them to the node
+    uint8_t* stream = malloc((size_t)packets * (HBS_HEADER_SIZE + (size_t)max_len));
+    size_t* offsets = malloc((size_t)packets * sizeof *offsets);
+    if (stream == NULL || offsets == NULL) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    size_t len = 0;
+    srand(1);
+    for (long i = 0; i < packets; i++) {
+        uint8_t payload_len = (uint8_t)(rand() % (max_len + 1));
+        offsets[i] = len;
+        stream[len++] = (uint8_t)rand();
+        stream[len++] = (uint8_t)rand();
+        stream[len++] = (uint8_t)rand();
+        stream[len++] = payload_len;
+        for (uint8_t j = 0; j < payload_len; j++) {
+            stream[len++] = (uint8_t)rand();
+        }
+    }
+
+    adi_hbs_t hbs;
+    adi_hbs_Init(&hbs, NODE_ADDR, NULL, NULL);
+    adi_hbs_RegisterRxCb(&hbs, count_packet);
+#if HBS_CONFIG_MONITOR
+    adi_hbs_MonitorRecord_t* ring = malloc((size_t)ring_len * sizeof *ring);
+    if (ring == NULL) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+#endif
+
+    double best = 0.0;
+    unsigned long mismatches = 0;
+    unsigned long dropped = 0;
+    unsigned long batches = 0;
+    for (long round = 0; round < rounds; round++) {
+        node_packets = 0;
+#if HBS_CONFIG_MONITOR
+        check_t check = {
+            .stream = stream,
+            .offsets = offsets
+        };
+        long chunks = 0;
+        adi_hbs_SetMonitor(&hbs, monitor ? ring : NULL, monitor ? (size_t)ring_len : 0, clock_us);
+        hbs.monitor_dropped_cnt = 0;
+#endif
+
+        double start = now_s();
+        for (size_t offset = 0; offset < len; offset += (size_t)chunk) {
+            size_t n = len - offset < (size_t)chunk ? len - offset : (size_t)chunk;
+            if (chunk == 1) {
+                adi_hbs_Received(&hbs, stream[offset]);
+            } else {
+                adi_hbs_ReceivedN(&hbs, &stream[offset], n, NULL);
+            }
+#if HBS_CONFIG_MONITOR
+            if (monitor && ++chunks == drain) {
+                adi_hbs_DrainMonitor(&hbs, check_records, &check);
+                chunks = 0;
+            }
+#endif
+        }
+#if HBS_CONFIG_MONITOR
+        if (monitor) {
+            adi_hbs_DrainMonitor(&hbs, check_records, &check);
+            // Dropped packets can't be matched, only the records up to the first drop are checked
+            dropped = hbs.monitor_dropped_cnt;
+            mismatches = dropped == 0 ? check.mismatches + (unsigned long)packets - check.next : 0;
+            batches = check.batches;
+        }
+#endif
+        double elapsed = now_s() - start;
+        if (round == 0 || elapsed < best) {
+            best = elapsed;
+        }
+    }
+
+    double mbytes = (double)len / 1e6;
+    printf("mode:        %s, %ld packets, %.1f Mbyte\n", monitor ? "monitor" : "normal", packets, mbytes);
+    if (monitor) {
+        printf("monitor:     %lu batches, %lu dropped, %lu mismatches\n", batches, dropped, mismatches);
+    } else {
+        printf("node:        %lu packets received\n", node_packets);
+    }
+    printf("throughput:  %.1f Mpackets/s, %.0f Mbyte/s\n", (double)packets / best / 1e6, mbytes / best);
+
+    free(stream);
+    free(offsets);
+    return monitor && (dropped != 0 || mismatches != 0);
+}
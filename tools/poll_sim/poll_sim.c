@@ -0,0 +1,429 @@
+/*
+ * Copyright 2024 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file poll_sim.c
+ * Simulates a master polling a set of slaves on a shared bus, with the polling scheduler and the transaction layer
+ * of the protocol stack on the master and the protocol stack on every slave, and compares serialized and pipelined
+ * polling.
+ */
+
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "homebus_poll.h"
+
+#define DEFAULT_SLAVES (32)
+#define DEFAULT_TURNAROUND (100)
+#define DEFAULT_LEN (8)
+#define DEFAULT_SLOTS (8)
+#define DEFAULT_TIMEOUT (4000)
+#define DEFAULT_DURATION (1000000)
+#define MAX_SLAVES (200)
+#define MASTER_ADDR (0x01)
+#define FIRST_SLAVE_ADDR (0x10)
+#define REQUEST_CODE (0x10)
+#define RESPONSE_CODE (0x11)
+// Bit-times of a frame: start bit, 8 data bits, parity bit and stop bit
+#define FRAME_BITS (11)
+#define MAX_PACKET (HBS_HEADER_SIZE + HBS_MAX_DATA_LEN)
+
+typedef enum {
+    MODE_SERIALIZED,
+    MODE_PIPELINED,
+    MODE_UNGATED,
+    MODE_COMPARE
+} mode_e;
+
+typedef struct {
+    long slave_cnt;
+    long slot_cnt;
+    long timeout;
+    long dead;
+    long duration;
+} params_t;
+
+typedef struct {
+    adi_hbs_t hbs;
+    adi_hbs_Packet_t pool[2];
+    adi_hbs_OpHandler_t op_handlers[REQUEST_CODE + 1];
+    uint8_t tx[MAX_PACKET];  // Response waiting for the bus
+    size_t tx_len;
+    uint32_t ready_at;  // Tick the response is ready, after the turnaround
+    bool dead;  // Never answers
+} slave_t;
+
+// A transmission on the bus, from start to start + len * FRAME_BITS
+typedef struct {
+    uint8_t data[MAX_PACKET];
+    size_t len;
+    uint32_t start;
+    uint32_t end;
+    int sender;  // Slave index, -1 for the master
+    bool collided;
+} transmission_t;
+
+static struct {
+    uint32_t now;
+    long turnaround;
+    long len;
+    bool verbose;
+    slave_t* slaves;
+    long slave_cnt;
+    adi_hbs_t master;
+    adi_hbs_Txn_t txn;
+    transmission_t active[MAX_SLAVES + 1];
+    size_t active_cnt;
+    unsigned long busy_ticks;
+    unsigned long requests;
+    unsigned long responses;
+    unsigned long collisions;
+    unsigned long interleaved;  // Requests sent while an earlier response was outstanding
+    unsigned long answered;
+} sim;
+
+static void usage(const char* name)
+{
+    fprintf(stderr, "usage: %s [-m mode] [-n slaves] [-t turnaround] [-l len] [-s slots] [-w timeout] [-x dead] [-d duration] [-v]\n", name);
+    fprintf(stderr, "  -m            serialized: a poll is sent once the previous one is answered (default)\n");
+    fprintf(stderr, "                pipelined: a poll is sent whenever the bus is idle\n");
+    fprintf(stderr, "                ungated: every due poll is sent at once, whatever the bus state\n");
+    fprintf(stderr, "                compare: serialized, then pipelined, and the ratio of their poll cycles\n");
+    fprintf(stderr, "  -n            slaves polled (default %d)\n", DEFAULT_SLAVES);
+    fprintf(stderr, "  -t            bit-times a slave takes to answer a request (default %d)\n", DEFAULT_TURNAROUND);
+    fprintf(stderr, "  -l            response payload bytes after the sequence byte (default %d)\n", DEFAULT_LEN);
+    fprintf(stderr, "  -s            transaction slots, the most polls in flight (default %d)\n", DEFAULT_SLOTS);
+    fprintf(stderr, "  -w            poll timeout in bit-times (default %d)\n", DEFAULT_TIMEOUT);
+    fprintf(stderr, "  -x            slaves, among the first ones, that never answer (default 0)\n");
+    fprintf(stderr, "  -d            bit-times simulated (default %d)\n", DEFAULT_DURATION);
+    fprintf(stderr, "  -v            print every transmission\n");
+}
+
+static bool bus_idle(void* ctx)
+{
+    return sim.active_cnt == 0;
+}
+
+static bool bus_always_idle(void* ctx)
+{
+    return true;
+}
+
+static void start_transmission(int sender, const uint8_t* data, size_t len)
+{
+    transmission_t* t = &sim.active[sim.active_cnt++];
+    memcpy(t->data, data, len);
+    t->len = len;
+    t->start = sim.now;
+    t->end = sim.now + (uint32_t)(len * FRAME_BITS);
+    t->sender = sender;
+    t->collided = false;
+    // Every transmission on the bus at the same time is lost
+    if (sim.active_cnt > 1) {
+        for (size_t i = 0; i < sim.active_cnt; i++) {
+            sim.active[i].collided = true;
+        }
+    }
+    if (sender < 0) {
+        sim.requests++;
+        // The transaction of this request is already pending
+        if (adi_hbs_TxnPending(&sim.txn) > 1) {
+            sim.interleaved++;
+        }
+    } else {
+        sim.responses++;
+    }
+}
+
+static void deliver(adi_hbs_t* hbs, const transmission_t* t)
+{
+    if (t->collided) {
+        adi_hbs_ReceivedError(hbs);
+    } else {
+        adi_hbs_ReceivedN(hbs, t->data, t->len, NULL);
+    }
+    adi_hbs_EndOfBurst(hbs);
+    adi_hbs_Process(hbs);
+}
+
+static void end_transmission(size_t index)
+{
+    transmission_t t = sim.active[index];
+    sim.active[index] = sim.active[--sim.active_cnt];
+    sim.busy_ticks += t.end - t.start;
+    if (t.collided) {
+        sim.collisions++;
+    }
+    if (sim.verbose) {
+        printf("%10u %10u  %s 0x%02x -> 0x%02x  seq %3u%s\n", t.start, t.end, t.sender < 0 ? "request " : "response",
+               t.data[0], t.data[1], t.len > HBS_HEADER_SIZE ? t.data[HBS_HEADER_SIZE] : 0, t.collided ? "  collided" : "");
+    }
+    // The master and every slave receive it, the stack filters the addresses
+    if (t.sender >= 0) {
+        deliver(&sim.master, &t);
+    }
+    for (long i = 0; i < sim.slave_cnt; i++) {
+        if (i != t.sender) {
+            deliver(&sim.slaves[i].hbs, &t);
+        }
+    }
+}
+
+// Ends the transmissions due at the current tick, then lets the slaves with a response ready take an idle bus
+static void step_bus(void)
+{
+    for (size_t i = 0; i < sim.active_cnt;) {
+        if (sim.active[i].end == sim.now) {
+            end_transmission(i);
+        } else {
+            i++;
+        }
+    }
+    for (long i = 0; i < sim.slave_cnt && sim.active_cnt == 0; i++) {
+        slave_t* slave = &sim.slaves[i];
+        if (slave->tx_len != 0 && (int32_t)(sim.now - slave->ready_at) >= 0) {
+            start_transmission((int)i, slave->tx, slave->tx_len);
+            slave->tx_len = 0;
+        }
+    }
+}
+
+static void copy_segments(uint8_t* dst, size_t* len, const adi_hbs_Segment_t* segments, size_t count)
+{
+    *len = 0;
+    for (size_t i = 0; i < count; i++) {
+        memcpy(&dst[*len], segments[i].data, segments[i].len);
+        *len += segments[i].len;
+    }
+}
+
+// Blocks until the request is sent, as the IO layers do
+static hbs_err_e master_tx(const adi_hbs_Segment_t* segments, size_t count, void* ctx)
+{
+    uint8_t data[MAX_PACKET] = { 0 };
+    size_t len;
+    copy_segments(data, &len, segments, count);
+    start_transmission(-1, data, len);
+    uint32_t end = sim.now + (uint32_t)(len * FRAME_BITS);
+    while (sim.now != end) {
+        sim.now++;
+        step_bus();
+    }
+    return HBS_ERR_OK;
+}
+
+// The response is sent once the slave is done and the bus is idle
+static hbs_err_e slave_tx(const adi_hbs_Segment_t* segments, size_t count, void* ctx)
+{
+    slave_t* slave = ctx;
+    copy_segments(slave->tx, &slave->tx_len, segments, count);
+    slave->ready_at = sim.now + (uint32_t)sim.turnaround;
+    return HBS_ERR_OK;
+}
+
+static hbs_err_e slave_request(adi_hbs_t* hbs, adi_hbs_Packet_t* packet, void* ctx)
+{
+    slave_t* slave = ctx;
+    if (slave->dead || packet->len < 1) {
+        return HBS_ERR_OK;
+    }
+    uint8_t payload[HBS_MAX_DATA_LEN] = { packet->data[0] };
+    return adi_hbs_Send(hbs, packet->self_addr, RESPONSE_CODE, payload, 1 + (size_t)sim.len);
+}
+
+static void poll_cb(adi_hbs_Poll_t* poll, adi_hbs_PollEntry_t* entry, adi_hbs_Packet_t* response)
+{
+    if (response != NULL) {
+        sim.answered++;
+    }
+}
+
+static bool simulate(mode_e mode, const params_t* params, double* cycle)
+{
+    // Everything but the options is cleared between two runs
+    sim.now = 0;
+    sim.active_cnt = 0;
+    sim.busy_ticks = 0;
+    sim.requests = 0;
+    sim.responses = 0;
+    sim.collisions = 0;
+    sim.interleaved = 0;
+    sim.answered = 0;
+
+    long slave_cnt = params->slave_cnt;
+    sim.slaves = calloc((size_t)slave_cnt, sizeof *sim.slaves);
+    adi_hbs_PollEntry_t* entries = calloc((size_t)slave_cnt, sizeof *entries);
+    adi_hbs_TxnSlot_t* slots = calloc((size_t)params->slot_cnt, sizeof *slots);
+    if (sim.slaves == NULL || entries == NULL || slots == NULL) {
+        fprintf(stderr, "out of memory\n");
+        exit(1);
+    }
+    sim.slave_cnt = slave_cnt;
+    for (long i = 0; i < slave_cnt; i++) {
+        slave_t* slave = &sim.slaves[i];
+        adi_hbs_Init(&slave->hbs, (uint8_t)(FIRST_SLAVE_ADDR + i), slave_tx, slave);
+        adi_hbs_SetRxPool(&slave->hbs, slave->pool, sizeof slave->pool / sizeof *slave->pool);
+        adi_hbs_SetOpHandlers(&slave->hbs, slave->op_handlers, sizeof slave->op_handlers / sizeof *slave->op_handlers);
+        adi_hbs_RegisterOpHandler(&slave->hbs, REQUEST_CODE, slave_request, slave);
+        slave->dead = i < params->dead;
+    }
+
+    // Every slave is polled as often as possible, the achieved interval is the time to poll them all
+    static adi_hbs_Packet_t master_pool[4];
+    static adi_hbs_OpHandler_t master_handlers[RESPONSE_CODE + 1];
+    adi_hbs_Init(&sim.master, MASTER_ADDR, master_tx, NULL);
+    adi_hbs_SetRxPool(&sim.master, master_pool, sizeof master_pool / sizeof *master_pool);
+    adi_hbs_SetOpHandlers(&sim.master, master_handlers, sizeof master_handlers / sizeof *master_handlers);
+    adi_hbs_TxnInit(&sim.txn, &sim.master, slots, (size_t)params->slot_cnt);
+    for (long i = 0; i < slave_cnt; i++) {
+        entries[i] = (adi_hbs_PollEntry_t){
+            .addr = (uint8_t)(FIRST_SLAVE_ADDR + i),
+            .opcode = REQUEST_CODE,
+            .response_opcode = RESPONSE_CODE,
+            .use_seq = true,
+            .period = 1,
+            .timeout = (uint32_t)params->timeout,
+            .cb = poll_cb
+        };
+    }
+    adi_hbs_Poll_t poll;
+    adi_hbs_PollInit(&poll, &sim.txn, entries, (size_t)slave_cnt, sim.now);
+    if (mode == MODE_PIPELINED) {
+        adi_hbs_PollSetBusIdle(&poll, bus_idle, NULL);
+    } else if (mode == MODE_UNGATED) {
+        adi_hbs_PollSetBusIdle(&poll, bus_always_idle, NULL);
+    }
+
+    while (sim.now < (uint32_t)params->duration) {
+        adi_hbs_PollRun(&poll, sim.now);
+        sim.now++;
+        step_bus();
+    }
+
+    // Nodes that answer, the others are backed off and polled less often
+    unsigned long polls = 0;
+    unsigned long timeouts = 0;
+    double interval = 0.0;
+    for (long i = 0; i < slave_cnt; i++) {
+        polls += entries[i].stats.poll_cnt;
+        timeouts += entries[i].stats.timeout_cnt;
+        if (i >= params->dead) {
+            interval += entries[i].stats.interval_avg;
+        }
+    }
+    if (slave_cnt > params->dead) {
+        interval /= (double)(slave_cnt - params->dead);
+    }
+    static const char* const mode_names[] = { "serialized", "pipelined", "ungated" };
+    printf("mode:         %s, %ld slaves, turnaround %ld, %ld slots\n", mode_names[mode], slave_cnt, sim.turnaround, params->slot_cnt);
+    printf("polls:        %lu sent, %lu answered, %lu timed out\n", polls, sim.answered, timeouts);
+    printf("bus:          %lu requests, %lu responses, %lu collided, %.0f%% busy\n", sim.requests, sim.responses,
+           sim.collisions, 100.0 * (double)sim.busy_ticks / (double)params->duration);
+    printf("interleaved:  %lu requests sent while a response was outstanding\n", sim.interleaved);
+    printf("poll cycle:   %.0f bit-times to poll every slave that answers\n", interval);
+    *cycle = interval;
+
+    // Gated polling must not collide, and a node that answers must not time out
+    bool failed = mode != MODE_UNGATED && (sim.collisions != 0 || (params->dead == 0 && timeouts != 0));
+    free(sim.slaves);
+    free(entries);
+    free(slots);
+    return failed;
+}
+
+int main(int argc, char** argv)
+{
+    params_t params = {
+        .slave_cnt = DEFAULT_SLAVES,
+        .slot_cnt = DEFAULT_SLOTS,
+        .timeout = DEFAULT_TIMEOUT,
+        .dead = 0,
+        .duration = DEFAULT_DURATION
+    };
+    mode_e mode = MODE_SERIALIZED;
+    sim.turnaround = DEFAULT_TURNAROUND;
+    sim.len = DEFAULT_LEN;
+    int opt;
+    while ((opt = getopt(argc, argv, "m:n:t:l:s:w:x:d:v")) != -1) {
+        switch (opt) {
+        case 'm':
+            if (strcmp(optarg, "serialized") == 0) {
+                mode = MODE_SERIALIZED;
+            } else if (strcmp(optarg, "pipelined") == 0) {
+                mode = MODE_PIPELINED;
+            } else if (strcmp(optarg, "ungated") == 0) {
+                mode = MODE_UNGATED;
+            } else if (strcmp(optarg, "compare") == 0) {
+                mode = MODE_COMPARE;
+            } else {
+                usage(argv[0]);
+                return 1;
+            }
+            break;
+        case 'n':
+            params.slave_cnt = strtol(optarg, NULL, 0);
+            break;
+        case 't':
+            sim.turnaround = strtol(optarg, NULL, 0);
+            break;
+        case 'l':
+            sim.len = strtol(optarg, NULL, 0);
+            break;
+        case 's':
+            params.slot_cnt = strtol(optarg, NULL, 0);
+            break;
+        case 'w':
+            params.timeout = strtol(optarg, NULL, 0);
+            break;
+        case 'x':
+            params.dead = strtol(optarg, NULL, 0);
+            break;
+        case 'd':
+            params.duration = strtol(optarg, NULL, 0);
+            break;
+        case 'v':
+            sim.verbose = true;
+            break;
+        default:
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (params.slave_cnt <= 0 || params.slave_cnt > MAX_SLAVES || sim.turnaround < 0 || sim.len < 0
+        || sim.len >= HBS_MAX_DATA_LEN || params.slot_cnt <= 0 || params.timeout <= 0 || params.dead < 0
+        || params.dead > params.slave_cnt || params.duration <= 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    double cycle;
+    if (mode != MODE_COMPARE) {
+        return simulate(mode, &params, &cycle);
+    }
+
+    // The round trips of serialized polls against the bus time of pipelined ones
+    double serialized;
+    bool failed = simulate(MODE_SERIALIZED, &params, &serialized);
+    printf("\n");
+    failed |= simulate(MODE_PIPELINED, &params, &cycle);
+    printf("\npipelined:    %.0f%% of the serialized poll cycle\n", serialized > 0.0 ? 100.0 * cycle / serialized : 0.0);
+    // Pipelining can only save the turnaround, but must never be slower
+    return failed || cycle > serialized;
+}
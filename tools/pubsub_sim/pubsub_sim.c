@@ -0,0 +1,377 @@
+/*
+ * Copyright 2024 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file pubsub_sim.c
+ * Compares the bus traffic of periodic polling and of publish/subscribe for a set of mostly static values on the
+ * host, with the protocol stack on the master and on every node.
+ */
+
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "homebus_poll.h"
+#include "homebus_pubsub.h"
+
+#define DEFAULT_NODES (16)
+#define DEFAULT_POINTS (8)
+#define DEFAULT_CHANGES (2)
+#define DEFAULT_PERIOD (1000)
+#define DEFAULT_HEARTBEAT (60000)
+#define DEFAULT_MIN_INTERVAL (100)
+#define DEFAULT_DURATION (3600000)
+#define STEP (10)
+#define MAX_NODES (64)
+#define MAX_POINTS (HBS_PUBSUB_MAX_ENTRIES)
+#define MASTER_ADDR (0x01)
+#define FIRST_NODE_ADDR (0x10)
+#define UPDATE_ADDR (0xF0)
+#define REQUEST_CODE (0x10)
+#define RESPONSE_CODE (0x11)
+#define UPDATE_CODE (0x20)
+#define VALUE_SIZE (4)
+// Bit-times of a frame: start bit, 8 data bits, parity bit and stop bit
+#define FRAME_BITS (11)
+
+typedef struct {
+    adi_hbs_t hbs;
+    adi_hbs_Packet_t pool[2];
+    adi_hbs_OpHandler_t op_handlers[REQUEST_CODE + 1];
+    adi_hbs_Pub_t pub;
+    adi_hbs_PubPoint_t points[MAX_POINTS];
+    int32_t values[MAX_POINTS];
+} node_t;
+
+// What the master knows of a value
+typedef struct {
+    int32_t value;
+    uint32_t changed_at;  // Tick of the first change the master hasn't seen yet
+    bool pending;
+} track_t;
+
+static struct {
+    uint32_t now;
+    long node_cnt;
+    long point_cnt;
+    node_t* nodes;
+    adi_hbs_t master;
+    track_t* tracks;
+    unsigned long packets;
+    unsigned long bytes;
+    unsigned long latency_sum;
+    unsigned long latency_cnt;
+    uint32_t latency_max;
+    uint32_t xorshift;
+} sim;
+
+static void usage(const char* name)
+{
+    fprintf(stderr, "usage: %s [-n nodes] [-p points] [-c changes] [-T period] [-b heartbeat] [-i interval] [-d duration] [-s seed]\n", name);
+    fprintf(stderr, "  -n            nodes (default %d)\n", DEFAULT_NODES);
+    fprintf(stderr, "  -p            values per node (default %d)\n", DEFAULT_POINTS);
+    fprintf(stderr, "  -c            changes of each value per hour, on average (default %d)\n", DEFAULT_CHANGES);
+    fprintf(stderr, "  -T            polling period in ms (default %d)\n", DEFAULT_PERIOD);
+    fprintf(stderr, "  -b            heartbeat of the published values in ms, 0 to disable it (default %d)\n", DEFAULT_HEARTBEAT);
+    fprintf(stderr, "  -i            minimum interval between two updates of a value in ms (default %d)\n", DEFAULT_MIN_INTERVAL);
+    fprintf(stderr, "  -d            ms simulated (default %d)\n", DEFAULT_DURATION);
+    fprintf(stderr, "  -s            random seed of the changes (default 1)\n");
+}
+
+static uint32_t xorshift32(void)
+{
+    sim.xorshift ^= sim.xorshift << 13;
+    sim.xorshift ^= sim.xorshift >> 17;
+    sim.xorshift ^= sim.xorshift << 5;
+    return sim.xorshift;
+}
+
+// Every packet reaches every other node at once, only the traffic is counted
+static hbs_err_e wire_tx(const adi_hbs_Segment_t* segments, size_t count, void* ctx)
+{
+    adi_hbs_t* sender = ctx;
+    uint8_t data[HBS_HEADER_SIZE + HBS_MAX_DATA_LEN];
+    size_t len = 0;
+    for (size_t i = 0; i < count; i++) {
+        memcpy(&data[len], segments[i].data, segments[i].len);
+        len += segments[i].len;
+    }
+    sim.packets++;
+    sim.bytes += len;
+    if (sender != &sim.master) {
+        adi_hbs_ReceivedN(&sim.master, data, len, NULL);
+        adi_hbs_Process(&sim.master);
+    }
+    for (long i = 0; i < sim.node_cnt; i++) {
+        adi_hbs_t* hbs = &sim.nodes[i].hbs;
+        if (hbs != sender) {
+            adi_hbs_ReceivedN(hbs, data, len, NULL);
+            adi_hbs_Process(hbs);
+        }
+    }
+    return HBS_ERR_OK;
+}
+
+static void seen(long node, long point, int32_t value)
+{
+    track_t* track = &sim.tracks[node * sim.point_cnt + point];
+    track->value = value;
+    if (track->pending && value == sim.nodes[node].values[point]) {
+        uint32_t latency = sim.now - track->changed_at;
+        sim.latency_sum += latency;
+        sim.latency_cnt++;
+        if (latency > sim.latency_max) {
+            sim.latency_max = latency;
+        }
+        track->pending = false;
+    }
+}
+
+static hbs_err_e node_request(adi_hbs_t* hbs, adi_hbs_Packet_t* packet, void* ctx)
+{
+    node_t* node = ctx;
+    uint8_t payload[MAX_POINTS * VALUE_SIZE];
+    for (long i = 0; i < sim.point_cnt; i++) {
+        uint32_t value = (uint32_t)node->values[i];
+        payload[i * VALUE_SIZE] = value & 0xFF;
+        payload[i * VALUE_SIZE + 1] = (value >> 8) & 0xFF;
+        payload[i * VALUE_SIZE + 2] = (value >> 16) & 0xFF;
+        payload[i * VALUE_SIZE + 3] = (value >> 24) & 0xFF;
+    }
+    return adi_hbs_Send(hbs, packet->self_addr, RESPONSE_CODE, payload, (size_t)sim.point_cnt * VALUE_SIZE);
+}
+
+static void poll_cb(adi_hbs_Poll_t* poll, adi_hbs_PollEntry_t* entry, adi_hbs_Packet_t* response)
+{
+    if (response == NULL || response->len != sim.point_cnt * VALUE_SIZE) {
+        return;
+    }
+    long node = entry->addr - FIRST_NODE_ADDR;
+    for (long i = 0; i < sim.point_cnt; i++) {
+        const uint8_t* p = &response->data[i * VALUE_SIZE];
+        seen(node, i, (int32_t)(p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24)));
+    }
+}
+
+static void sub_cb(adi_hbs_Sub_t* sub, adi_hbs_SubPoint_t* point, void* ctx)
+{
+    seen(point->src - FIRST_NODE_ADDR, point->id, point->value);
+}
+
+// Runs the same changes with polling or with publish/subscribe, returns the number of values found stale
+static unsigned long simulate(bool pubsub, long changes, long period, long heartbeat, long min_interval, long duration, uint32_t seed)
+{
+    long node_cnt = sim.node_cnt;
+    long point_cnt = sim.point_cnt;
+    sim.now = 0;
+    sim.packets = 0;
+    sim.bytes = 0;
+    sim.latency_sum = 0;
+    sim.latency_cnt = 0;
+    sim.latency_max = 0;
+    sim.xorshift = seed;
+    memset(sim.nodes, 0, (size_t)node_cnt * sizeof *sim.nodes);
+    memset(sim.tracks, 0, (size_t)(node_cnt * point_cnt) * sizeof *sim.tracks);
+
+    static adi_hbs_Packet_t master_pool[4];
+    static adi_hbs_OpHandler_t master_handlers[UPDATE_CODE + 1];
+    adi_hbs_Init(&sim.master, MASTER_ADDR, wire_tx, &sim.master);
+    adi_hbs_SetRxPool(&sim.master, master_pool, sizeof master_pool / sizeof *master_pool);
+    adi_hbs_SetOpHandlers(&sim.master, master_handlers, sizeof master_handlers / sizeof *master_handlers);
+    for (long i = 0; i < node_cnt; i++) {
+        node_t* node = &sim.nodes[i];
+        adi_hbs_Init(&node->hbs, (uint8_t)(FIRST_NODE_ADDR + i), wire_tx, &node->hbs);
+        adi_hbs_SetRxPool(&node->hbs, node->pool, sizeof node->pool / sizeof *node->pool);
+        adi_hbs_SetOpHandlers(&node->hbs, node->op_handlers, sizeof node->op_handlers / sizeof *node->op_handlers);
+        adi_hbs_RegisterOpHandler(&node->hbs, REQUEST_CODE, node_request, node);
+        for (long j = 0; j < point_cnt; j++) {
+            node->points[j] = (adi_hbs_PubPoint_t){
+                .id = (uint8_t)j,
+                .deadband = 0,
+                .min_interval = (uint32_t)min_interval,
+                .max_interval = (uint32_t)heartbeat
+            };
+        }
+        adi_hbs_PubInit(&node->pub, &node->hbs, UPDATE_ADDR, UPDATE_CODE, node->points, (size_t)point_cnt);
+    }
+
+    // The master polls every node, one request and one response with all its values
+    adi_hbs_TxnSlot_t slot;
+    adi_hbs_Txn_t txn;
+    adi_hbs_Poll_t poll;
+    adi_hbs_PollEntry_t* entries = calloc((size_t)node_cnt, sizeof *entries);
+    // Or subscribes to every value, sent to a multicast address
+    adi_hbs_Sub_t sub;
+    adi_hbs_SubPoint_t* sub_points = calloc((size_t)(node_cnt * point_cnt), sizeof *sub_points);
+    if (entries == NULL || sub_points == NULL) {
+        fprintf(stderr, "out of memory\n");
+        exit(1);
+    }
+    if (pubsub) {
+        for (long i = 0; i < node_cnt * point_cnt; i++) {
+            sub_points[i] = (adi_hbs_SubPoint_t){
+                .src = (uint8_t)(FIRST_NODE_ADDR + i / point_cnt),
+                .id = (uint8_t)(i % point_cnt),
+                .max_age = heartbeat == 0 ? 0 : (uint32_t)(heartbeat + STEP)
+            };
+        }
+        adi_hbs_AcceptAddr(&sim.master, UPDATE_ADDR, true);
+        adi_hbs_SubInit(&sub, &sim.master, UPDATE_CODE, sub_points, (size_t)(node_cnt * point_cnt), sub_cb, NULL);
+    } else {
+        adi_hbs_TxnInit(&txn, &sim.master, &slot, 1);
+        for (long i = 0; i < node_cnt; i++) {
+            entries[i] = (adi_hbs_PollEntry_t){
+                .addr = (uint8_t)(FIRST_NODE_ADDR + i),
+                .opcode = REQUEST_CODE,
+                .response_opcode = RESPONSE_CODE,
+                .period = (uint32_t)period,
+                .timeout = (uint32_t)period,
+                .cb = poll_cb
+            };
+        }
+        adi_hbs_PollInit(&poll, &txn, entries, (size_t)node_cnt, sim.now);
+    }
+
+    // A change of a value at each step is a Bernoulli trial, with the probability giving the hourly rate
+    uint32_t threshold = (uint32_t)((double)changes * STEP / 3600000.0 * 4294967296.0);
+    unsigned long stale = 0;
+    for (sim.now = 0; sim.now < (uint32_t)duration; sim.now += STEP) {
+        for (long i = 0; i < node_cnt; i++) {
+            node_t* node = &sim.nodes[i];
+            for (long j = 0; j < point_cnt; j++) {
+                if (sim.now == 0 || xorshift32() >= threshold) {
+                    continue;
+                }
+                node->values[j]++;
+                adi_hbs_PubSet(&node->pub, (uint8_t)j, node->values[j]);
+                track_t* track = &sim.tracks[i * point_cnt + j];
+                if (!track->pending) {
+                    track->pending = true;
+                    track->changed_at = sim.now;
+                }
+            }
+        }
+        if (pubsub) {
+            adi_hbs_SubRun(&sub, sim.now);
+            for (long i = 0; i < node_cnt; i++) {
+                adi_hbs_PubRun(&sim.nodes[i].pub, sim.now);
+            }
+            for (long i = 0; i < node_cnt * point_cnt; i++) {
+                stale += adi_hbs_SubIsStale(&sub, &sub_points[i], sim.now);
+            }
+        } else {
+            adi_hbs_PollRun(&poll, sim.now);
+        }
+    }
+
+    unsigned long update_pkt_cnt = 0;
+    for (long i = 0; i < node_cnt; i++) {
+        update_pkt_cnt += sim.nodes[i].pub.update_pkt_cnt;
+    }
+    double hours = (double)duration / 3600000.0;
+    printf("%-9s     %lu packets, %lu bytes, %.2f%% of the bus at 9600 bit/s", pubsub ? "pubsub:" : "polling:", sim.packets,
+           sim.bytes, 100.0 * (double)sim.bytes * FRAME_BITS / ((double)duration / 1000.0 * 9600.0));
+    if (pubsub) {
+        printf(", update_pkt_cnt %lu", update_pkt_cnt);
+    }
+    printf("\n");
+    printf("              %lu changes seen per hour, latency %.0f ms on average, %u ms at most\n",
+           (unsigned long)((double)sim.latency_cnt / hours), sim.latency_cnt == 0 ? 0.0 : (double)sim.latency_sum / (double)sim.latency_cnt,
+           sim.latency_max);
+
+    free(entries);
+    free(sub_points);
+    return stale;
+}
+
+int main(int argc, char** argv)
+{
+    long node_cnt = DEFAULT_NODES;
+    long point_cnt = DEFAULT_POINTS;
+    long changes = DEFAULT_CHANGES;
+    long period = DEFAULT_PERIOD;
+    long heartbeat = DEFAULT_HEARTBEAT;
+    long min_interval = DEFAULT_MIN_INTERVAL;
+    long duration = DEFAULT_DURATION;
+    long seed = 1;
+    int opt;
+    while ((opt = getopt(argc, argv, "n:p:c:T:b:i:d:s:")) != -1) {
+        switch (opt) {
+        case 'n':
+            node_cnt = strtol(optarg, NULL, 0);
+            break;
+        case 'p':
+            point_cnt = strtol(optarg, NULL, 0);
+            break;
+        case 'c':
+            changes = strtol(optarg, NULL, 0);
+            break;
+        case 'T':
+            period = strtol(optarg, NULL, 0);
+            break;
+        case 'b':
+            heartbeat = strtol(optarg, NULL, 0);
+            break;
+        case 'i':
+            min_interval = strtol(optarg, NULL, 0);
+            break;
+        case 'd':
+            duration = strtol(optarg, NULL, 0);
+            break;
+        case 's':
+            seed = strtol(optarg, NULL, 0);
+            break;
+        default:
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (node_cnt <= 0 || node_cnt > MAX_NODES || point_cnt <= 0 || point_cnt * VALUE_SIZE > HBS_MAX_DATA_LEN
+        || point_cnt > MAX_POINTS || changes < 0 || (double)changes * STEP >= 3600000.0 || period < STEP
+        || heartbeat < 0 || min_interval < 0 || duration <= 0 || seed == 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    sim.node_cnt = node_cnt;
+    sim.point_cnt = point_cnt;
+    sim.nodes = malloc((size_t)node_cnt * sizeof *sim.nodes);
+    sim.tracks = malloc((size_t)(node_cnt * point_cnt) * sizeof *sim.tracks);
+    if (sim.nodes == NULL || sim.tracks == NULL) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    printf("values:       %ld nodes of %ld values, %ld changes per value and per hour, %.1f hours\n", node_cnt, point_cnt,
+           changes, (double)duration / 3600000.0);
+    simulate(false, changes, period, heartbeat, min_interval, duration, (uint32_t)seed);
+    unsigned long polling_bytes = sim.bytes;
+    uint32_t polling_latency = sim.latency_max;
+    unsigned long stale = simulate(true, changes, period, heartbeat, min_interval, duration, (uint32_t)seed);
+    unsigned long pubsub_bytes = sim.bytes;
+    printf("traffic:      publish/subscribe sends %.1f times fewer bytes than polling\n",
+           pubsub_bytes == 0 ? 0.0 : (double)polling_bytes / (double)pubsub_bytes);
+    printf("stale:        %lu value checks found a published value stale\n", stale);
+
+    // Each change must reach the master within a period, or within the minimum interval, and no value may go stale
+    bool late = polling_latency > (uint32_t)(period + STEP) || sim.latency_max > (uint32_t)(min_interval + STEP);
+    free(sim.nodes);
+    free(sim.tracks);
+    return late || stale != 0;
+}
@@ -0,0 +1,254 @@
+/*
+ * Copyright 2024 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file resync_bench.c
+ * Measures how many packets the protocol stack loses after a byte is lost or damaged, with and without end of burst
+ * notifications.
+ */
+
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "homebus.h"
+
+#define DEFAULT_PACKETS (100000)
+#define DEFAULT_MAX_LEN (32)
+#define DEFAULT_BURST (1)
+#define DEFAULT_LOSS_PPM (1000)
+#define DEFAULT_SEED (1)
+#define NODE_ADDR (0x01)
+#define SEQ_LEN (4)
+#define HISTOGRAM_BINS (8)
+
+typedef enum {
+    MODE_COUNTING, // Packet boundaries are only found by counting bytes
+    MODE_END_OF_BURST, // adi_hbs_EndOfBurst is called after each burst
+    MODE_DELIMITED, // and adi_hbs_SetBurstDelimited is enabled
+    MODE_COUNT
+} mode_e;
+
+static const char* const mode_names[MODE_COUNT] = { "counting", "end of burst", "delimited" };
+
+typedef struct {
+    long packets;
+    long max_len;
+    unsigned long next_intact;  // Packets before this one were already received or lost
+    unsigned long intact;
+    unsigned long garbage;
+    bool pending;  // A loss hasn't been recovered from yet
+    unsigned long pending_since;  // Packet in which the loss happened
+    unsigned long events;
+    unsigned long recovery_sum;
+    unsigned long recovery_max;
+    unsigned long histogram[HISTOGRAM_BINS];
+} check_t;
+
+static check_t check;
+
+static void usage(const char* name)
+{
+    fprintf(stderr, "usage: %s [-n packets] [-l len] [-b packets] [-p ppm] [-d] [-s seed]\n", name);
+    fprintf(stderr, "  -n            packets sent (default %d)\n", DEFAULT_PACKETS);
+    fprintf(stderr, "  -l            longest payload, lengths are random from %d up to it (default %d)\n", SEQ_LEN, DEFAULT_MAX_LEN);
+    fprintf(stderr, "  -b            packets per burst (default %d)\n", DEFAULT_BURST);
+    fprintf(stderr, "  -p            bytes lost per million (default %d)\n", DEFAULT_LOSS_PPM);
+    fprintf(stderr, "  -d            bytes are damaged and reported with adi_hbs_ReceivedError instead of lost silently\n");
+    fprintf(stderr, "  -s            random seed (default %d)\n", DEFAULT_SEED);
+}
+
+static uint32_t next_random(uint32_t* state)
+{
+    // xorshift32
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+// Builds packet `seq`, the same every time, so received packets can be checked without storing the stream
+static void make_packet(unsigned long seq, long max_len, adi_hbs_Packet_t* packet)
+{
+    uint32_t state = (uint32_t)seq * 2654435761u + 1u;
+    next_random(&state);
+    packet->self_addr = (uint8_t)next_random(&state);
+    packet->dest_addr = (uint8_t)next_random(&state);
+    packet->operation = (uint8_t)next_random(&state);
+    packet->len = (uint8_t)(SEQ_LEN + next_random(&state) % (uint32_t)(max_len - SEQ_LEN + 1));
+    for (int i = 0; i < SEQ_LEN; i++) {
+        packet->data[i] = (uint8_t)(seq >> (8 * i));
+    }
+    for (int i = SEQ_LEN; i < packet->len; i++) {
+        packet->data[i] = (uint8_t)next_random(&state);
+    }
+}
+
+static void recovered(unsigned long seq)
+{
+    // Packets lost after the one in which the loss happened, up to `seq` which is received intact or has a loss of its own.
+    // A packet whose last byte is lost can still be received intact, when the next byte has the same value.
+    unsigned long recovery = seq > check.pending_since ? seq - check.pending_since - 1 : 0;
+    check.events++;
+    check.recovery_sum += recovery;
+    if (recovery > check.recovery_max) {
+        check.recovery_max = recovery;
+    }
+    unsigned int bin = 0;
+    while (bin < HISTOGRAM_BINS - 1 && recovery >= (1ul << bin)) {
+        bin++;
+    }
+    check.histogram[bin]++;
+    check.pending = false;
+}
+
+static hbs_err_e check_packet(adi_hbs_t* hbs, adi_hbs_Packet_t* packet)
+{
+    adi_hbs_Packet_t expected;
+    unsigned long seq = 0;
+    if (packet->len >= SEQ_LEN) {
+        for (int i = 0; i < SEQ_LEN; i++) {
+            seq |= (unsigned long)packet->data[i] << (8 * i);
+        }
+    }
+    if (packet->len < SEQ_LEN || seq < check.next_intact || seq >= (unsigned long)check.packets) {
+        check.garbage++;
+        return HBS_ERR_OK;
+    }
+    make_packet(seq, check.max_len, &expected);
+    if (memcmp(packet, &expected, HBS_HEADER_SIZE + expected.len) != 0) {
+        check.garbage++;
+        return HBS_ERR_OK;
+    }
+    if (check.pending) {
+        recovered(seq);
+    }
+    check.intact++;
+    check.next_intact = seq + 1;
+    return HBS_ERR_OK;
+}
+
+static void run(mode_e mode, long packets, long max_len, long burst, long loss_ppm, bool damaged, uint32_t seed)
+{
+    memset(&check, 0, sizeof check);
+    check.packets = packets;
+    check.max_len = max_len;
+
+    adi_hbs_t hbs;
+    adi_hbs_Init(&hbs, NODE_ADDR, NULL, NULL);
+    adi_hbs_RegisterRxCb(&hbs, check_packet);
+    adi_hbs_SetBurstDelimited(&hbs, mode == MODE_DELIMITED);
+    for (unsigned int addr = 0; addr < 256; addr++) {
+        adi_hbs_AcceptAddr(&hbs, (uint8_t)addr, true);
+    }
+
+    // Same losses in every mode
+    uint32_t loss_state = seed;
+    for (long seq = 0; seq < packets; seq++) {
+        adi_hbs_Packet_t packet;
+        make_packet((unsigned long)seq, max_len, &packet);
+        const uint8_t* bytes = (const uint8_t*)&packet;
+        for (size_t i = 0; i < HBS_HEADER_SIZE + (size_t)packet.len; i++) {
+            if (next_random(&loss_state) % 1000000u < (uint32_t)loss_ppm) {
+                if (!check.pending || check.pending_since != (unsigned long)seq) {
+                    // Packets lost since the previous loss are counted against it
+                    if (check.pending) {
+                        recovered((unsigned long)seq);
+                    }
+                    check.pending = true;
+                    check.pending_since = (unsigned long)seq;
+                }
+                if (damaged) {
+                    adi_hbs_ReceivedError(&hbs);
+                }
+                continue;
+            }
+            adi_hbs_Received(&hbs, bytes[i]);
+        }
+        if (mode != MODE_COUNTING && (seq + 1) % burst == 0) {
+            adi_hbs_EndOfBurst(&hbs);
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    long packets = DEFAULT_PACKETS;
+    long max_len = DEFAULT_MAX_LEN;
+    long burst = DEFAULT_BURST;
+    long loss_ppm = DEFAULT_LOSS_PPM;
+    bool damaged = false;
+    long seed = DEFAULT_SEED;
+    int opt;
+    while ((opt = getopt(argc, argv, "n:l:b:p:ds:")) != -1) {
+        switch (opt) {
+        case 'n':
+            packets = strtol(optarg, NULL, 0);
+            break;
+        case 'l':
+            max_len = strtol(optarg, NULL, 0);
+            break;
+        case 'b':
+            burst = strtol(optarg, NULL, 0);
+            break;
+        case 'p':
+            loss_ppm = strtol(optarg, NULL, 0);
+            break;
+        case 'd':
+            damaged = true;
+            break;
+        case 's':
+            seed = strtol(optarg, NULL, 0);
+            break;
+        default:
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (packets <= 0 || max_len < SEQ_LEN || max_len > HBS_MAX_DATA_LEN || burst <= 0 || loss_ppm < 0
+        || loss_ppm > 1000000 || seed == 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    printf("%ld packets, %ld per burst, %ld bytes %s per million\n", packets, burst, loss_ppm,
+        damaged ? "damaged" : "lost");
+    printf("%-13s %8s %8s %8s %8s %10s %6s  %s\n", "mode", "intact", "lost", "garbage", "losses", "recovery", "max",
+        "recovery histogram: 0, 1, 2-3, 4-7, ...");
+    bool bounded = true;
+    for (mode_e mode = MODE_COUNTING; mode < MODE_COUNT; mode++) {
+        run(mode, packets, max_len, burst, loss_ppm, damaged, (uint32_t)seed);
+        double mean = check.events == 0 ? 0.0 : (double)check.recovery_sum / (double)check.events;
+        printf("%-13s %8lu %8lu %8lu %8lu %10.2f %6lu ", mode_names[mode], check.intact,
+            (unsigned long)packets - check.intact, check.garbage, check.events, mean, check.recovery_max);
+        for (int bin = 0; bin < HISTOGRAM_BINS; bin++) {
+            printf(" %lu", check.histogram[bin]);
+        }
+        printf("%s\n", check.pending ? "  (last loss not recovered)" : "");
+        // With the end of bursts reported, a loss can't spread past the end of its burst
+        if (mode != MODE_COUNTING && check.recovery_max > (unsigned long)burst - 1) {
+            bounded = false;
+        }
+    }
+    printf("\nrecovery: packets lost after a packet in which a byte was lost, until one is received intact or has a loss of its own\n");
+
+    return !bounded;
+}
@@ -0,0 +1,346 @@
+/*
+ * Copyright 2024 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file rx_bench.c
+ * Compares the bulk receive path of the driver and the protocol stack with the per-byte path on the host.
+ */
+
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "max22x88.h"
+#include "io_layer_interface.h"
+#include "homebus.h"
+#include "homebus_max22x88.h"
+
+#define DEFAULT_PACKETS (1000000)
+#define DEFAULT_MAX_LEN (32)
+#define DEFAULT_CHUNK (32)
+#define DEFAULT_RX_LEN (256)
+#define DEFAULT_ROUNDS (5)
+#define NODE_ADDR (0x01)
+
+#define FNV_OFFSET_BASIS (2166136261u)
+#define FNV_PRIME (16777619u)
+
+typedef enum {
+    PATH_STACK_BYTE,
+    PATH_STACK_BULK,
+    PATH_DRIVER_BYTE,
+    PATH_DRIVER_BULK,
+    PATH_COUNT
+} path_e;
+
+static const char* const path_names[PATH_COUNT] = {
+    "stack byte:  adi_hbs_Received",
+    "stack bulk:  adi_hbs_ReceivedN",
+    "driver byte: adi_max22x88_Read + adi_hbs_Received",
+    "driver bulk: adi_hbs_ReceiveMax22x88",
+};
+
+typedef struct {
+    adi_max22x88_t* driver;
+    const uint8_t* stream;
+    size_t len;
+    unsigned long full_cnt;
+} producer_t;
+
+static unsigned long packets_received;
+static uint32_t digest;
+
+static void usage(const char* name)
+{
+    fprintf(stderr, "usage: %s [-m mode] [-n packets] [-l len] [-c chunk] [-r frames] [-k rounds] [-t]\n", name);
+    fprintf(stderr, "  -m            driver rx buffer mode: frames (default) or bytes\n");
+    fprintf(stderr, "  -n            packets per round (default %d)\n", DEFAULT_PACKETS);
+    fprintf(stderr, "  -l            longest payload, lengths are random up to it (default %d)\n", DEFAULT_MAX_LEN);
+    fprintf(stderr, "  -c            bytes passed to adi_hbs_ReceivedN at once by the stack bulk path (default %d)\n", DEFAULT_CHUNK);
+    fprintf(stderr, "  -r            frames in the driver's rx buffer (default %d)\n", DEFAULT_RX_LEN);
+    fprintf(stderr, "  -k            rounds measured, the fastest one is reported (default %d)\n", DEFAULT_ROUNDS);
+    fprintf(stderr, "  -t            also fill the rx buffer from a second thread while adi_hbs_ReceiveMax22x88 drains it\n");
+}
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+// The frames are pushed by the benchmark, nothing is received or transmitted on a bus
+static adi_max22x88_Result_e bench_init(adi_max22x88_t* driver, void* state, void* params)
+{
+    return MAX22X88_ERR_OK;
+}
+
+static adi_max22x88_Result_e bench_set_rst(adi_max22x88_t* driver, bool state)
+{
+    return MAX22X88_ERR_OK;
+}
+
+static adi_max22x88_Result_e bench_write(adi_max22x88_t* driver, uint8_t* data, size_t count)
+{
+    return MAX22X88_ERR_OK;
+}
+
+static const adi_max22x88_Functions_t bench_functions = {
+    .init_fn = bench_init,
+    .ctx_size = 0,
+    .set_rst_state_fn = bench_set_rst,
+    .write_fn = bench_write,
+    .writev_fn = NULL
+};
+
+static void hash(const uint8_t* data, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        digest = (digest ^ data[i]) * FNV_PRIME;
+    }
+}
+
+static hbs_err_e check_packet(adi_hbs_t* hbs, adi_hbs_Packet_t* packet)
+{
+    packets_received++;
+    hash(&packet->self_addr, HBS_HEADER_SIZE);
+    hash(packet->data, packet->len);
+    return HBS_ERR_OK;
+}
+
+// Used for the rounds measured, so the time is spent in the receive path rather than in the check
+static hbs_err_e count_packet(adi_hbs_t* hbs, adi_hbs_Packet_t* packet)
+{
+    packets_received++;
+    return HBS_ERR_OK;
+}
+
+// The loop of the example before the bulk path: a driver read and a call to the parser per byte
+static void drain_per_byte(adi_hbs_t* hbs, adi_max22x88_t* driver)
+{
+    while (adi_max22x88_IsAvailable(driver)) {
+        uint8_t data;
+        if (adi_max22x88_Read(driver, &data) == MAX22X88_ERR_OK) {
+            adi_hbs_Received(hbs, data);
+        } else {
+            adi_hbs_ReceivedError(hbs);
+        }
+    }
+}
+
+static double run_stack(path_e path, adi_hbs_t* hbs, const uint8_t* stream, size_t len, size_t chunk)
+{
+    double start = now_s();
+    if (path == PATH_STACK_BYTE) {
+        for (size_t i = 0; i < len; i++) {
+            adi_hbs_Received(hbs, stream[i]);
+        }
+    } else {
+        for (size_t offset = 0; offset < len; offset += chunk) {
+            adi_hbs_ReceivedN(hbs, &stream[offset], len - offset < chunk ? len - offset : chunk, NULL);
+        }
+    }
+    return now_s() - start;
+}
+
+static double run_driver(path_e path, adi_hbs_t* hbs, adi_max22x88_t* driver, const uint8_t* stream, size_t len,
+    size_t rx_len)
+{
+    // Only the draining of the rx buffer is timed, filling it stands for the IO layer
+    double elapsed = 0.0;
+    for (size_t offset = 0; offset < len; offset += rx_len) {
+        size_t n = len - offset < rx_len ? len - offset : rx_len;
+        for (size_t i = 0; i < n; i++) {
+            adi_max22x88_DataReceived(driver, stream[offset + i]);
+        }
+        double start = now_s();
+        if (path == PATH_DRIVER_BYTE) {
+            drain_per_byte(hbs, driver);
+        } else {
+            adi_hbs_ReceiveMax22x88(hbs, driver);
+        }
+        elapsed += now_s() - start;
+    }
+    return elapsed;
+}
+
+static void* produce(void* arg)
+{
+    producer_t* producer = arg;
+    for (size_t i = 0; i < producer->len; i++) {
+        while (adi_max22x88_DataReceived(producer->driver, producer->stream[i]) == MAX22X88_ERR_RX_BUFFER_FULL) {
+            producer->full_cnt++;
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+int main(int argc, char** argv)
+{
+    adi_max22x88_RxMode_e rx_mode = MAX22X88_RX_MODE_FRAMES;
+    long packets = DEFAULT_PACKETS;
+    long max_len = DEFAULT_MAX_LEN;
+    long chunk = DEFAULT_CHUNK;
+    long rx_len = DEFAULT_RX_LEN;
+    long rounds = DEFAULT_ROUNDS;
+    bool threaded = false;
+    int opt;
+    while ((opt = getopt(argc, argv, "m:n:l:c:r:k:t")) != -1) {
+        switch (opt) {
+        case 'm':
+            if (strcmp(optarg, "frames") == 0) {
+                rx_mode = MAX22X88_RX_MODE_FRAMES;
+            } else if (strcmp(optarg, "bytes") == 0) {
+                rx_mode = MAX22X88_RX_MODE_BYTES;
+            } else {
+                usage(argv[0]);
+                return 1;
+            }
+            break;
+        case 'n':
+            packets = strtol(optarg, NULL, 0);
+            break;
+        case 'l':
+            max_len = strtol(optarg, NULL, 0);
+            break;
+        case 'c':
+            chunk = strtol(optarg, NULL, 0);
+            break;
+        case 'r':
+            rx_len = strtol(optarg, NULL, 0);
+            break;
+        case 'k':
+            rounds = strtol(optarg, NULL, 0);
+            break;
+        case 't':
+            threaded = true;
+            break;
+        default:
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (packets <= 0 || max_len < 0 || max_len > HBS_MAX_DATA_LEN || chunk <= 0 || rx_len <= 0 || rounds <= 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    // Packets to the node, so every payload is stored
+    uint8_t* stream = malloc((size_t)packets * (HBS_HEADER_SIZE + (size_t)max_len));
+    if (stream == NULL) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    size_t len = 0;
+    srand(1);
+    for (long i = 0; i < packets; i++) {
+        uint8_t payload_len = (uint8_t)(rand() % (max_len + 1));
+        stream[len++] = (uint8_t)rand();
+        stream[len++] = NODE_ADDR;
+        stream[len++] = (uint8_t)rand();
+        stream[len++] = payload_len;
+        for (uint8_t j = 0; j < payload_len; j++) {
+            stream[len++] = (uint8_t)rand();
+        }
+    }
+
+    adi_max22x88_t driver;
+    if (adi_max22x88_InitRxMode(&driver, (size_t)rx_len, rx_mode, bench_functions, NULL) != MAX22X88_ERR_OK) {
+        fprintf(stderr, "driver initialization failed\n");
+        return 1;
+    }
+    adi_hbs_t hbs;
+    adi_hbs_Init(&hbs, NODE_ADDR, NULL, NULL);
+
+    double mbytes = (double)len / 1e6;
+    printf("stream:      %ld packets, %.1f Mbyte, %s rx buffer of %ld\n", packets, mbytes,
+        rx_mode == MAX22X88_RX_MODE_FRAMES ? "frames" : "bytes", rx_len);
+    bool ok = true;
+    uint32_t reference = 0;
+    for (path_e path = PATH_STACK_BYTE; path < PATH_COUNT; path++) {
+        double best = 0.0;
+        // Round 0 checks the packets received and isn't measured
+        for (long round = 0; round <= rounds; round++) {
+            packets_received = 0;
+            digest = FNV_OFFSET_BASIS;
+            hbs.dropped_pkt_cnt = 0;
+            adi_hbs_RegisterRxCb(&hbs, round == 0 ? check_packet : count_packet);
+            double elapsed;
+            if (path == PATH_STACK_BYTE || path == PATH_STACK_BULK) {
+                elapsed = run_stack(path, &hbs, stream, len, (size_t)chunk);
+            } else {
+                elapsed = run_driver(path, &hbs, &driver, stream, len, (size_t)rx_len);
+            }
+            if (round == 0) {
+                if (path == PATH_STACK_BYTE) {
+                    reference = digest;
+                } else if (digest != reference) {
+                    ok = false;
+                }
+            } else if (round == 1 || elapsed < best) {
+                best = elapsed;
+            }
+            if (packets_received != (unsigned long)packets || hbs.dropped_pkt_cnt != 0) {
+                ok = false;
+            }
+        }
+        printf("%-50s %8.1f Mbyte/s %6.2f Mpackets/s\n", path_names[path], mbytes / best, (double)packets / best / 1e6);
+    }
+
+    if (threaded) {
+        // The rx buffer is filled while it is drained, as by the IO layer's interrupt or Rx thread
+        packets_received = 0;
+        digest = FNV_OFFSET_BASIS;
+        hbs.dropped_pkt_cnt = 0;
+        adi_hbs_RegisterRxCb(&hbs, check_packet);
+        producer_t producer = {
+            .driver = &driver,
+            .stream = stream,
+            .len = len
+        };
+        pthread_t thread;
+        double start = now_s();
+        pthread_create(&thread, NULL, produce, &producer);
+        while (packets_received < (unsigned long)packets && hbs.dropped_pkt_cnt == 0) {
+            if (!adi_max22x88_IsAvailable(&driver)) {
+                // Let the producer run on a single CPU
+                sched_yield();
+            }
+            adi_hbs_ReceiveMax22x88(&hbs, &driver);
+        }
+        pthread_join(thread, NULL);
+        double elapsed = now_s() - start;
+        printf("%-50s %8.1f Mbyte/s, %lu packets, %u dropped, rx buffer full %lu times\n",
+            "concurrent:  adi_hbs_ReceiveMax22x88", mbytes / elapsed, packets_received, hbs.dropped_pkt_cnt,
+            producer.full_cnt);
+        if (packets_received != (unsigned long)packets || digest != reference || hbs.dropped_pkt_cnt != 0) {
+            ok = false;
+        }
+    }
+
+    if (!ok) {
+        printf("mismatch: a path lost, dropped or changed packets\n");
+    }
+    free(stream);
+    return !ok;
+}
@@ -0,0 +1,158 @@
+/*
+ * Copyright 2024 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file spi_bench.c
+ * Measures the encoder and decoder throughput of the SPI IO layer with the host SPI HAL.
+ */
+
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "max22x88_spi.h"
+#include "host_hal.h"
+
+#define DEFAULT_COUNT (1000000)
+#define DEFAULT_OVERSAMPLING (8)
+#define DEFAULT_BAUD (9600)
+
+static void usage(const char* name)
+{
+    fprintf(stderr, "usage: %s [-n count] [-o oversampling] [-e flips] [-b baud]\n", name);
+    fprintf(stderr, "  -n            bytes to encode and decode (default %d)\n", DEFAULT_COUNT);
+    fprintf(stderr, "  -o            SPI bits per half-bit, %d to %d (default %d)\n",
+        MAX22X88_SPI_OVERSAMPLING_MIN, MAX22X88_SPI_OVERSAMPLING_MAX, DEFAULT_OVERSAMPLING);
+    fprintf(stderr, "  -e            samples flipped per million before decoding (default 0)\n");
+    fprintf(stderr, "  -b            Home Bus baud rate (default %d)\n", DEFAULT_BAUD);
+}
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char** argv)
+{
+    long count = DEFAULT_COUNT;
+    long oversampling = DEFAULT_OVERSAMPLING;
+    long flips = 0;
+    long baud = DEFAULT_BAUD;
+    int opt;
+    while ((opt = getopt(argc, argv, "n:o:e:b:")) != -1) {
+        switch (opt) {
+        case 'n':
+            count = strtol(optarg, NULL, 0);
+            break;
+        case 'o':
+            oversampling = strtol(optarg, NULL, 0);
+            break;
+        case 'e':
+            flips = strtol(optarg, NULL, 0);
+            break;
+        case 'b':
+            baud = strtol(optarg, NULL, 0);
+            break;
+        default:
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (count <= 0 || oversampling < MAX22X88_SPI_OVERSAMPLING_MIN || oversampling > MAX22X88_SPI_OVERSAMPLING_MAX ||
+        flips < 0 || flips > 1000000 || baud <= 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    size_t stream_len = ((size_t)count * 22 * (size_t)oversampling + 7) / 8;
+    uint8_t* data = malloc((size_t)count);
+    uint8_t* stream = malloc(stream_len);
+    if (data == NULL || stream == NULL) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    srand(1);
+    for (long i = 0; i < count; i++) {
+        data[i] = (uint8_t)rand();
+    }
+
+    adi_max22x88_t driver;
+    adi_max22x88_spi_InitParams_t params = {
+        .hbs_baud = (uint32_t)baud,
+        .oversampling = (uint8_t)oversampling,
+        .rx_mode = MAX22X88_RX_MODE_FRAMES,
+        .idle_gap_bits = 0
+    };
+    if (adi_max22x88_InitSpi(&driver, &params, (size_t)count) != MAX22X88_ERR_OK) {
+        fprintf(stderr, "cannot initialize the driver\n");
+        return 1;
+    }
+
+    adi_max22x88_hal_HostSpiSetTxBuffer(stream, stream_len);
+    double start = now_s();
+    adi_max22x88_Transmit(&driver, data, (size_t)count);
+    double encode_s = now_s() - start;
+    if (adi_max22x88_hal_HostSpiTxCount() != stream_len) {
+        fprintf(stderr, "encoded %zu bytes, expected %zu\n", adi_max22x88_hal_HostSpiTxCount(), stream_len);
+        return 1;
+    }
+
+    long flipped = 0;
+    if (flips > 0) {
+        for (size_t bit = 0; bit < stream_len * 8; bit++) {
+            if (rand() % 1000000 < flips) {
+                stream[bit / 8] ^= (uint8_t)(0x80 >> (bit % 8));
+                flipped++;
+            }
+        }
+    }
+
+    start = now_s();
+    adi_max22x88_hal_HostSpiFeedRx(stream, stream_len);
+    double decode_s = now_s() - start;
+
+    long frames = 0;
+    long bad_frames = 0;
+    long mismatches = 0;
+    adi_max22x88_Frame_t frame;
+    while (adi_max22x88_ReadFrame(&driver, &frame) == MAX22X88_ERR_OK) {
+        if (frame.status != MAX22X88_FRAME_OK) {
+            bad_frames++;
+        } else if (frames >= count || frame.data != data[frames]) {
+            mismatches++;
+        }
+        frames++;
+    }
+
+    double samples = (double)stream_len * 8;
+    printf("oversampling:  %ld SPI bits per half-bit, %u bits/s\n", oversampling, adi_max22x88_hal_HostSpiBitRate());
+    printf("encode:        %.1f Mbyte/s, %.1f Msample/s\n", count / encode_s / 1e6, samples / encode_s / 1e6);
+    printf("decode:        %.1f Mbyte/s, %.1f Msample/s, %lu blocks\n", count / decode_s / 1e6, samples / decode_s / 1e6,
+        adi_max22x88_hal_HostSpiRxBlockCount());
+    printf("frames:        %ld of %ld decoded, %ld with errors, %ld wrong, %ld samples flipped\n",
+        frames, count, bad_frames, mismatches, flipped);
+
+    adi_max22x88_Deinit(&driver);
+    free(data);
+    free(stream);
+    return frames != count || mismatches != 0 || (flips == 0 && bad_frames != 0);
+}
@@ -0,0 +1,183 @@
+/*
+ * Copyright 2024 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file trace2vcd.c
+ * Converts a dump of the bitbang trace ring into a VCD waveform.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "max22x88_bitbang.h"
+
+#define DEFAULT_TIMESTAMP_HZ (100000000UL)
+
+/** VCD identifiers of the signals. */
+#define VCD_ID_DIN "d"
+#define VCD_ID_DOUT "o"
+#define VCD_ID_START "s"
+#define VCD_ID_COLLISION "c"
+#define VCD_ID_OVF "v"
+#define VCD_ID_DATA "b"
+#define VCD_ID_ERRORS "e"
+
+/** Signals that are raised for the duration of a single event. */
+typedef struct {
+    const char* id;
+    bool high;
+} pulse_t;
+
+static void usage(const char* name)
+{
+    fprintf(stderr, "usage: %s [-f timestamp_hz] input.bin output.vcd\n", name);
+    fprintf(stderr, "  input.bin     records copied with adi_max22x88_DumpTraceBitbang, oldest first\n");
+    fprintf(stderr, "  -f            frequency of adi_max22x88_hal_TimestampGet (default %lu)\n", DEFAULT_TIMESTAMP_HZ);
+}
+
+static void write_header(FILE* out)
+{
+    fprintf(out, "$comment MAX22x88 bitbang trace $end\n");
+    fprintf(out, "$timescale 1 ns $end\n");
+    fprintf(out, "$scope module homebus $end\n");
+    fprintf(out, "$var wire 1 " VCD_ID_DIN " din $end\n");
+    fprintf(out, "$var wire 1 " VCD_ID_DOUT " dout $end\n");
+    fprintf(out, "$var wire 1 " VCD_ID_START " start_edge $end\n");
+    fprintf(out, "$var wire 1 " VCD_ID_COLLISION " collision $end\n");
+    fprintf(out, "$var wire 1 " VCD_ID_OVF " rx_ovf $end\n");
+    fprintf(out, "$var reg 8 " VCD_ID_DATA " rx_data $end\n");
+    fprintf(out, "$var reg 4 " VCD_ID_ERRORS " rx_errors $end\n");
+    fprintf(out, "$upscope $end\n");
+    fprintf(out, "$enddefinitions $end\n");
+    fprintf(out, "#0\n$dumpvars\n1" VCD_ID_DIN "\n1" VCD_ID_DOUT "\n0" VCD_ID_START "\n0" VCD_ID_COLLISION "\n0" VCD_ID_OVF "\n");
+    fprintf(out, "bxxxxxxxx " VCD_ID_DATA "\nb0000 " VCD_ID_ERRORS "\n$end\n");
+}
+
+static void write_vector(FILE* out, unsigned value, int width, const char* id)
+{
+    fputc('b', out);
+    for (int i = width - 1; i >= 0; i--) {
+        fputc((value & (1u << i)) ? '1' : '0', out);
+    }
+    fprintf(out, " %s\n", id);
+}
+
+static void write_record(FILE* out, const adi_max22x88_bitbang_TraceRecord_t* record, pulse_t* pulses)
+{
+    switch (record->event) {
+        case BITBANG_TRACE_START_EDGE:
+            fprintf(out, "0" VCD_ID_DOUT "\n1" VCD_ID_START "\n");
+            pulses[0].high = true;
+            break;
+        case BITBANG_TRACE_DOUT_SAMPLE:
+            fprintf(out, "%d" VCD_ID_DOUT "\n", record->value ? 1 : 0);
+            break;
+        case BITBANG_TRACE_DIN_WRITE:
+            fprintf(out, "%d" VCD_ID_DIN "\n", record->value ? 1 : 0);
+            break;
+        case BITBANG_TRACE_COLLATION_MISMATCH:
+            fprintf(out, "1" VCD_ID_COLLISION "\n");
+            pulses[1].high = true;
+            break;
+        case BITBANG_TRACE_FRAME_RESULT:
+            write_vector(out, record->value, 8, VCD_ID_DATA);
+            write_vector(out, record->index, 4, VCD_ID_ERRORS);
+            break;
+        case BITBANG_TRACE_RX_OVF:
+            fprintf(out, "1" VCD_ID_OVF "\n");
+            pulses[2].high = true;
+            break;
+        default:
+            fprintf(stderr, "warning: unknown event %u\n", record->event);
+            break;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    unsigned long hz = DEFAULT_TIMESTAMP_HZ;
+    int arg = 1;
+    if (argc > 2 && strcmp(argv[1], "-f") == 0) {
+        hz = strtoul(argv[2], NULL, 0);
+        arg = 3;
+    }
+    if (argc - arg != 2 || hz == 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    FILE* in = fopen(argv[arg], "rb");
+    if (in == NULL) {
+        perror(argv[arg]);
+        return 1;
+    }
+    FILE* out = fopen(argv[arg + 1], "w");
+    if (out == NULL) {
+        perror(argv[arg + 1]);
+        fclose(in);
+        return 1;
+    }
+
+    write_header(out);
+
+    pulse_t pulses[] = {
+        { VCD_ID_START, false },
+        { VCD_ID_COLLISION, false },
+        { VCD_ID_OVF, false },
+    };
+    const size_t n_pulses = sizeof pulses / sizeof *pulses;
+
+    adi_max22x88_bitbang_TraceRecord_t record;
+    uint32_t last_ts = 0;
+    uint64_t elapsed_ticks = 0;
+    uint64_t last_ns = 0;
+    size_t count = 0;
+    while (fread(&record, sizeof record, 1, in) == 1) {
+        if (count == 0) {
+            last_ts = record.timestamp;
+        }
+        // Unsigned subtraction unwraps the 32-bit counter, as long as consecutive events are less than one wrap apart
+        elapsed_ticks += (uint32_t)(record.timestamp - last_ts);
+        last_ts = record.timestamp;
+        uint64_t ns = elapsed_ticks * 1000000000ULL / hz;
+        if (ns > last_ns || count == 0) {
+            fprintf(out, "#%" PRIu64 "\n", ns);
+            // Pulses raised by the previous event end here
+            for (size_t i = 0; i < n_pulses; i++) {
+                if (pulses[i].high) {
+                    fprintf(out, "0%s\n", pulses[i].id);
+                    pulses[i].high = false;
+                }
+            }
+            last_ns = ns;
+        }
+        write_record(out, &record, pulses);
+        count++;
+    }
+    fprintf(out, "#%" PRIu64 "\n", last_ns + 1);
+    for (size_t i = 0; i < n_pulses; i++) {
+        if (pulses[i].high) {
+            fprintf(out, "0%s\n", pulses[i].id);
+        }
+    }
+
+    fclose(in);
+    fclose(out);
+    fprintf(stderr, "%zu records converted\n", count);
+    return 0;
+}
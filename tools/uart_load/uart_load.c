@@ -0,0 +1,229 @@
+/*
+ * Copyright 2024 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file uart_load.c
+ * Compares the interrupts and CPU time the UART and bitbang IO layers take per received byte, on the host HAL.
+ */
+
+#define _DEFAULT_SOURCE
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "max22x88.h"
+#include "max22x88_uart.h"
+#include "max22x88_bitbang.h"
+#include "private/bitbang_helper.h"
+#include "host_hal.h"
+
+#define DEFAULT_BYTES (5000)
+#define DEFAULT_CHUNK (1)
+#define DEFAULT_BAUD (9600)
+#define DEFAULT_SEED (1)
+#define HALF_BITS_IN_FRAME (22)  // Start, 8 data, parity and stop bits, two half-bits each
+#define BITS_IN_FRAME (11)
+#define RX_BUFFER_LEN (4096)
+#define POLL_US (100)
+
+typedef struct {
+    const char* name;
+    unsigned long interrupts;
+    double cpu_s;
+    size_t received;
+    size_t wrong;
+} result_t;
+
+static void usage(const char* name)
+{
+    fprintf(stderr, "usage: %s [-n bytes] [-c chunk] [-b baud] [-s seed]\n", name);
+    fprintf(stderr, "  -n            bytes received by each IO layer (default %d)\n", DEFAULT_BYTES);
+    fprintf(stderr, "  -c            bytes written to the UART at once, 1 waits for each byte to be read (default %d)\n", DEFAULT_CHUNK);
+    fprintf(stderr, "  -b            Home Bus baud rate (default %d)\n", DEFAULT_BAUD);
+    fprintf(stderr, "  -s            seed of the random bytes (default %d)\n", DEFAULT_SEED);
+}
+
+static double cpu_s(clockid_t clock)
+{
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+// Reads what the driver has received, and compares it with the bytes sent
+static void drain(adi_max22x88_t* driver, const uint8_t* data, result_t* result)
+{
+    uint8_t buf[256];
+    size_t read = 0;
+    do {
+        adi_max22x88_ReadN(driver, buf, sizeof buf, &read);
+        for (size_t i = 0; i < read; i++) {
+            if (buf[i] != data[result->received + i]) {
+                result->wrong++;
+            }
+        }
+        result->received += read;
+    } while (read != 0);
+}
+
+// The Rx interrupt runs in the UART HAL's thread. Its CPU time is the process time less the main thread's.
+static int run_uart(const uint8_t* data, size_t bytes, size_t chunk, uint32_t baud, result_t* result)
+{
+    adi_max22x88_t driver;
+    adi_max22x88_uart_InitParams_t params = {
+        .hbs_baud = baud,
+        .rx_mode = MAX22X88_RX_MODE_BYTES,
+    };
+    int peer;
+    if (adi_max22x88_hal_HostUartOpenPty(&peer) != 0 || adi_max22x88_InitUart(&driver, &params, RX_BUFFER_LEN) != MAX22X88_ERR_OK) {
+        fprintf(stderr, "uart init failed\n");
+        return -1;
+    }
+
+    unsigned long ints = adi_max22x88_hal_HostUartRxIntCount();
+    double process = cpu_s(CLOCK_PROCESS_CPUTIME_ID);
+    double thread = cpu_s(CLOCK_THREAD_CPUTIME_ID);
+    for (size_t sent = 0; sent < bytes; ) {
+        size_t len = bytes - sent < chunk ? bytes - sent : chunk;
+        if (write(peer, &data[sent], len) != (ssize_t)len) {
+            break;
+        }
+        sent += len;
+        // Wait for the chunk, sleeping so the main thread takes as little CPU time as possible
+        for (int idle = 0; result->received < sent && idle < 10000; idle++) {
+            usleep(POLL_US);
+            drain(&driver, data, result);
+        }
+    }
+    result->cpu_s = (cpu_s(CLOCK_PROCESS_CPUTIME_ID) - process) - (cpu_s(CLOCK_THREAD_CPUTIME_ID) - thread);
+    result->interrupts = adi_max22x88_hal_HostUartRxIntCount() - ints;
+
+    adi_max22x88_Deinit(&driver);
+    close(peer);
+    return 0;
+}
+
+static void dout_falling_edge(void)
+{
+    adi_max22x88_FallingEdgeIntCallback();
+}
+
+// Another node transmits the frames on the emulated bus, the interrupts run in the calling thread
+static int run_bitbang(const uint8_t* data, size_t bytes, uint32_t baud, result_t* result)
+{
+    adi_max22x88_t driver;
+    adi_max22x88_bitbang_InitParams_t params = {
+        .hbs_baud = baud,
+        .rx_mode = MAX22X88_RX_MODE_BYTES,
+    };
+    if (adi_max22x88_InitBitbang(&driver, &params, RX_BUFFER_LEN) != MAX22X88_ERR_OK) {
+        fprintf(stderr, "bitbang init failed\n");
+        return -1;
+    }
+    adi_max22x88_hal_HostGpioSetDoutCallback(dout_falling_edge);
+
+    uint32_t half_bit_ticks = HOST_BITBANG_CLOCK_HZ / (baud * 2);
+    unsigned long ints = adi_max22x88_hal_HostTimerIntCount() + adi_max22x88_hal_HostGpioIntCount();
+    double start = cpu_s(CLOCK_THREAD_CPUTIME_ID);
+    for (size_t i = 0; i < bytes; i++) {
+        uint32_t frame = _format_frame_u32(data[i]);
+        for (int bit = 0; bit < HALF_BITS_IN_FRAME; bit++) {
+            adi_max22x88_hal_HostGpioSetBus((frame >> bit) & 1);
+            adi_max22x88_hal_HostTimerAdvance(half_bit_ticks);
+        }
+        if (i % 64 == 63) {
+            drain(&driver, data, result);
+        }
+    }
+    adi_max22x88_hal_HostGpioSetBus(1);
+    adi_max22x88_hal_HostTimerAdvance(HALF_BITS_IN_FRAME * half_bit_ticks);
+    drain(&driver, data, result);
+    result->cpu_s = cpu_s(CLOCK_THREAD_CPUTIME_ID) - start;
+    result->interrupts = adi_max22x88_hal_HostTimerIntCount() + adi_max22x88_hal_HostGpioIntCount() - ints;
+
+    adi_max22x88_Deinit(&driver);
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    size_t bytes = DEFAULT_BYTES;
+    size_t chunk = DEFAULT_CHUNK;
+    uint32_t baud = DEFAULT_BAUD;
+    unsigned seed = DEFAULT_SEED;
+    int opt;
+    while ((opt = getopt(argc, argv, "n:c:b:s:")) != -1) {
+        switch (opt) {
+            case 'n':
+                bytes = strtoul(optarg, NULL, 0);
+                break;
+            case 'c':
+                chunk = strtoul(optarg, NULL, 0);
+                break;
+            case 'b':
+                baud = strtoul(optarg, NULL, 0);
+                break;
+            case 's':
+                seed = strtoul(optarg, NULL, 0);
+                break;
+            default:
+                usage(argv[0]);
+                return 2;
+        }
+    }
+    if (bytes == 0 || chunk == 0 || chunk > RX_BUFFER_LEN / 2 || baud == 0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    uint8_t* data = malloc(bytes);
+    if (data == NULL) {
+        return 1;
+    }
+    srand(seed);
+    for (size_t i = 0; i < bytes; i++) {
+        data[i] = (uint8_t)rand();
+    }
+
+    result_t results[2] = {
+        { .name = "uart" },
+        { .name = "bitbang" },
+    };
+    if (run_uart(data, bytes, chunk, baud, &results[0]) != 0 || run_bitbang(data, bytes, baud, &results[1]) != 0) {
+        free(data);
+        return 1;
+    }
+
+    int failed = 0;
+    double bytes_per_s = (double)baud / BITS_IN_FRAME;
+    printf("%-8s %10s %10s %12s %14s %14s\n", "layer", "received", "interrupts", "ints/byte", "ints/s at line", "CPU ns/byte");
+    for (int i = 0; i < 2; i++) {
+        result_t* r = &results[i];
+        double per_byte = (double)r->interrupts / bytes;
+        printf("%-8s %10zu %10lu %12.2f %14.0f %14.0f\n",
+            r->name, r->received, r->interrupts, per_byte, per_byte * bytes_per_s, r->cpu_s * 1e9 / bytes);
+        if (r->received != bytes || r->wrong != 0) {
+            fprintf(stderr, "%s: %zu bytes received, %zu wrong\n", r->name, r->received, r->wrong);
+            failed = 1;
+        }
+    }
+    free(data);
+    return failed;
+}